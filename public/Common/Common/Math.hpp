@@ -1,17 +1,20 @@
 #pragma once
 
-#include <forward_list>
 #include <utility>
+#include <vector>
 
 #include <glm/gtc/quaternion.hpp>
 #include <glm/vec3.hpp>
 
 class VertexBuffered;
+struct MeshInstance;
 
-glm::vec3 ComputeCenter(const std::forward_list<VertexBuffered>* pModel);
-float ComputeScale(const std::forward_list<VertexBuffered>* pModel, const glm::vec3 maxSize);
+// When instances are given, the bounds cover every placed instance rather than the meshes as stored.
+glm::vec3 ComputeCenter(const std::vector<VertexBuffered>* pModel, const std::vector<MeshInstance>* pInstances = nullptr);
+float ComputeScale(const std::vector<VertexBuffered>* pModel, const glm::vec3 maxSize, const std::vector<MeshInstance>* pInstances = nullptr);
 
-std::pair<glm::vec3, glm::vec3> ComputeAABB(const std::forward_list<VertexBuffered>* pModel);
+std::pair<glm::vec3, glm::vec3> ComputeAABB(const VertexBuffered& buffer);
+std::pair<glm::vec3, glm::vec3> ComputeAABB(const std::vector<VertexBuffered>* pModel, const std::vector<MeshInstance>* pInstances = nullptr);
 
 glm::vec3 RotateVector(const glm::vec3 vec, float pitchRad);
 glm::vec3 RotateVector(const glm::vec3 vec, float pitchRad, float yawRad, bool localQuat);
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Common/ClassMacros.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+
+class ThreadPool {
+public:
+    // A worker count of zero uses one worker per hardware thread.
+    explicit ThreadPool(std::size_t workerCount = 0);
+
+    COPY_MOVE_DISABLED(ThreadPool)
+
+    // Workers a pool created with a count of zero gets.
+    static std::size_t DefaultWorkerCount();
+
+    template<typename Function>
+    std::future<std::invoke_result_t<Function>> submit(Function&& function) {
+
+        using Result = std::invoke_result_t<Function>;
+
+        auto pTask = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+        std::future<Result> future = pTask->get_future();
+
+        enqueue([pTask]() { (*pTask)(); });
+        return future;
+    }
+
+    // Invokes function(index) for every index in [0, count) and blocks until all of them ran.
+    // The calling thread takes part in the work, so this is safe to use with a busy pool.
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& function);
+
+    DECLARE_GETTER_IMMUTABLE_COPY(workerCount, std::size_t)
+
+private:
+    void enqueue(std::function<void()> task);
+
+    COMPILATION_FIREWALL(ThreadPool)
+};
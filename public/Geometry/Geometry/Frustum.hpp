@@ -0,0 +1,21 @@
+#pragma once
+
+#include <array>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+// The six planes of a view volume, facing inwards.
+class Frustum {
+public:
+    Frustum() = default;
+
+    // Planes of a view projection matrix. Multiplied by a model matrix, the planes are in that model's space.
+    explicit Frustum(const glm::mat4& matrix);
+
+    bool intersects(const glm::vec3& center, float radius) const;
+
+private:
+    std::array<glm::vec4, 6> m_planes{};
+};
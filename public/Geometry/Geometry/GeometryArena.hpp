@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Common/ClassMacros.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include <glad/glad.h>
+
+// Vertex and index buffers shared by every mesh of one vertex format. Meshes get a range of each and are drawn through
+// the arena's vertex array with base vertex draws, instead of owning buffer objects of their own.
+class GeometryArena {
+    struct Private;
+
+public:
+    // Points the vertex array's attributes at the vertex buffer. Invoked with both bound whenever the vertex buffer is
+    // replaced.
+    using AttributeSetup = std::function<void()>;
+
+    // A mesh's share of the arena, handed back when the last reference goes. Ranges move when the arena grows or
+    // compacts, so read the offsets when drawing rather than keeping them.
+    class Allocation {
+    public:
+        ~Allocation();
+
+        COPY_MOVE_DISABLED(Allocation)
+
+        DECLARE_GETTER_IMMUTABLE_COPY(baseVertex, std::size_t)
+        DECLARE_GETTER_IMMUTABLE_COPY(vertexCount, std::size_t)
+        DECLARE_GETTER_IMMUTABLE_COPY(indexOffset, std::size_t) // In bytes.
+        DECLARE_GETTER_IMMUTABLE_COPY(indexSize, std::size_t) // In bytes.
+
+        DECLARE_GETTER_IMMUTABLE_COPY(stride, std::size_t)
+        DECLARE_GETTER_IMMUTABLE_COPY(vertexArrayId, GLuint)
+        DECLARE_GETTER_IMMUTABLE_COPY(vertexBufferId, GLuint)
+        DECLARE_GETTER_IMMUTABLE_COPY(indexBufferId, GLuint)
+
+    private:
+        friend class GeometryArena;
+        friend struct GeometryArena::Private;
+
+        struct Range {
+            std::size_t offset = 0;
+            std::size_t size = 0;
+        };
+
+        Allocation() = default;
+
+        std::shared_ptr<Private> m_pArena; // Keeps the buffers alive for as long as anything draws from them.
+        Range m_vertices; // In vertices.
+        Range m_indices; // In index words.
+    };
+
+    GeometryArena(std::size_t stride, AttributeSetup attributeSetup);
+    ~GeometryArena();
+
+    COPY_MOVE_DISABLED(GeometryArena)
+
+    // Reserves room for the vertices and index bytes. When the free space is too fragmented the live ranges are packed
+    // together first, and the buffers only grow when that still isn't enough.
+    std::shared_ptr<Allocation> allocate(std::size_t vertexCount, std::size_t indexSize);
+
+    DECLARE_GETTER_IMMUTABLE_COPY(stride, std::size_t)
+    DECLARE_GETTER_IMMUTABLE_COPY(vertexArrayId, GLuint)
+
+    // Sizes in bytes.
+    DECLARE_GETTER_IMMUTABLE_COPY(capacity, std::size_t)
+    DECLARE_GETTER_IMMUTABLE_COPY(used, std::size_t)
+
+private:
+    std::shared_ptr<Private> m_pPrivate;
+};
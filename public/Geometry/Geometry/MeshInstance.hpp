@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/mat4x4.hpp>
+
+// A placement of shared geometry in a model. The mesh is converted and uploaded once, and drawn once per instance.
+struct MeshInstance {
+    std::uint32_t meshIndex = 0; // Index into the model's meshes.
+    glm::mat4 transform{ 1.f }; // Model space transform of the referencing node.
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+class VertexBuffer;
+
+// Reorders indexed triangle lists for the GPU without changing how they look. Triangles are ordered for the
+// post-transform vertex cache and then to cut overdraw, vertices are numbered for fetch locality.
+struct MeshOptimizer {
+    // Size of the FIFO cache the orderings are tuned for and the statistics simulate.
+    static constexpr std::size_t kCacheSize = 16;
+
+    struct Statistics {
+        std::size_t triangleCount = 0;
+        std::size_t vertexCount = 0; // Referenced vertices.
+        std::size_t transformCount = 0; // Cache misses.
+
+        // Average cache miss ratio, transforms per triangle. 3 is the worst, large regular meshes approach 0.5.
+        float acmr() const;
+
+        // Average transform to vertex ratio, transforms per referenced vertex. 1 is ideal.
+        float atvr() const;
+
+        Statistics& operator+=(const Statistics& other);
+    };
+
+    struct Report {
+        Statistics before;
+        Statistics after;
+
+        Report& operator+=(const Report& other);
+    };
+
+    static Statistics Analyze(std::span<const std::uint32_t> indices, std::size_t vertexCount, std::size_t cacheSize = kCacheSize);
+
+    // Runs every pass over the buffer's triangle list. Buffers that aren't valid triangle lists are left as they are.
+    // The overdraw pass may raise the ACMR of the cache order by up to the threshold.
+    static Report Optimize(VertexBuffer& buffer, float overdrawThreshold = 1.05f);
+
+    // Tipsify, fans triangles around vertices that will still be cached.
+    static void OptimizeVertexCache(std::span<std::uint32_t> indices, std::size_t vertexCount, std::size_t cacheSize = kCacheSize);
+
+    // Splits the cache order into clusters and draws the ones facing out of the mesh first, so they occlude the rest.
+    static void OptimizeOverdraw(std::span<std::uint32_t> indices, std::span<const glm::vec3> vertices, float threshold, std::size_t cacheSize = kCacheSize);
+
+    // Numbers vertices in the order the triangles first use them and moves every attribute to match.
+    static void OptimizeVertexFetch(VertexBuffer& buffer);
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+class Frustum;
+class VertexBuffer;
+
+// A run of triangles in a mesh's index buffer, small enough to be culled on its own.
+struct Meshlet {
+    static constexpr std::size_t kMaxVertices = 64;
+    static constexpr std::size_t kMaxTriangles = 124;
+
+    struct IndexRange {
+        std::uint32_t first = 0;
+        std::uint32_t count = 0;
+    };
+
+    // Splits the triangle list into meshlets in index order, so optimize the mesh first to keep meshlets compact.
+    static std::vector<Meshlet> Build(const VertexBuffer& buffer, std::size_t maxVertices = kMaxVertices, std::size_t maxTriangles = kMaxTriangles);
+
+    // Index ranges of the meshlets that may be visible, with neighbouring ranges merged. Without a viewer position,
+    // meshlets facing away aren't culled. The frustum and viewer are in the same space as the meshlets.
+    static void Cull(std::span<const Meshlet> meshlets, const Frustum& frustum, const std::optional<glm::vec3>& viewer, std::vector<IndexRange>& visible);
+
+    // Every triangle faces away from a viewer at the given position.
+    bool backfacing(const glm::vec3& viewer) const;
+
+    IndexRange indices;
+
+    // Bounding sphere.
+    glm::vec3 center{ 0.f };
+    float radius = 0.f;
+
+    // Normal cone. The cutoff is the sine of its half angle, 1 when the triangles face too many ways to ever cull.
+    glm::vec3 coneApex{ 0.f };
+    glm::vec3 coneAxis{ 0.f, 0.f, 1.f };
+    float coneCutoff = 1.f;
+};
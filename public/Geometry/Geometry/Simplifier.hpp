@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+// Quadric error metric simplification of indexed triangle lists.
+struct Simplifier {
+    struct Result {
+        std::vector<std::uint32_t> indices;
+        float error = 0.f; // Largest distance a collapse moved the surface, in model units.
+    };
+
+    // Collapses edges, cheapest first, until at most the target number of indices remain or the next collapse would
+    // move the surface further than the target error. Vertices only collapse onto neighbours, so the result indexes
+    // the same vertices. Open borders are kept in place. Vertices split along attribute seams move together, the
+    // normals, when given, pick which vertex at the target takes over one that shares no edge with it.
+    static Result Simplify(std::span<const std::uint32_t> indices, std::span<const glm::vec3> vertices, std::size_t targetIndexCount, float targetError, std::span<const glm::vec3> normals = {});
+};
@@ -2,6 +2,10 @@
 
 #include "Common/ClassMacros.hpp"
 
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <span>
 #include <vector>
 
 #include <glm/vec2.hpp>
@@ -12,17 +16,30 @@ class VertexBuffer {
 public:
     VertexBuffer();
 
+    // Keeps the arrays in the given memory, which stays alive for as long as the buffer does. Without memory the arrays
+    // come from the heap. Copies always go to the heap, moves keep the memory they had.
+    explicit VertexBuffer(std::shared_ptr<std::pmr::memory_resource> pMemory);
+
     void addColor(const glm::vec4& color);
     void addIndex(uint32_t index);
     void addNormal(const glm::vec3& normal);
     void addTexel(const glm::vec2& texel);
     void addVertex(const glm::vec3& vertex);
 
-    DECLARE_GETTER_CONST_CORRECT(colors, std::vector<glm::vec4>)
-    DECLARE_GETTER_CONST_CORRECT(indices, std::vector<uint32_t>)
-    DECLARE_GETTER_CONST_CORRECT(normals, std::vector<glm::vec3>)
-    DECLARE_GETTER_CONST_CORRECT(texels, std::vector<glm::vec2>)
-    DECLARE_GETTER_CONST_CORRECT(vertices, std::vector<glm::vec3>)
+    void addColors(std::span<const glm::vec4> colors);
+    void addIndices(std::span<const uint32_t> indices);
+    void addNormals(std::span<const glm::vec3> normals);
+    void addTexels(std::span<const glm::vec2> texels);
+    void addVertices(std::span<const glm::vec3> vertices);
+
+    // Reserves every per-vertex attribute that is requested, plus the index array.
+    void reserve(std::size_t vertexCount, std::size_t indexCount, bool normals, bool texels, bool colors);
+
+    DECLARE_GETTER_CONST_CORRECT(colors, std::pmr::vector<glm::vec4>)
+    DECLARE_GETTER_CONST_CORRECT(indices, std::pmr::vector<uint32_t>)
+    DECLARE_GETTER_CONST_CORRECT(normals, std::pmr::vector<glm::vec3>)
+    DECLARE_GETTER_CONST_CORRECT(texels, std::pmr::vector<glm::vec2>)
+    DECLARE_GETTER_CONST_CORRECT(vertices, std::pmr::vector<glm::vec3>)
     
 private:
     COMPILATION_FIREWALL_COPY_MOVE(VertexBuffer)
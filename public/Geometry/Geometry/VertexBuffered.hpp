@@ -2,10 +2,14 @@
 
 #include "Common/ClassMacros.hpp"
 
+#include "Geometry/GeometryArena.hpp"
+#include "Geometry/Meshlet.hpp"
 #include "Geometry/VertexBuffer.hpp"
+#include "Geometry/VertexFormat.hpp"
 
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -18,6 +22,7 @@ class VertexBuffered {
 public:
     VertexBuffered();
     VertexBuffered(const VertexBuffer& buffer);
+    VertexBuffered(VertexBuffer&& buffer);
 
     enum class PrimativeType {
         Point = GL_POINTS,
@@ -33,11 +38,29 @@ public:
         Color, Index, Normal, Position, Texel
     };
 
-    DECLARE_GETTER_IMMUTABLE_COPY(colors, std::optional<std::vector<glm::vec4>>)
-    DECLARE_GETTER_IMMUTABLE_COPY(indices, std::optional<std::vector<uint32_t>>)
-    DECLARE_GETTER_IMMUTABLE_COPY(normals, std::optional<std::vector<glm::vec3>>)
-    DECLARE_GETTER_IMMUTABLE_COPY(texels, std::optional<std::vector<glm::vec2>>)
-    DECLARE_GETTER_IMMUTABLE_COPY(vertices, std::optional<std::vector<glm::vec3>>)
+    // How the attributes are laid out on the GPU. Interleaved geometry keeps every attribute of a vertex together in
+    // the vertex buffer, planar geometry gets a buffer per attribute.
+    enum class Layout : std::uint8_t {
+        Planar, Interleaved
+    };
+
+    // Non-owning views over the attribute data. Empty attributes are reported as std::nullopt.
+    DECLARE_GETTER_IMMUTABLE_COPY(colors, std::optional<std::span<const glm::vec4>>)
+    DECLARE_GETTER_IMMUTABLE_COPY(indices, std::optional<std::span<const uint32_t>>)
+    DECLARE_GETTER_IMMUTABLE_COPY(normals, std::optional<std::span<const glm::vec3>>)
+    DECLARE_GETTER_IMMUTABLE_COPY(texels, std::optional<std::span<const glm::vec2>>)
+    DECLARE_GETTER_IMMUTABLE_COPY(vertices, std::optional<std::span<const glm::vec3>>)
+
+    // Edit the buffer before the geometry is initialized.
+    DECLARE_GETTER_CONST_CORRECT(buffer, VertexBuffer)
+
+    // Counts and attribute presence outlast a released buffer.
+    DECLARE_GETTER_IMMUTABLE_COPY(indexCount, std::size_t)
+    DECLARE_GETTER_IMMUTABLE_COPY(vertexCount, std::size_t)
+
+    DECLARE_GETTER_IMMUTABLE_COPY(hasColors, bool)
+    DECLARE_GETTER_IMMUTABLE_COPY(hasNormals, bool)
+    DECLARE_GETTER_IMMUTABLE_COPY(hasTexels, bool)
 
     DECLARE_GETTER_IMMUTABLE_COPY(id, GLuint)
     DECLARE_GETTER_IMMUTABLE_COPY(colorBufferId, GLuint)
@@ -51,9 +74,56 @@ public:
     DECLARE_GETTER_IMMUTABLE_COPY(primativeType, PrimativeType)
     DECLARE_SETTER_COPY(primativeType, PrimativeType)
 
+    // Set before the geometry is initialized. Changing it afterwards takes another initialize and upload.
+    DECLARE_GETTER_IMMUTABLE_COPY(layout, Layout)
+    DECLARE_SETTER_COPY(layout, Layout)
+
+    // Set before the geometry is initialized. Only interleaved geometry is compacted, planar geometry stays float.
+    DECLARE_GETTER_IMMUTABLE_COPY(encoding, VertexEncoding)
+    DECLARE_SETTER_COPY(encoding, VertexEncoding)
+
+    // Bounds of the positions, captured when the geometry is initialized or released. Compact positions are quantized to
+    // them.
+    DECLARE_GETTER_IMMUTABLE(bounds, VertexBounds)
+
+    // Maps the uploaded positions into model space. Identity unless the geometry is compact.
+    glm::mat4 positionTransform() const;
+
+    // GL_UNSIGNED_SHORT for compact geometry that fits, GL_UNSIGNED_INT otherwise.
+    GLenum indexType() const;
+
+    // Clusters of the triangle list that are culled on their own when drawn. Without any, the whole mesh is drawn.
+    // Build them again after reordering the indices.
+    void buildMeshlets();
+    DECLARE_GETTER_IMMUTABLE(meshlets, std::vector<Meshlet>)
+
+    struct Lod {
+        std::vector<std::uint32_t> indices;
+        float error = 0.f; // Furthest the level strays from the full mesh, in model units.
+    };
+
+    // Simplified triangle lists over the same vertices, finest first, drawn in place of the full index list. Each level
+    // has about half the triangles of the one before it and is ordered for the vertex cache.
+    void buildLods();
+    DECLARE_GETTER_CONST_CORRECT(lods, std::vector<Lod>)
+
+    // Triangle list length of a level, also once its indices were released.
+    std::size_t lodIndexCount(std::size_t lod) const;
+
+    // Drops the CPU copy of the vertices and indices, level of detail indices included, once they were uploaded. Counts,
+    // bounds, meshlets and the GPU side stay, so the geometry still draws, but it can't be uploaded again.
+    void releaseBuffer();
+    DECLARE_GETTER_IMMUTABLE_COPY(released, bool)
+
     void initialize();
+
+    // Draws from a range of a shared arena instead of creating buffer objects of its own.
+    void initialize(std::shared_ptr<GeometryArena::Allocation> pAllocation);
     DECLARE_GETTER_IMMUTABLE_COPY(initialized, bool)
 
+    // The arena range the geometry draws from, if it was initialized with one.
+    DECLARE_GETTER_IMMUTABLE(allocation, std::shared_ptr<GeometryArena::Allocation>)
+
     DECLARE_SETTER_CONSTREF(color, glm::vec4)
 
 protected:
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "Geometry/VertexBuffer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+enum class VertexEncoding : std::uint8_t {
+    Float, // Every attribute as 32 bit floats, the way a VertexBuffer keeps them.
+    Compact // Quantized attributes, and 16 bit indices for meshes with few enough vertices.
+};
+
+// Box that compact positions are quantized to. The dequantization transform maps them back into model space.
+struct VertexBounds {
+    static VertexBounds Of(const VertexBuffer& buffer);
+
+    glm::mat4 dequantization() const;
+
+    glm::vec3 min{ 0.f };
+    glm::vec3 extent{ 1.f };
+};
+
+// Vertex attributes that can be interleaved. Each names the shader input it feeds, the buffer data it comes from and
+// how it is encoded for the GPU.
+template<typename T>
+struct FloatAttribute {
+    using Type = T;
+    static constexpr GLint kComponents = T::length();
+    static constexpr GLenum kDataType = GL_FLOAT;
+    static constexpr GLboolean kNormalized = GL_FALSE;
+    static Type Encode(const T& value, const VertexBounds&) { return value; }
+};
+
+struct Position : FloatAttribute<glm::vec3> {
+    static constexpr std::string_view kName = "position";
+    static const std::pmr::vector<glm::vec3>& Data(const VertexBuffer& buffer) { return buffer.vertices(); }
+};
+
+struct Normal : FloatAttribute<glm::vec3> {
+    static constexpr std::string_view kName = "normal";
+    static const std::pmr::vector<glm::vec3>& Data(const VertexBuffer& buffer) { return buffer.normals(); }
+};
+
+struct Texel : FloatAttribute<glm::vec2> {
+    static constexpr std::string_view kName = "texel";
+    static const std::pmr::vector<glm::vec2>& Data(const VertexBuffer& buffer) { return buffer.texels(); }
+};
+
+struct Color : FloatAttribute<glm::vec4> {
+    static constexpr std::string_view kName = "color";
+    static const std::pmr::vector<glm::vec4>& Data(const VertexBuffer& buffer) { return buffer.colors(); }
+};
+
+// 16 bit unsigned normalized within the mesh bounds, padded to keep vertices 4 byte aligned.
+struct QuantizedPosition {
+    using Type = std::array<std::uint16_t, 4>;
+    static constexpr std::string_view kName = "position";
+    static constexpr GLint kComponents = 3;
+    static constexpr GLenum kDataType = GL_UNSIGNED_SHORT;
+    static constexpr GLboolean kNormalized = GL_TRUE;
+    static const std::pmr::vector<glm::vec3>& Data(const VertexBuffer& buffer) { return buffer.vertices(); }
+    static Type Encode(const glm::vec3& position, const VertexBounds& bounds);
+};
+
+// Unit vector folded onto an octahedron, two 16 bit signed normalized components. The shader unfolds it.
+struct OctahedralNormal {
+    using Type = std::array<std::int16_t, 2>;
+    static constexpr std::string_view kName = "normal";
+    static constexpr GLint kComponents = 2;
+    static constexpr GLenum kDataType = GL_SHORT;
+    static constexpr GLboolean kNormalized = GL_TRUE;
+    static const std::pmr::vector<glm::vec3>& Data(const VertexBuffer& buffer) { return buffer.normals(); }
+    static Type Encode(const glm::vec3& normal, const VertexBounds&);
+};
+
+// Half floats rather than normalized shorts, texture coordinates often wrap outside of [0, 1].
+struct HalfTexel {
+    using Type = std::array<std::uint16_t, 2>;
+    static constexpr std::string_view kName = "texel";
+    static constexpr GLint kComponents = 2;
+    static constexpr GLenum kDataType = GL_HALF_FLOAT;
+    static constexpr GLboolean kNormalized = GL_FALSE;
+    static const std::pmr::vector<glm::vec2>& Data(const VertexBuffer& buffer) { return buffer.texels(); }
+    static Type Encode(const glm::vec2& texel, const VertexBounds&);
+};
+
+struct PackedColor {
+    using Type = std::array<std::uint8_t, 4>;
+    static constexpr std::string_view kName = "color";
+    static constexpr GLint kComponents = 4;
+    static constexpr GLenum kDataType = GL_UNSIGNED_BYTE;
+    static constexpr GLboolean kNormalized = GL_TRUE;
+    static const std::pmr::vector<glm::vec4>& Data(const VertexBuffer& buffer) { return buffer.colors(); }
+    static Type Encode(const glm::vec4& color, const VertexBounds&);
+};
+
+// Runtime view of a VertexFormat, for code that only learns which attributes a mesh has once it's loaded.
+struct VertexLayout {
+    struct Attribute {
+        std::string_view name;
+        GLint size = 0; // Components
+        GLenum dataType = GL_FLOAT;
+        GLboolean normalized = GL_FALSE;
+        std::size_t offset = 0; // Bytes from the start of the vertex
+    };
+
+    // Interleaved layout of a position plus every optional attribute that has data in the buffer and passes the filter.
+    static VertexLayout Select(const VertexBuffer& buffer, VertexEncoding encoding = VertexEncoding::Float, const std::function<bool(std::string_view)>& include = {});
+
+    // The same, for when the buffer is gone and only the filter knows which attributes have data.
+    static VertexLayout Select(VertexEncoding encoding, const std::function<bool(std::string_view)>& include);
+
+    std::span<const Attribute> attributes;
+    std::size_t stride = 0;
+
+    // Writes the buffer's vertices into the destination, which holds stride bytes per vertex. Positions are quantized
+    // to the bounds when the layout is compact.
+    void (*interleave)(const VertexBuffer& buffer, const VertexBounds& bounds, std::span<std::byte> destination) = nullptr;
+};
+
+// An interleaved vertex made of the given attributes, in order. Stride, offsets and the attribute setup are all
+// worked out at compile time.
+template<typename... Attributes>
+class VertexFormat {
+public:
+    static constexpr std::size_t kStride = (sizeof(typename Attributes::Type) + ...);
+
+    static constexpr std::array<VertexLayout::Attribute, sizeof...(Attributes)> kAttributes = []() {
+
+        std::array<VertexLayout::Attribute, sizeof...(Attributes)> attributes;
+
+        std::size_t index = 0;
+        std::size_t offset = 0;
+        ((attributes[index++] = { Attributes::kName, Attributes::kComponents, Attributes::kDataType, Attributes::kNormalized, offset }, offset += sizeof(typename Attributes::Type)), ...);
+
+        return attributes;
+    }();
+
+    static void Interleave(const VertexBuffer& buffer, const VertexBounds& bounds, std::span<std::byte> destination) {
+        InterleaveVertices(buffer, bounds, destination, std::index_sequence_for<Attributes...>{});
+    }
+
+    static constexpr VertexLayout kLayout{ kAttributes, kStride, &Interleave };
+
+private:
+    template<std::size_t... Indices>
+    static void InterleaveVertices(const VertexBuffer& buffer, const VertexBounds& bounds, std::span<std::byte> destination, std::index_sequence<Indices...>) {
+
+        const std::tuple sources{ std::span{ Attributes::Data(buffer) }... };
+        const std::size_t vertexCount = std::min(buffer.vertices().size(), destination.size() / kStride);
+
+        // Whole vertices in order, the destination is often write combined memory mapped from the driver.
+        for (std::size_t index = 0; index < vertexCount; ++index) {
+
+            std::byte* pVertex = destination.data() + index * kStride;
+            (Store<Attributes>(std::get<Indices>(sources), index, bounds, pVertex + kAttributes[Indices].offset), ...);
+        }
+    }
+
+    // Attributes with fewer values than there are positions are padded with zeros.
+    template<typename Attribute, typename T>
+    static void Store(std::span<const T> source, std::size_t index, const VertexBounds& bounds, std::byte* pDestination) {
+
+        typename Attribute::Type value{};
+        if (index < source.size())
+            value = Attribute::Encode(source[index], bounds);
+
+        std::memcpy(pDestination, &value, sizeof(value));
+    }
+};
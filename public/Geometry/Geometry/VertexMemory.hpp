@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Common/ClassMacros.hpp"
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+// Memory for the vertex buffers of one import. Freed blocks are pooled and handed out again, so arrays that grow while
+// a mesh is built don't leave their old storage behind, and everything goes back in one step when the memory is
+// destroyed. Buffers on several threads may allocate from it at once.
+class VertexMemory : public std::pmr::memory_resource {
+public:
+    VertexMemory();
+
+    COPY_MOVE_DISABLED(VertexMemory)
+
+    // Bytes currently handed out.
+    DECLARE_GETTER_IMMUTABLE_COPY(allocated, std::size_t)
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* pMemory, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    mutable std::mutex m_mutex;
+    std::pmr::unsynchronized_pool_resource m_resource;
+    std::size_t m_allocated = 0;
+};
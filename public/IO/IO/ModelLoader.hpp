@@ -2,11 +2,18 @@
 
 #include "Common/ClassMacros.hpp"
 
+#include "Geometry/MeshInstance.hpp"
+#include "Geometry/MeshOptimizer.hpp"
 #include "Geometry/VertexBuffered.hpp"
+#include "Geometry/VertexFormat.hpp"
+#include "IO/TextureLoader.hpp"
+#include "Texture/Image.hpp"
 #include "Texture/Texture.hpp"
 
+#include <cstdint>
 #include <filesystem>
-#include <forward_list>
+#include <functional>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -17,12 +24,83 @@ public:
 
     ModelLoader();
 
+    // Post-processing presets, trading import time for mesh quality.
+    enum class Profile : std::uint8_t {
+        FastPreview, // Triangulate and flat normals only.
+        Balanced, // Smooth normals and shared vertices.
+        FullQuality // Every cleanup and optimization step.
+    };
+
+    struct StageTiming {
+        std::string name;
+        float milliseconds = 0.f;
+    };
+
     struct ModelProperties {
-        std::forward_list<VertexBuffered> meshes;
+        std::vector<VertexBuffered> meshes; // Unique geometry, converted once per aiMesh.
+        std::vector<MeshInstance> instances; // One per node that references a mesh.
         std::unordered_multimap<Texture::Type, std::filesystem::path> texturePaths;
+        std::unordered_map<Texture::Type, Image> textures; // Decoded first diffuse, emissive and specular maps.
+        std::vector<StageTiming> stageTimings; // Wall time of each import stage, in execution order.
+        std::optional<MeshOptimizer::Report> vertexCache; // Cache efficiency of all meshes, when they were optimized.
     };
 
-    ModelProperties load(const std::filesystem::path& path) const;
+    // Receives the overall import progress in [0, 1]. Returning false cancels the import.
+    // May be invoked from worker threads.
+    using ProgressCallback = std::function<bool(float progress)>;
+
+    ModelProperties load(const std::filesystem::path& path, const ProgressCallback& progress = {}) const;
+
+    DECLARE_GETTER_IMMUTABLE_COPY(profile, Profile)
+    DECLARE_SETTER_COPY(profile, Profile)
+
+    // Where binary mesh caches are kept. When empty, caches are written next to the source model.
+    DECLARE_GETTER_IMMUTABLE(cacheDirectory, std::filesystem::path)
+    DECLARE_SETTER_CONSTREF(cacheDirectory, std::filesystem::path)
+
+    DECLARE_GETTER_IMMUTABLE_COPY(cacheEnabled, bool)
+    DECLARE_SETTER_COPY(cacheEnabled, bool)
+
+    // Decode the textures a model references while its geometry is converted.
+    DECLARE_GETTER_IMMUTABLE_COPY(decodeTextures, bool)
+    DECLARE_SETTER_COPY(decodeTextures, bool)
+
+    // Returns false for referenced texture files that don't need decoding, e.g. because they are already on the GPU.
+    // May be invoked from worker threads.
+    using TextureFilter = std::function<bool(const std::filesystem::path& path)>;
+
+    DECLARE_GETTER_IMMUTABLE(textureFilter, TextureFilter)
+    DECLARE_SETTER_CONSTREF(textureFilter, TextureFilter)
+
+    // Mip chain generation and block compression for decoded textures.
+    DECLARE_GETTER_IMMUTABLE(textureProcessing, TextureLoader::Processing)
+    DECLARE_SETTER_CONSTREF(textureProcessing, TextureLoader::Processing)
+
+    // Reorder triangles and vertices for the vertex cache and overdraw. Cached models were already optimized when the
+    // cache was written.
+    DECLARE_GETTER_IMMUTABLE_COPY(optimizeGeometry, bool)
+    DECLARE_SETTER_COPY(optimizeGeometry, bool)
+
+    // Build a chain of simplified levels of detail for every triangle mesh. The setting is part of the cache key, so
+    // changing it misses the cache and imports the model again.
+    DECLARE_GETTER_IMMUTABLE_COPY(generateLods, bool)
+    DECLARE_SETTER_COPY(generateLods, bool)
+
+    // Keep the CPU copy of a model's geometry in memory shared by the whole import and released in a single step, rather
+    // than allocating every array from the heap on its own. Copies of the meshes are always made on the heap. Off by
+    // default, compare both with the loader benchmark before relying on it.
+    DECLARE_GETTER_IMMUTABLE_COPY(pooledGeometry, bool)
+    DECLARE_SETTER_COPY(pooledGeometry, bool)
+
+    // GPU encoding given to loaded meshes. Compact roughly halves their memory and vertex bandwidth at a small cost in
+    // precision, the CPU copy stays float either way.
+    DECLARE_GETTER_IMMUTABLE_COPY(vertexEncoding, VertexEncoding)
+    DECLARE_SETTER_COPY(vertexEncoding, VertexEncoding)
+
+    // Threads used to convert meshes. Zero uses one per hardware thread. Copies of a loader share its threads, so imports
+    // started from copies queue on the same workers.
+    DECLARE_GETTER_IMMUTABLE_COPY(workerCount, std::size_t)
+    DECLARE_SETTER_COPY(workerCount, std::size_t)
 
 private:
     COMPILATION_FIREWALL_COPY_MOVE(ModelLoader)
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Common/ClassMacros.hpp"
+
+#include "Texture/Image.hpp"
+#include "Texture/Texture.hpp"
+#include "Texture/TextureHandle.hpp"
+
+#include <cstddef>
+#include <filesystem>
+
+class TextureUploader;
+
+// Hands out shared handles to textures, so an image is decoded and uploaded once however many materials use it.
+// Files are keyed by canonical path and modification time, backed by a hash of their contents, and identical contents
+// share one texture even under different paths. collect() releases textures once nothing refers to them anymore.
+// Only contains() may be called off the OpenGL thread.
+class TextureCache {
+public:
+    explicit TextureCache(TextureUploader& uploader);
+
+    COPY_MOVE_DISABLED(TextureCache)
+
+    TextureHandle load(const std::filesystem::path& path, Texture::Target target, bool flipUVs = false);
+
+    // Images decoded elsewhere, e.g. during a model import. Identical pixels share a texture. With a source path,
+    // later loads of that unchanged file are served the same texture.
+    TextureHandle upload(Image&& image, Texture::Target target, const std::filesystem::path& source = {});
+
+    // Whether load() would be served without decoding anything.
+    bool contains(const std::filesystem::path& path, Texture::Target target, bool flipUVs = false) const;
+
+    // Deletes the textures that no handle or texture copy outside the cache refers to, and keeps the rest within the
+    // budget. Call once per frame, after the frame's textures were marked as used.
+    void collect();
+
+    DECLARE_GETTER_IMMUTABLE_COPY(textureCount, std::size_t)
+
+    // Bytes of texture memory to stay within. Over budget, textures that weren't drawn since the last collect() drop
+    // their larger levels, least recently drawn first, and stream them back in once they are drawn again.
+    DECLARE_GETTER_IMMUTABLE_COPY(budget, std::size_t)
+    DECLARE_SETTER_COPY(budget, std::size_t)
+
+    // Bytes held by the resident levels of the cached textures, as of the last collect().
+    DECLARE_GETTER_IMMUTABLE_COPY(residentSize, std::size_t)
+
+private:
+    COMPILATION_FIREWALL(TextureCache)
+};
@@ -1,13 +1,47 @@
 #pragma once
 
+#include "Texture/Image.hpp"
 #include "Texture/Texture.hpp"
 
+#include <cstddef>
 #include <filesystem>
+#include <optional>
+#include <span>
 
 #include <glad/glad.h>
 
+class ThreadPool;
+
 class TextureLoader {
 public:
     static Texture load(const std::filesystem::path& path, Texture::Target target);
     static Texture load(const std::filesystem::path& path, Texture::Target target, bool flipUVs);
+
+    // Decodes an image without touching OpenGL, safe to call from any thread.
+    static std::optional<Image> decode(const std::filesystem::path& path, bool flipUVs = false);
+
+    // Decodes an encoded image (PNG, JPEG, ...) that is already in memory.
+    static std::optional<Image> decode(std::span<const std::byte> encoded, bool flipUVs = false);
+
+    // Work done on decoded pixels before they are handed to OpenGL.
+    struct Processing {
+        bool mipmaps = true;
+        bool compress = true;
+        bool highQuality = false;           // BC7 for color instead of BC1 and BC3
+        std::filesystem::path cacheDirectory; // Empty uses the system temp directory
+    };
+
+    // Decodes an image and builds its mip chain and block compresses it on the given pool. Results are cached by a hash
+    // of the encoded source, so later loads of the same file skip straight to the processed pixels.
+    static std::optional<Image> decode(const std::filesystem::path& path, bool flipUVs, const Processing& processing, ThreadPool& pool);
+    static std::optional<Image> decode(std::span<const std::byte> encoded, bool flipUVs, const Processing& processing, ThreadPool& pool);
+
+    // Processes pixels that didn't come from an encoded file, without caching the result.
+    static Image process(Image&& image, const Processing& processing, ThreadPool& pool);
+
+    // Creates an empty, configured texture that can hold the image and its mip chain. Requires a current OpenGL context.
+    static Texture create(const Image& image, Texture::Target target);
+
+    // Creates a texture from decoded pixels. Compressed formats the driver can't sample are expanded first. Requires a current OpenGL context.
+    static Texture upload(const Image& image, Texture::Target target);
 };
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Common/ClassMacros.hpp"
+
+#include "IO/TextureLoader.hpp"
+
+#include "Texture/Image.hpp"
+#include "Texture/Texture.hpp"
+#include "Texture/TextureHandle.hpp"
+
+#include <cstddef>
+#include <filesystem>
+
+// Decodes textures on worker threads and streams them to OpenGL through pixel buffer objects.
+// Only pump() touches OpenGL, call it once per frame on the thread that owns the context.
+class TextureUploader {
+public:
+    // A worker count of zero uses one worker per hardware thread.
+    explicit TextureUploader(std::size_t workerCount = 0);
+
+    COPY_MOVE_DISABLED(TextureUploader)
+
+    TextureHandle load(const std::filesystem::path& path, Texture::Target target, bool flipUVs = false);
+    TextureHandle upload(Image&& image, Texture::Target target);
+
+    // Decodes the file again and streams the levels finer than the texture's base level back into it, after they were
+    // released with Renderer::Evict(). Fails when the file no longer matches the texture.
+    TextureHandle reload(const Texture& texture, const std::filesystem::path& path, bool flipUVs = false);
+
+    // Advances every pending texture by at most one step: decoded images are mapped into a pixel buffer,
+    // filled buffers are handed to the driver and finished transfers fulfill their handles.
+    void pump();
+
+    // Bytes of newly decoded pixels that may start streaming per pump. One image always gets through.
+    DECLARE_GETTER_IMMUTABLE_COPY(bytesPerPump, std::size_t)
+    DECLARE_SETTER_COPY(bytesPerPump, std::size_t)
+
+    // Hands out textures with a mip chain as soon as their smallest levels are resident, and refines them over the
+    // following pumps by lowering their base level as the larger levels arrive.
+    DECLARE_GETTER_IMMUTABLE_COPY(streaming, bool)
+    DECLARE_SETTER_COPY(streaming, bool)
+
+    // Applied to files passed to load(). Images passed to upload() are taken as they are.
+    DECLARE_GETTER_IMMUTABLE(processing, TextureLoader::Processing)
+    DECLARE_SETTER_CONSTREF(processing, TextureLoader::Processing)
+
+    DECLARE_GETTER_IMMUTABLE_COPY(pendingCount, std::size_t)
+
+private:
+    COMPILATION_FIREWALL(TextureUploader)
+};
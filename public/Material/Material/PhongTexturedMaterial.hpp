@@ -9,6 +9,7 @@
 #include <glm/vec3.hpp>
 
 class Texture;
+class TextureHandle;
 
 class PhongTexturedMaterial : public IMaterial {
 public:
@@ -24,12 +25,18 @@ public:
 
     DECLARE_GETTER_CONST_CORRECT(diffuseMap, std::optional<Texture>)
     DECLARE_SETTER_CONSTREF(diffuseMap, Texture)
+    DECLARE_SETTER_CONSTREF(diffuseMap, TextureHandle)
 
     DECLARE_GETTER_CONST_CORRECT(specularMap, std::optional<Texture>)
     DECLARE_SETTER_CONSTREF(specularMap, Texture)
+    DECLARE_SETTER_CONSTREF(specularMap, TextureHandle)
 
     DECLARE_GETTER_CONST_CORRECT(emissiveMap, std::optional<Texture>)
     DECLARE_SETTER_CONSTREF(emissiveMap, Texture)
+    DECLARE_SETTER_CONSTREF(emissiveMap, TextureHandle)
+
+    // Swaps in maps whose uploads finished. Returns true when a map changed.
+    bool update();
 
     DECLARE_GETTER_IMMUTABLE_COPY(shininess, float)
     DECLARE_SETTER_COPY(shininess, float)
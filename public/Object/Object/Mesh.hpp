@@ -4,8 +4,8 @@
 #include "Common/IRestorable.hpp"
 
 #include <bitset>
-#include <forward_list>
 #include <optional>
+#include <vector>
 
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -15,6 +15,7 @@
 
 class IMaterial;
 class VertexBuffered;
+struct MeshInstance;
 
 class Mesh : public IRestorable {
 public:
@@ -29,8 +30,26 @@ public:
     DECLARE_GETTER_IMMUTABLE_COPY(material, IMaterial*)
     DECLARE_SETTER_COPY(material, IMaterial*);
 
-    DECLARE_GETTER_IMMUTABLE_COPY(model, std::forward_list<VertexBuffered>*)
-    DECLARE_SETTER_CONSTREF(model, std::forward_list<VertexBuffered>)
+    DECLARE_GETTER_IMMUTABLE_COPY(model, std::vector<VertexBuffered>*)
+    DECLARE_SETTER_CONSTREF(model, std::vector<VertexBuffered>)
+    void model(std::vector<VertexBuffered>&& model);
+
+    // Release the CPU copy of the geometry once the renderer uploaded it. Counts, bounds and metadata stay.
+    DECLARE_GETTER_IMMUTABLE_COPY(gpuResident, bool)
+    DECLARE_SETTER_COPY(gpuResident, bool)
+
+    // Raised by the renderer when released geometry has to be laid out again. The owner reloads the model and hands it
+    // over through restoreGeometry, until then the mesh draws from what was uploaded.
+    DECLARE_GETTER_IMMUTABLE_COPY(geometryRequested, bool)
+    DECLARE_SETTER_COPY(geometryRequested, bool)
+
+    // Swaps released geometry for a reloaded copy. False, keeping the current model, unless every mesh matches its
+    // counterpart in vertices, indices and levels of detail.
+    bool restoreGeometry(std::vector<VertexBuffered>&& model);
+
+    // Placements of the model's meshes. Without instances every mesh is drawn once, untransformed.
+    DECLARE_GETTER_IMMUTABLE(instances, std::vector<MeshInstance>)
+    DECLARE_SETTER_CONSTREF(instances, std::vector<MeshInstance>)
 
     DECLARE_GETTER_IMMUTABLE_COPY(transform, glm::mat4)
 
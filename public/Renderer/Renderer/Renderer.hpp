@@ -3,7 +3,6 @@
 #include "Common/ClassMacros.hpp"
 
 #include <array>
-#include <forward_list>
 
 #include <glad/glad.h>
 
@@ -21,12 +20,22 @@ class VertexBuffered;
 
 class Renderer {
 public:
-    static void Allocate(Mesh& mesh);
-    static void Allocate(const Texture& texture, std::uint8_t* pData);
+    static void Allocate(const Texture& texture, const std::uint8_t* pData);
+
+    // Fills one level of a texture allocated earlier. With a pixel buffer bound the data pointer is an offset into it.
+    static void Allocate(const Texture& texture, unsigned int level, const std::uint8_t* pData);
+
+    // Frees the levels finer than the given one, which becomes the base level. Sampling carries on with the rest.
+    static void Evict(Texture& texture, unsigned int baseLevel);
+
+    // Allocates the levels finer than the base level again, without filling them.
+    static void Reserve(const Texture& texture);
 
-    static void Configure(Mesh& mesh);
     static void Configure(Texture& texture);
 
+    // Whether the driver can sample the given compressed internal format.
+    static bool SupportsCompressedFormat(GLenum format);
+
     Renderer();
 
     void createFramebuffer(const glm::uvec2& dimensions);
@@ -41,9 +50,21 @@ public:
     DECLARE_SETTER_COPY(ambientColor, glm::vec3*)
     DECLARE_SETTER_COPY(ambientIntensity, float*)
 
+    // Level of detail every mesh is drawn at, clamped to the levels it has. Negative picks levels by screen size.
+    DECLARE_SETTER_COPY(lodLock, int*)
+
     void setup();
     void camera(Camera* pCamera);
 
+    // Lays out and uploads the mesh for its material's program. Interleaved geometry goes into the renderer's vertex
+    // arenas.
+    void configure(Mesh& mesh);
+    void allocate(Mesh& mesh);
+
+    // Frees the vertex arenas, e.g. once the model is closed. Geometry still drawing from one keeps its buffers until
+    // it's destroyed.
+    void releaseGeometry();
+
     void draw(const Mesh& mesh) const;
 
     void ambientColor(glm::vec3* pAmbientColor, float* pAmbientIntensity);
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Texture/Image.hpp"
+#include "Texture/Texture.hpp"
+
+#include <optional>
+
+class ThreadPool;
+
+// CPU encoders and decoders for the BCn block formats. Rows of blocks are processed in parallel.
+class BlockCompression {
+public:
+    // Block format for an uncompressed layout: BC4 for one channel, BC5 for two, BC1 for RGB and BC3 for RGBA.
+    // High quality uses BC7 for color instead.
+    static Texture::Channels ChooseFormat(Texture::Channels channels, bool highQuality);
+
+    static std::optional<Image> Encode(const Image& image, Texture::Channels format, ThreadPool& pool);
+
+    // Expands a compressed image back to 8 bit channels, for drivers that can't sample the format.
+    // BC7 is limited to mode 6, the only mode the encoder writes.
+    static std::optional<Image> Decode(const Image& image, ThreadPool& pool);
+};
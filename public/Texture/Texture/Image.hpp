@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Common/ClassMacros.hpp"
+
+#include "Texture/Texture.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include <cstddef>
+
+// Pixels in system memory. Either tightly packed rows of 8 bit channels or, for compressed formats, rows of 4x4 blocks.
+// A mip chain stores its levels back to back in pixels, largest first, each half the size of the one before.
+class Image {
+public:
+    // Levels in a full mip chain for an image of the given size.
+    static unsigned int MaxLevelCount(unsigned int width, unsigned int height);
+
+    Image();
+    Image(unsigned int width, unsigned int height, Texture::Channels channels, std::vector<std::uint8_t>&& pixels, unsigned int levelCount = 1);
+
+    DECLARE_GETTER_IMMUTABLE_COPY(width, unsigned int)
+    DECLARE_GETTER_IMMUTABLE_COPY(height, unsigned int)
+    DECLARE_GETTER_IMMUTABLE_COPY(channels, Texture::Channels)
+    DECLARE_GETTER_IMMUTABLE(pixels, std::vector<std::uint8_t>)
+    DECLARE_GETTER_IMMUTABLE_COPY(levelCount, unsigned int)
+
+    unsigned int levelWidth(unsigned int level) const;
+    unsigned int levelHeight(unsigned int level) const;
+    std::size_t levelOffset(unsigned int level) const;
+    std::size_t levelSize(unsigned int level) const;
+
+    DECLARE_GETTER_IMMUTABLE_COPY(channelCount, unsigned int)
+    DECLARE_GETTER_IMMUTABLE_COPY(empty, bool)
+
+private:
+    COMPILATION_FIREWALL_COPY_MOVE(Image)
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Texture/Image.hpp"
+
+#include <optional>
+
+class ThreadPool;
+
+// Builds full mip chains for uncompressed 8 bit images, splitting each level across the pool.
+class MipChain {
+public:
+    // Each level is a 2x2 box filter of the one before. Color channels of RGB and RGBA images are averaged in linear
+    // space, alpha and one or two channel images are filtered as plain data.
+    static std::optional<Image> Generate(const Image& image, ThreadPool& pool);
+};
@@ -3,11 +3,26 @@
 #include "Common/ClassMacros.hpp"
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 
 #include <glad/glad.h>
 #include <glm/vec4.hpp>
 
+// S3TC and BPTC are extensions to OpenGL 3.3, the loader doesn't necessarily define them.
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+
 class Texture {
 public:
     enum class Wrap : GLenum {
@@ -31,6 +46,12 @@ public:
         RG = GL_RG,
         RGB = GL_RGB,
         RGBA = GL_RGBA,
+        BGRA = GL_BGRA,
+        BC1 = GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+        BC3 = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+        BC4 = GL_COMPRESSED_RED_RGTC1,
+        BC5 = GL_COMPRESSED_RG_RGTC2,
+        BC7 = GL_COMPRESSED_RGBA_BPTC_UNORM,
         Depth16 = GL_DEPTH_COMPONENT16,
         Depth24 = GL_DEPTH_COMPONENT24,
         Depth32 = GL_DEPTH_COMPONENT32,
@@ -50,6 +71,14 @@ public:
         Specular,
     };
 
+    static bool IsCompressed(Channels format);
+
+    // Channels per pixel of an uncompressed format, zero for anything else.
+    static unsigned int ChannelCount(Channels format);
+
+    // Bytes of pixel data for one image in the given format.
+    static std::size_t ImageSize(unsigned int width, unsigned int height, Channels format);
+
     Texture();
     Texture(unsigned int width, unsigned int height, Channels textureFormat, Channels pixelFormat, Target target);
 
@@ -76,7 +105,26 @@ public:
     DECLARE_SETTER_COPY(wrapT, Wrap)
 
     DECLARE_GETTER_IMMUTABLE_COPY(mipmap, bool)
-    DECLARE_SETTER_COPY(wrapT, bool)
+    DECLARE_SETTER_COPY(mipmap, bool)
+
+    // Mip levels uploaded with the pixels. A mipmapped texture with a single level gets its chain from the driver.
+    DECLARE_GETTER_IMMUTABLE_COPY(levelCount, unsigned int)
+    DECLARE_SETTER_COPY(levelCount, unsigned int)
+
+    // Finest level that holds pixels. Streamed textures lower it as the larger levels arrive, evicted ones raise it.
+    // Belongs to the OpenGL name, so it is shared by every copy and only kept once the texture is initialized.
+    DECLARE_GETTER_IMMUTABLE_COPY(baseLevel, unsigned int)
+    DECLARE_SETTER_COPY(baseLevel, unsigned int)
+
+    // Bytes of GPU memory held by the levels from the base level down.
+    DECLARE_GETTER_IMMUTABLE_COPY(residentSize, std::size_t)
+
+    // Ticks once for every texture marked as used, so stamps order textures by how recently they were drawn.
+    static std::uint64_t UseClock();
+
+    // Called when the texture is bound for drawing. Shared by every copy.
+    void markUsed() const;
+    DECLARE_GETTER_IMMUTABLE_COPY(lastUsed, std::uint64_t)
 
     std::array<float, 4> borderColor() const;
     DECLARE_SETTER_CONSTREF(borderColor, glm::vec4)
@@ -84,6 +132,9 @@ public:
     void initialize();
     DECLARE_GETTER_IMMUTABLE_COPY(initialized, bool)
 
+    // Copies of a texture share its OpenGL name. Each copy releases its share with destroy(), and the name is only
+    // deleted along with the last one.
+    DECLARE_GETTER_IMMUTABLE_COPY(useCount, long)
     void destroy() const;
 
 private:
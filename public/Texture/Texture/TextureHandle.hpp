@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Common/ClassMacros.hpp"
+
+#include "Texture/Texture.hpp"
+
+#include <cstdint>
+
+// Future-like view of a texture that is still being decoded or uploaded. Copies share the same state.
+// Fulfilled and read on the OpenGL thread.
+class TextureHandle {
+public:
+    enum class Status : std::uint8_t {
+        Pending,
+        Ready,
+        Failed
+    };
+
+    TextureHandle();
+
+    DECLARE_GETTER_IMMUTABLE_COPY(status, Status)
+    DECLARE_GETTER_IMMUTABLE_COPY(ready, bool)
+
+    // Only meaningful once the handle is ready.
+    DECLARE_GETTER_IMMUTABLE(texture, Texture)
+
+    // Handles sharing this state, including this one.
+    DECLARE_GETTER_IMMUTABLE_COPY(useCount, long)
+
+    void fulfill(const Texture& texture);
+    void fail();
+
+private:
+    COMPILATION_FIREWALL_COPY_MOVE(TextureHandle)
+};
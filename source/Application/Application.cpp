@@ -8,6 +8,8 @@
 
 #include "Controls/OrbitalControls.hpp"
 
+#include "IO/ModelLoader.hpp"
+
 #include "Light/DirectionalLight.hpp"
 
 #include "Material/LambertianMaterial.hpp"
@@ -123,6 +125,7 @@ public:
         glm::vec3 ambientColor{ 1.f };
         float ambientIntensity = 0.f;
         std::array<DirectionalLight, 3> lights;
+        int lodLock = -1; // Picked by screen size.
 
         // Window
 
@@ -130,6 +133,17 @@ public:
         glm::vec2 windowPosition{ 0, 0 };
         bool windowMaximized = false;
         int windowTheme = 0;
+
+        // Import
+
+        int importProfile = static_cast<int>(ModelLoader::Profile::FullQuality);
+        bool compactVertices = false;
+        bool gpuResidentGeometry = false;
+        int vertexLayout = static_cast<int>(VertexBuffered::Layout::Interleaved);
+
+        // Textures
+
+        int textureBudget = 1024; // MiB
     } m_dataModel;
 };
 
@@ -205,8 +219,8 @@ void Application::Private::render() {
         if (m_dataModel.mesh.model() && m_dataModel.mesh.material()) {
 
             if (!m_dataModel.mesh.initialized()) {
-                Renderer::Configure(m_dataModel.mesh);
-                Renderer::Allocate(m_dataModel.mesh);
+                m_renderer.configure(m_dataModel.mesh);
+                m_renderer.allocate(m_dataModel.mesh);
             }
 
             m_renderer.draw(m_dataModel.mesh);
@@ -268,6 +282,13 @@ nlohmann::json Application::Private::save() const {
     obj["Window"]["position"] = m_dataModel.windowPosition;
     obj["Window"]["maximized"] = m_dataModel.windowMaximized;
     obj["Window"]["theme"] = m_dataModel.windowTheme;
+
+    obj["Import"]["profile"] = m_dataModel.importProfile;
+    obj["Import"]["compactVertices"] = m_dataModel.compactVertices;
+    obj["Import"]["gpuResidentGeometry"] = m_dataModel.gpuResidentGeometry;
+    obj["Import"]["vertexLayout"] = m_dataModel.vertexLayout;
+
+    obj["Textures"]["budget"] = m_dataModel.textureBudget;
     
     obj["Scene"]["clearColor"] = m_dataModel.clearColor;
     obj["Scene"]["ambientColor"] = m_dataModel.ambientColor;
@@ -326,6 +347,29 @@ void Application::Private::restore(const nlohmann::json& settings) {
         }
     }
 
+    if (settings.contains("Import")) {
+        const nlohmann::json& json = settings.at("Import");
+
+        if (json.contains("profile"))
+            json.at("profile").get_to(m_dataModel.importProfile);
+
+        if (json.contains("compactVertices"))
+            json.at("compactVertices").get_to(m_dataModel.compactVertices);
+
+        if (json.contains("gpuResidentGeometry"))
+            json.at("gpuResidentGeometry").get_to(m_dataModel.gpuResidentGeometry);
+
+        if (json.contains("vertexLayout"))
+            json.at("vertexLayout").get_to(m_dataModel.vertexLayout);
+    }
+
+    if (settings.contains("Textures")) {
+        const nlohmann::json& json = settings.at("Textures");
+
+        if (json.contains("budget"))
+            json.at("budget").get_to(m_dataModel.textureBudget);
+    }
+
     if (settings.contains("Scene")) {
         const nlohmann::json& json = settings.at("Scene");
 
@@ -401,6 +445,7 @@ void Application::Private::onInitialized() {
     m_mainFrame.viewport().viewportResized.connect(&Application::Private::onViewportResized, this);
     m_mainFrame.exited.connect([this] { glfwSetWindowShouldClose(m_pWindow, GLFW_TRUE); });
     m_mainFrame.themeChanged.connect([this](int theme) { onThemeChanged(theme); });
+    m_mainFrame.modelUnloaded.connect([this] { m_renderer.releaseGeometry(); });
 
     // Window controls signals
     m_callbacks.projectionChanged.connect(&Application::Private::onProjectionChange, this);
@@ -440,17 +485,24 @@ void Application::Private::onInitialized() {
     m_renderer.directionalLights(lights);
     m_renderer.ambientColor(&m_dataModel.ambientColor);
     m_renderer.ambientIntensity(&m_dataModel.ambientIntensity);
+    m_renderer.lodLock(&m_dataModel.lodLock);
 
     MainFrameComponent::DataModel model;
     model.m_pAmbientColor = &m_dataModel.ambientColor;
     model.m_pClearColor = &m_dataModel.clearColor;
     model.m_pAmbientIntensity = &m_dataModel.ambientIntensity;
+    model.m_pLodLock = &m_dataModel.lodLock;
     model.m_pMesh = &m_dataModel.mesh;
     model.m_pLambertianMat = &m_dataModel.lambertianMaterial;
     model.m_pPhongMat = &m_dataModel.phongMaterial;
     model.m_pPhongTexturedMat = &m_dataModel.phongTexturedMaterial;
     model.m_lights = lights;
     model.m_pWindowTheme = &m_dataModel.windowTheme;
+    model.m_pImportProfile = &m_dataModel.importProfile;
+    model.m_pCompactVertices = &m_dataModel.compactVertices;
+    model.m_pGpuResidentGeometry = &m_dataModel.gpuResidentGeometry;
+    model.m_pVertexLayout = &m_dataModel.vertexLayout;
+    model.m_pTextureBudget = &m_dataModel.textureBudget;
 
     static_cast<IComponent&>(m_mainFrame).syncFrom(&model);
 }
@@ -0,0 +1,56 @@
+#include "UI/Components/ImportProgress.hpp"
+#include "UI/Utility.hpp"
+
+#include <imgui.h>
+
+void ImportProgress::render() {
+
+    if (m_dataModel.m_active && !ImGui::IsPopupOpen(windowId()))
+        ImGui::OpenPopup(windowId());
+
+    const ImGuiWindowFlags windowFlags =
+        ImGuiWindowFlags_NoResize |
+        ImGuiWindowFlags_AlwaysAutoResize |
+        ImGuiWindowFlags_NoSavedSettings;
+
+    if (ImGui::BeginPopupModal(windowId(), nullptr, windowFlags)) {
+
+        if (!m_dataModel.m_active) {
+            ImGui::CloseCurrentPopup();
+            ImGui::EndPopup();
+            return;
+        }
+
+        ImGui::Text("%s", m_dataModel.m_modelPath.filename().string().c_str());
+        ImGui::ProgressBar(m_dataModel.m_progress, { 300, 0 });
+
+        ImGui::Spacing();
+
+        ImGui::SetCursorPosX(Utility::ComputeRightAlignedCursorPos({ 75 }));
+        if (ImGui::Button("Cancel##ImportProgress", { 75, ImGui::GetFrameHeight() })) {
+            canceled();
+
+            m_dataModel.m_active = false;
+            ImGui::CloseCurrentPopup();
+        }
+
+        ImGui::EndPopup();
+    }
+}
+
+void ImportProgress::syncFrom(const IComponent::DataModel* pFrom) {
+
+    if (!pFrom)
+        return;
+
+    if (auto pModel = dynamic_cast<const DataModel*>(pFrom))
+        m_dataModel = *pModel;
+}
+
+const IComponent::DataModel* ImportProgress::dataModel() const {
+    return &m_dataModel;
+}
+
+const char* ImportProgress::windowId() const {
+    return kWindowId;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "UI/Components/IComponent.hpp"
+
+#include <filesystem>
+
+#include <sigslot/signal.hpp>
+
+class ImportProgress : public IComponent {
+public:
+    static constexpr const char* kWindowId = "Importing Model";
+
+    sigslot::signal<> canceled;
+
+    struct DataModel : public IComponent::DataModel {
+        std::filesystem::path m_modelPath;
+        float m_progress = 0.f;
+        bool m_active = false;
+    };
+
+private:
+    virtual void render() override;
+    virtual void syncFrom(const IComponent::DataModel* pFrom) override;
+    virtual const IComponent::DataModel* dataModel() const override;
+    virtual const char* windowId() const override;
+
+    DataModel m_dataModel;
+};
@@ -7,12 +7,20 @@
 
 #include "Light/DirectionalLight.hpp"
 
+#include <chrono>
+#include <iostream>
+
 #include <GLFW/glfw3.h>
 #include <imgui.h>
 #include <imgui_internal.h>
 
 MainFrameComponent::MainFrameComponent() {
 
+    m_model.m_pTextureCache = &m_textureCache;
+
+    // Files the cache already holds don't need decoding again.
+    m_modelLoader.textureFilter([pCache = &m_textureCache](const std::filesystem::path& path) { return !pCache->contains(path, Texture::Target::Texture2D); });
+
     m_sceneTree.nodeSelected.connect(&MainFrameComponent::OnSceneNodeSelected, this);
     m_sceneTree.materialSelected.connect([this](int materialIndex) {
         OnMaterialSelected(materialIndex);
@@ -30,6 +38,7 @@ MainFrameComponent::MainFrameComponent() {
     m_modelProps.rollChanged.connect([this](float roll) { m_model.m_pMesh->roll(roll); });
     m_modelProps.scaleChanged.connect([this](float scale) { m_model.m_pMesh->scale(scale); });
     m_modelProps.positionOffsetsChanged.connect([this](const glm::vec3& offsets) { m_model.m_pMesh->translate(offsets); });
+    m_modelProps.lodLockChanged.connect([this](int level) { if (m_model.m_pLodLock) *m_model.m_pLodLock = level; });
     m_modelProps.materialSelected.connect([this](int materialIndex) {
         OnMaterialSelected(materialIndex);
         static_cast<IComponent&>(m_sceneTree).syncFrom(dataModel());
@@ -47,7 +56,7 @@ MainFrameComponent::MainFrameComponent() {
     m_phongProps.shininessChanged.connect([this](float shininess) { m_model.m_pPhongMat->shininess(shininess); });
 
     m_phongTexturedProps.diffuseIntensityChanged.connect([this](float intensity) { m_model.m_pPhongTexturedMat->diffuseIntensity(intensity); });
-    m_phongTexturedProps.diffuseMapLoaded.connect([this](const Texture& map) { m_model.m_pPhongTexturedMat->diffuseMap(map); });
+    m_phongTexturedProps.diffuseMapLoaded.connect([this](const TextureHandle& map) { m_model.m_pPhongTexturedMat->diffuseMap(map); });
     m_phongTexturedProps.diffuseMapUnloaded.connect([this] {
         if (auto& map = m_model.m_pPhongTexturedMat->diffuseMap(); map) {
             map->destroy();
@@ -55,7 +64,7 @@ MainFrameComponent::MainFrameComponent() {
         }
     });
     m_phongTexturedProps.emissiveIntensityChanged.connect([this](float intensity) { m_model.m_pPhongTexturedMat->emissiveIntensity(intensity); });
-    m_phongTexturedProps.emissiveMapLoaded.connect([this](const Texture& map) { m_model.m_pPhongTexturedMat->emissiveMap(map); });
+    m_phongTexturedProps.emissiveMapLoaded.connect([this](const TextureHandle& map) { m_model.m_pPhongTexturedMat->emissiveMap(map); });
     m_phongTexturedProps.emissiveMapUnloaded.connect([this] {
         if (auto& map = m_model.m_pPhongTexturedMat->emissiveMap(); map) {
             map->destroy();
@@ -63,7 +72,7 @@ MainFrameComponent::MainFrameComponent() {
         }
     });
     m_phongTexturedProps.specularIntensityChanged.connect([this](float intensity) { m_model.m_pPhongTexturedMat->specularIntensity(intensity); });
-    m_phongTexturedProps.specularMapLoaded.connect([this](const Texture& map) { m_model.m_pPhongTexturedMat->specularMap(map); });
+    m_phongTexturedProps.specularMapLoaded.connect([this](const TextureHandle& map) { m_model.m_pPhongTexturedMat->specularMap(map); });
     m_phongTexturedProps.specularMapUnloaded.connect([this] {
         if (auto& map = m_model.m_pPhongTexturedMat->specularMap(); map) {
             map->destroy();
@@ -91,12 +100,65 @@ MainFrameComponent::MainFrameComponent() {
     m_mainMenu.modelPropertiesOpened.connect([this] { OnSceneNodeSelected(SceneTreeComponent::SceneNode::Model); });
     m_mainMenu.scenePropertiesOpened.connect([this] { OnSceneNodeSelected(SceneTreeComponent::SceneNode::Scene); });
     m_mainMenu.themeChanged.connect([this](int theme) { themeChanged(theme); });
+    m_mainMenu.importProfileChanged.connect([this](int profile) {
+        if (m_model.m_pImportProfile)
+            *m_model.m_pImportProfile = profile;
+
+        m_modelLoader.profile(static_cast<ModelLoader::Profile>(profile));
+    });
+    m_mainMenu.compactVerticesChanged.connect([this](bool compact) {
+        if (m_model.m_pCompactVertices)
+            *m_model.m_pCompactVertices = compact;
+
+        m_modelLoader.vertexEncoding(compact ? VertexEncoding::Compact : VertexEncoding::Float);
+    });
+    m_mainMenu.gpuResidentGeometryChanged.connect([this](bool gpuResident) {
+        if (m_model.m_pGpuResidentGeometry)
+            *m_model.m_pGpuResidentGeometry = gpuResident;
+
+        if (!m_model.m_pMesh)
+            return;
+
+        m_model.m_pMesh->gpuResident(gpuResident);
+
+        // Geometry that is already uploaded doesn't wait for the next upload to be released.
+        if (gpuResident && m_model.m_pMesh->initialized() && m_model.m_pMesh->model())
+            for (VertexBuffered& geometry : *m_model.m_pMesh->model())
+                geometry.releaseBuffer();
+    });
+    m_mainMenu.vertexLayoutChanged.connect(&MainFrameComponent::OnVertexLayoutChanged, this);
+    m_mainMenu.textureBudgetChanged.connect([this](int budget) {
+        if (m_model.m_pTextureBudget)
+            *m_model.m_pTextureBudget = budget;
+
+        m_textureCache.budget(static_cast<std::size_t>(budget) << 20);
+    });
 
     m_fileExplorer.fileSelected.connect(&MainFrameComponent::OnModelSelected, this);
+
+    m_importProgress.canceled.connect(&MainFrameComponent::OnModelImportCanceled, this);
+}
+
+MainFrameComponent::~MainFrameComponent() {
+
+    // Let a running import bail out early, its future blocks on destruction until it finished.
+    if (m_pImportState)
+        m_pImportState->m_canceled = true;
+
+    if (m_pGeometryState)
+        m_pGeometryState->m_canceled = true;
 }
 
 void MainFrameComponent::render() {
 
+    pollModelImport();
+    pollGeometryReload();
+
+    m_textureUploader.pump();
+    m_textureCache.collect();
+    if (m_model.m_pPhongTexturedMat && m_model.m_pPhongTexturedMat->update())
+        static_cast<IComponent&>(m_phongTexturedProps).syncFrom(dataModel());
+
     const ImGuiViewport* pViewport = ImGui::GetMainViewport();
 
     // Offset the GUI by the height of the menu bar.
@@ -156,6 +218,7 @@ void MainFrameComponent::render() {
         static_cast<IComponent&>(m_sceneTree).render();
         static_cast<IComponent&>(m_viewport).render();
         static_cast<IComponent&>(m_fileExplorer).render();
+        static_cast<IComponent&>(m_importProgress).render();
 
         ImGui::End();
     }
@@ -188,6 +251,19 @@ void MainFrameComponent::syncFrom(const IComponent::DataModel* pFrom) {
         return;
 
     m_model = *pModel;
+    m_model.m_pTextureCache = &m_textureCache;
+
+    if (m_model.m_pImportProfile)
+        m_modelLoader.profile(static_cast<ModelLoader::Profile>(*m_model.m_pImportProfile));
+
+    if (m_model.m_pCompactVertices)
+        m_modelLoader.vertexEncoding(*m_model.m_pCompactVertices ? VertexEncoding::Compact : VertexEncoding::Float);
+
+    if (m_model.m_pGpuResidentGeometry && m_model.m_pMesh)
+        m_model.m_pMesh->gpuResident(*m_model.m_pGpuResidentGeometry);
+
+    if (m_model.m_pTextureBudget)
+        m_textureCache.budget(static_cast<std::size_t>(*m_model.m_pTextureBudget) << 20);
 
     for (std::uint8_t lightIndex = 0; lightIndex != m_model.m_lights.size(); ++lightIndex) {
 
@@ -297,21 +373,185 @@ void MainFrameComponent::OnModelSelected(const std::filesystem::path& modelPath)
     if (!std::filesystem::is_regular_file(modelPath))
         return;
 
-    static ModelLoader loader;
-    const auto modelProperties = loader.load(modelPath);
+    // Only one import runs at a time, a new selection replaces the pending one.
+    OnModelImportCanceled();
+
+    m_pImportState = std::make_shared<ImportState>();
+    m_pendingModelPath = modelPath;
+    m_pendingModel = std::async(std::launch::async, [loader = m_modelLoader, modelPath, pState = m_pImportState] {
+        return loader.load(modelPath, [pState](float progress) {
+            pState->m_progress = progress;
+            return !pState->m_canceled;
+        });
+    });
+
+    ImportProgress::DataModel model;
+    model.m_modelPath = modelPath;
+    model.m_active = true;
+
+    static_cast<IComponent&>(m_importProgress).syncFrom(&model);
+}
+
+void MainFrameComponent::OnModelLoaded(const std::filesystem::path& modelPath, ModelLoader::ModelProperties&& modelProperties) {
+
+    // Keep the current model if the import failed.
+    if (modelProperties.meshes.empty())
+        return;
+
+    if (m_model.m_pVertexLayout) {
+        for (VertexBuffered& geometry : modelProperties.meshes)
+            geometry.layout(static_cast<VertexBuffered::Layout>(*m_model.m_pVertexLayout));
+    }
 
     m_model.m_pMesh->destroy();
-    m_model.m_pMesh->model(modelProperties.meshes);
-    m_model.m_pMesh->position(-ComputeCenter(m_model.m_pMesh->model()));
-    m_model.m_pMesh->scale(ComputeScale(m_model.m_pMesh->model(), kMaxModelSize));
+    modelUnloaded();
+
+    m_model.m_pMesh->model(std::move(modelProperties.meshes));
+    m_model.m_pMesh->instances(modelProperties.instances);
+
+    // Released geometry is reloaded with the settings it was imported with, a pending reload is for the old model.
+    cancelGeometryReload();
+    m_geometryLoader = m_modelLoader;
+    m_geometryLoader.decodeTextures(false);
+
+    m_model.m_pMesh->position(-ComputeCenter(m_model.m_pMesh->model(), &m_model.m_pMesh->instances()));
+    m_model.m_pMesh->scale(ComputeScale(m_model.m_pMesh->model(), kMaxModelSize, &m_model.m_pMesh->instances()));
     m_model.m_modelPath = modelPath;
-    m_model.m_texturePaths = modelProperties.texturePaths;
+    m_model.m_texturePaths = std::move(modelProperties.texturePaths);
+    m_model.m_importTimings = std::move(modelProperties.stageTimings);
+    m_model.m_vertexCache = modelProperties.vertexCache;
+
+    // The maps were decoded alongside the geometry and are streamed to the GPU over the next frames. Maps the import
+    // didn't decode, because the cache held them or decoding was off, are loaded through the cache.
+    m_model.m_pPhongTexturedMat->destroy();
+
+    for (const Texture::Type type : { Texture::Type::Diffuse, Texture::Type::Emissive, Texture::Type::Specular }) {
+
+        std::filesystem::path texturePath;
+        if (const auto foundIter = m_model.m_texturePaths.find(type); foundIter != m_model.m_texturePaths.cend())
+            texturePath = foundIter->second.is_relative() ? modelPath.parent_path() / foundIter->second : foundIter->second;
+
+        std::optional<TextureHandle> handle;
+        if (const auto imageIter = modelProperties.textures.find(type); imageIter != modelProperties.textures.end())
+            handle = m_textureCache.upload(std::move(imageIter->second), Texture::Target::Texture2D, texturePath);
+        else if (!texturePath.empty())
+            handle = m_textureCache.load(texturePath, Texture::Target::Texture2D);
+
+        if (!handle || handle->status() == TextureHandle::Status::Failed)
+            continue;
+
+        switch (type) {
+        case Texture::Type::Diffuse: m_model.m_pPhongTexturedMat->diffuseMap(*handle); break;
+        case Texture::Type::Emissive: m_model.m_pPhongTexturedMat->emissiveMap(*handle); break;
+        case Texture::Type::Specular: m_model.m_pPhongTexturedMat->specularMap(*handle); break;
+        default: break;
+        }
+    }
 
     static_cast<IComponent&>(m_modelProps).syncFrom(dataModel());
     static_cast<IComponent&>(m_sceneTree).syncFrom(dataModel());
     static_cast<IComponent&>(m_mainMenu).syncFrom(dataModel());
 }
 
+void MainFrameComponent::OnModelImportCanceled() {
+
+    if (!m_pendingModel.valid())
+        return;
+
+    m_pImportState->m_canceled = true;
+    m_canceledImports.push_back(std::move(m_pendingModel));
+
+    m_pImportState.reset();
+    m_pendingModelPath.clear();
+
+    const ImportProgress::DataModel model;
+    static_cast<IComponent&>(m_importProgress).syncFrom(&model);
+}
+
+void MainFrameComponent::pollModelImport() {
+
+    const auto isReady = [](const std::future<ModelLoader::ModelProperties>& future) {
+        return future.wait_for(std::chrono::seconds::zero()) == std::future_status::ready;
+    };
+
+    std::erase_if(m_canceledImports, isReady);
+
+    if (!m_pendingModel.valid())
+        return;
+
+    if (!isReady(m_pendingModel)) {
+
+        ImportProgress::DataModel model;
+        model.m_modelPath = m_pendingModelPath;
+        model.m_progress = m_pImportState->m_progress;
+        model.m_active = true;
+
+        static_cast<IComponent&>(m_importProgress).syncFrom(&model);
+        return;
+    }
+
+    OnModelLoaded(m_pendingModelPath, m_pendingModel.get());
+
+    m_pImportState.reset();
+    m_pendingModelPath.clear();
+
+    const ImportProgress::DataModel model;
+    static_cast<IComponent&>(m_importProgress).syncFrom(&model);
+}
+
+void MainFrameComponent::cancelGeometryReload() {
+
+    if (!m_pendingGeometry.valid())
+        return;
+
+    m_pGeometryState->m_canceled = true;
+    m_canceledImports.push_back(std::move(m_pendingGeometry));
+    m_pGeometryState.reset();
+}
+
+void MainFrameComponent::pollGeometryReload() {
+
+    Mesh& mesh = *m_model.m_pMesh;
+
+    // Runs like an import, a reload parses, optimizes and builds levels of detail all over again.
+    if (!m_pendingGeometry.valid()) {
+
+        if (!mesh.geometryRequested() || m_model.m_modelPath.empty())
+            return;
+
+        m_pGeometryState = std::make_shared<ImportState>();
+        m_pendingGeometry = std::async(std::launch::async, [loader = m_geometryLoader, modelPath = m_model.m_modelPath, pState = m_pGeometryState] {
+            return loader.load(modelPath, [pState](float) { return !pState->m_canceled; });
+        });
+
+        return;
+    }
+
+    if (m_pendingGeometry.wait_for(std::chrono::seconds::zero()) != std::future_status::ready)
+        return;
+
+    ModelLoader::ModelProperties properties = m_pendingGeometry.get();
+    m_pGeometryState.reset();
+
+    // Drawing carries on from the upload, a later material change asks again.
+    if (!mesh.restoreGeometry(std::move(properties.meshes))) {
+        std::cerr << "Warning: Unable to reload the geometry of " << m_model.m_modelPath << ", keeping what was uploaded.\n";
+        mesh.geometryRequested(false);
+    }
+}
+
+void MainFrameComponent::OnVertexLayoutChanged(int layout) {
+
+    if (m_model.m_pVertexLayout)
+        *m_model.m_pVertexLayout = layout;
+
+    // The mesh is configured and uploaded again in the new layout, released geometry is reloaded for it first.
+    for (VertexBuffered& geometry : *m_model.m_pMesh->model())
+        geometry.layout(static_cast<VertexBuffered::Layout>(layout));
+
+    m_model.m_pMesh->initialized(false);
+}
+
 void MainFrameComponent::OnLightStatusChanged(std::uint8_t lightIndex, bool enabled) {
 
     DirectionalLight* pLight = m_model.m_lights.at(lightIndex);
@@ -330,8 +570,13 @@ void MainFrameComponent::OnLightStatusChanged(std::uint8_t lightIndex, bool enab
 
 void MainFrameComponent::OnModelClosed() {
 
+    // An import still in flight would otherwise install its model after the close.
+    OnModelImportCanceled();
+
     m_properties.propertiesComponent(nullptr);
     m_model.m_pMesh->destroy();
+    modelUnloaded();
+    cancelGeometryReload();
 
     static_cast<IComponent&>(m_sceneTree).syncFrom(dataModel());
     static_cast<IComponent&>(m_mainMenu).syncFrom(dataModel());
@@ -5,6 +5,10 @@
 #include "Common/ClassMacros.hpp"
 #include "Common/Constants.hpp"
 
+#include "IO/ModelLoader.hpp"
+#include "IO/TextureCache.hpp"
+#include "IO/TextureUploader.hpp"
+
 #include "Material/LambertianMaterial.hpp"
 #include "Material/PhongMaterial.hpp"
 #include "Material/PhongTexturedMaterial.hpp"
@@ -14,6 +18,7 @@
 #include "Texture/Texture.hpp"
 
 #include "UI/Components/IComponent.hpp"
+#include "UI/Components/ImportProgress.hpp"
 #include "UI/Components/MainMenu.hpp"
 #include "UI/Components/SceneTree.hpp"
 #include "UI/Components/Viewport.hpp"
@@ -30,8 +35,13 @@
 #include "UI/Components/Properties/SceneProps.hpp"
 
 #include <array>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <glad/glad.h>
 #include <glm/vec3.hpp>
@@ -43,20 +53,27 @@ class DirectionalLight;
 class MainFrameComponent : public IComponent {
 public:
     MainFrameComponent();
+    virtual ~MainFrameComponent();
 
     DECLARE_GETTER_MUTABLE(viewport, ViewportComponent)
 
     sigslot::signal<> exited;
     sigslot::signal<int> themeChanged;
 
+    // The model's geometry was destroyed, because it was closed or replaced.
+    sigslot::signal<> modelUnloaded;
+
     struct DataModel : public IComponent::DataModel {
         glm::vec3* m_pAmbientColor = nullptr;
         glm::vec4* m_pClearColor = nullptr;
         float* m_pAmbientIntensity = nullptr;
+        int* m_pLodLock = nullptr; // Negative when levels of detail are picked by screen size.
 
         Mesh* m_pMesh = nullptr;
         std::filesystem::path m_modelPath;
         std::unordered_multimap<Texture::Type, std::filesystem::path> m_texturePaths;
+        std::vector<ModelLoader::StageTiming> m_importTimings;
+        std::optional<MeshOptimizer::Report> m_vertexCache;
 
         LambertianMaterial* m_pLambertianMat = nullptr;
         PhongMaterial* m_pPhongMat = nullptr;
@@ -64,6 +81,13 @@ public:
 
         std::array<DirectionalLight*, 3> m_lights;
         int* m_pWindowTheme = nullptr;
+        int* m_pImportProfile = nullptr;
+        bool* m_pCompactVertices = nullptr;
+        bool* m_pGpuResidentGeometry = nullptr;
+        int* m_pVertexLayout = nullptr;
+        int* m_pTextureBudget = nullptr; // MiB
+
+        TextureCache* m_pTextureCache = nullptr;
     };
 
 private:
@@ -74,11 +98,41 @@ private:
     void OnSceneNodeSelected(SceneTreeComponent::SceneNode node);
     void OnMaterialSelected(int materialIndex);
     void OnModelSelected(const std::filesystem::path& modelPath);
+    void OnModelLoaded(const std::filesystem::path& modelPath, ModelLoader::ModelProperties&& modelProperties);
+    void OnModelImportCanceled();
+    void pollModelImport();
+    void pollGeometryReload();
+    void cancelGeometryReload();
     void OnModelClosed();
+    void OnVertexLayoutChanged(int layout);
     void OnLightStatusChanged(std::uint8_t lightIndex, bool enabled);
 
     DataModel m_model;
 
+    // Declared ahead of the import, which asks the cache what it can skip from a worker thread.
+    TextureUploader m_textureUploader;
+    TextureCache m_textureCache{ m_textureUploader };
+
+    // Model import. Runs in the background, the finished model is swapped in on the render thread.
+
+    struct ImportState {
+        std::atomic<float> m_progress = 0.f;
+        std::atomic<bool> m_canceled = false;
+    };
+
+    ModelLoader m_modelLoader;
+    std::filesystem::path m_pendingModelPath;
+    std::future<ModelLoader::ModelProperties> m_pendingModel;
+    std::shared_ptr<ImportState> m_pImportState;
+
+    // Canceled imports that are still winding down. Kept so their futures don't block when destroyed.
+    std::vector<std::future<ModelLoader::ModelProperties>> m_canceledImports;
+
+    // Reload of the current model's released geometry, with the settings it was imported with.
+    ModelLoader m_geometryLoader;
+    std::future<ModelLoader::ModelProperties> m_pendingGeometry;
+    std::shared_ptr<ImportState> m_pGeometryState;
+
     // Properties components
 
     PropertiesComponent m_properties;
@@ -103,4 +157,5 @@ private:
     // Modal
 
     FileExplorer m_fileExplorer;
+    ImportProgress m_importProgress;
 };
@@ -22,6 +22,49 @@ void MainMenuComponent::render() {
 
             ImGui::Separator();
 
+            if (ImGui::BeginMenu("Import Profile")) {
+
+                if (ImGui::RadioButton("Fast Preview", &m_model.m_selectedImportProfile, 0))
+                    importProfileChanged(0);
+
+                if (ImGui::RadioButton("Balanced", &m_model.m_selectedImportProfile, 1))
+                    importProfileChanged(1);
+
+                if (ImGui::RadioButton("Full Quality", &m_model.m_selectedImportProfile, 2))
+                    importProfileChanged(2);
+
+                ImGui::Separator();
+
+                if (ImGui::MenuItem("Compact Vertices", nullptr, &m_model.m_compactVertices))
+                    compactVerticesChanged(m_model.m_compactVertices);
+
+                if (ImGui::MenuItem("GPU Resident Geometry", nullptr, &m_model.m_gpuResidentGeometry))
+                    gpuResidentGeometryChanged(m_model.m_gpuResidentGeometry);
+
+                ImGui::EndMenu();
+            }
+
+            if (ImGui::BeginMenu("Vertex Layout")) {
+
+                if (ImGui::RadioButton("Planar", &m_model.m_selectedVertexLayout, 0))
+                    vertexLayoutChanged(0);
+
+                if (ImGui::RadioButton("Interleaved", &m_model.m_selectedVertexLayout, 1))
+                    vertexLayoutChanged(1);
+
+                ImGui::EndMenu();
+            }
+
+            if (ImGui::BeginMenu("Texture Memory")) {
+
+                if (ImGui::SliderInt("Budget (MiB)", &m_model.m_textureBudget, 256, 16384, "%d", ImGuiSliderFlags_AlwaysClamp))
+                    textureBudgetChanged(m_model.m_textureBudget);
+
+                ImGui::EndMenu();
+            }
+
+            ImGui::Separator();
+
             if (ImGui::MenuItem("Exit"))
                 exited();
 
@@ -68,6 +111,15 @@ void MainMenuComponent::render() {
             ImGui::EndMenu();
         }
 #endif
+        // Resident texture memory, right aligned in the menu bar.
+        if (m_model.m_pTextureCache) {
+
+            const std::string usage = std::format("Textures: {} / {} MiB", m_model.m_pTextureCache->residentSize() >> 20, m_model.m_textureBudget);
+
+            ImGui::SameLine(ImGui::GetWindowWidth() - ImGui::CalcTextSize(usage.c_str()).x - ImGui::GetStyle().ItemSpacing.x * 2);
+            ImGui::TextDisabled("%s", usage.c_str());
+        }
+
         ImGui::EndMainMenuBar();
     }
 
@@ -86,4 +138,21 @@ void MainMenuComponent::syncFrom(const IComponent::DataModel* pFrom) {
 
     m_model.m_modelLoaded = !pModel->m_pMesh->model()->empty();
     m_model.m_selectedTheme = *pModel->m_pWindowTheme;
+
+    if (pModel->m_pImportProfile)
+        m_model.m_selectedImportProfile = *pModel->m_pImportProfile;
+
+    if (pModel->m_pCompactVertices)
+        m_model.m_compactVertices = *pModel->m_pCompactVertices;
+
+    if (pModel->m_pGpuResidentGeometry)
+        m_model.m_gpuResidentGeometry = *pModel->m_pGpuResidentGeometry;
+
+    if (pModel->m_pVertexLayout)
+        m_model.m_selectedVertexLayout = *pModel->m_pVertexLayout;
+
+    if (pModel->m_pTextureBudget)
+        m_model.m_textureBudget = *pModel->m_pTextureBudget;
+
+    m_model.m_pTextureCache = pModel->m_pTextureCache;
 }
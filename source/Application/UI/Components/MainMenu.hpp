@@ -5,6 +5,8 @@
 
 #include <sigslot/signal.hpp>
 
+class TextureCache;
+
 class MainMenuComponent : public IComponent {
 public:
     sigslot::signal<> modelClosed;
@@ -13,10 +15,21 @@ public:
     sigslot::signal<> modelPropertiesOpened;
     sigslot::signal<> lightPropertiesOpened;
     sigslot::signal<int> themeChanged;
+    sigslot::signal<int> importProfileChanged;
+    sigslot::signal<bool> compactVerticesChanged;
+    sigslot::signal<bool> gpuResidentGeometryChanged;
+    sigslot::signal<int> vertexLayoutChanged;
+    sigslot::signal<int> textureBudgetChanged;
 
     struct DataModel : public IComponent::DataModel {
         bool m_modelLoaded = false;
         int m_selectedTheme = 0;
+        int m_selectedImportProfile = 0;
+        bool m_compactVertices = false;
+        bool m_gpuResidentGeometry = false;
+        int m_selectedVertexLayout = 1;
+        int m_textureBudget = 1024; // MiB
+        const TextureCache* m_pTextureCache = nullptr;
     };
 
 #ifdef MV_DEBUG
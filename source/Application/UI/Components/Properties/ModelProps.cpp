@@ -8,6 +8,8 @@
 
 #include "UI/Components/MainFrame.hpp"
 
+#include <algorithm>
+
 #include <imgui.h>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -38,6 +40,33 @@ void ModelProps::render() {
         ImGui::EndTable();
     }
 
+    if (!m_model.m_importTimings.empty() && ImGui::CollapsingHeader("Import")) {
+
+        float totalMilliseconds = 0.f;
+        for (const ModelLoader::StageTiming& timing : m_model.m_importTimings) {
+            ImGui::LabelText(timing.name.c_str(), "%.2f ms", timing.milliseconds);
+            totalMilliseconds += timing.milliseconds;
+        }
+
+        ImGui::Separator();
+        ImGui::LabelText("Total", "%.2f ms", totalMilliseconds);
+
+        if (m_model.m_vertexCache) {
+            ImGui::Separator();
+            ImGui::LabelText("ACMR", "%.3f -> %.3f", m_model.m_vertexCache->before.acmr(), m_model.m_vertexCache->after.acmr());
+            ImGui::LabelText("ATVR", "%.3f -> %.3f", m_model.m_vertexCache->before.atvr(), m_model.m_vertexCache->after.atvr());
+        }
+    }
+
+    if (m_model.m_lodCount > 0 && ImGui::CollapsingHeader("Level of Detail")) {
+
+        ImGui::LabelText("Levels", "%d", m_model.m_lodCount);
+
+        // Level 0 is the full mesh, meshes with fewer levels show their coarsest.
+        if (ImGui::SliderInt("Lock", &m_model.m_lodLock, -1, m_model.m_lodCount, m_model.m_lodLock < 0 ? "Automatic" : "%d", ImGuiSliderFlags_AlwaysClamp))
+            lodLockChanged(m_model.m_lodLock);
+    }
+
     ImGui::SetNextItemOpen(true, ImGuiCond_Once);
     if (ImGui::CollapsingHeader("Transform")) {
         if (ImGui::SliderFloat("Scale", &m_model.m_scale, 0.001f, 20.f))
@@ -114,6 +143,15 @@ void ModelProps::syncFrom(const IComponent::DataModel* pFrom) {
     m_model.m_origin = pModel->m_pMesh->position();
     m_model.m_metadata.faceCount = pModel->m_pMesh->faceCount();
     m_model.m_metadata.vertexCount = pModel->m_pMesh->vertexCount();
+    m_model.m_importTimings = pModel->m_importTimings;
+    m_model.m_vertexCache = pModel->m_vertexCache;
+    m_model.m_lodLock = pModel->m_pLodLock ? *pModel->m_pLodLock : -1;
+
+    m_model.m_lodCount = 0;
+    if (const std::vector<VertexBuffered>* pGeometry = pModel->m_pMesh->model(); pGeometry) {
+        for (const VertexBuffered& geometry : *pGeometry)
+            m_model.m_lodCount = std::max(m_model.m_lodCount, static_cast<int>(geometry.lods().size()));
+    }
 
     m_model.m_metadata.attributes.at(ModelMetadata::Color) = pModel->m_pMesh->hasColors();
     m_model.m_metadata.attributes.at(ModelMetadata::Index) = pModel->m_pMesh->hasIndices();
@@ -6,7 +6,11 @@
 #include "UI/Components/Properties/PhongProps.hpp"
 #include "UI/Components/Properties/PhongTexturedProps.hpp"
 
+#include "IO/ModelLoader.hpp"
+
 #include <array>
+#include <optional>
+#include <vector>
 
 #include <glm/vec3.hpp>
 #include <sigslot/signal.hpp>
@@ -21,6 +25,7 @@ public:
     sigslot::signal<float> yawChanged;
     sigslot::signal<float> rollChanged;
     sigslot::signal<int> materialSelected;
+    sigslot::signal<int> lodLockChanged;
 
     struct ModelMetadata {
         enum Attribute {
@@ -43,6 +48,11 @@ public:
         glm::vec3 m_origin;
 
         ModelMetadata m_metadata;
+        std::vector<ModelLoader::StageTiming> m_importTimings;
+        std::optional<MeshOptimizer::Report> m_vertexCache;
+
+        int m_lodCount;
+        int m_lodLock;
 
         int m_selectedMaterial;
         static const std::array<const char*, 3> m_kMaterialNames;
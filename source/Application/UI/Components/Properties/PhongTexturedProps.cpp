@@ -1,8 +1,8 @@
 #include "UI/Components/Properties/PhongTexturedProps.hpp"
 
-#include "IO/TextureLoader.hpp"
 #include "Material/PhongTexturedMaterial.hpp"
 #include "Texture/Texture.hpp"
+#include "Texture/TextureHandle.hpp"
 #include "UI/Components/MainFrame.hpp"
 
 #include <filesystem>
@@ -44,27 +44,25 @@ void RenderTextureManipulator(ImTextureID textureId, const char* sectionLabel, T
 
 PhongTexturedProps::PhongTexturedProps() {
 
-    m_diffuseTextureImporter.accepted.connect([this](const Texture& texture) {
-        diffuseMapLoaded(texture);
-        m_model.m_diffuseTextureId = texture.id();
+    // The image buttons pick up the new maps once their uploads finish and the material is synced again.
+    m_diffuseTextureImporter.accepted.connect([this](const TextureHandle& handle) {
+        diffuseMapLoaded(handle);
     });
     m_diffuseTextureImporter.reset.connect([this] {
         diffuseMapUnloaded();
         m_model.m_diffuseTextureId = 0;
     });
 
-    m_emissiveTextureImporter.accepted.connect([this](const Texture& texture) {
-        emissiveMapLoaded(texture);
-        m_model.m_emissiveTextureId = texture.id();
+    m_emissiveTextureImporter.accepted.connect([this](const TextureHandle& handle) {
+        emissiveMapLoaded(handle);
     });
     m_emissiveTextureImporter.reset.connect([this] {
         emissiveMapUnloaded();
         m_model.m_emissiveTextureId = 0;
     });
 
-    m_specularTextureImporter.accepted.connect([this](const Texture& texture) {
-        specularMapLoaded(texture);
-        m_model.m_specularTextureId = texture.id();
+    m_specularTextureImporter.accepted.connect([this](const TextureHandle& handle) {
+        specularMapLoaded(handle);
     });
     m_specularTextureImporter.reset.connect([this] {
         specularMapUnloaded();
@@ -117,9 +115,12 @@ void PhongTexturedProps::syncFrom(const IComponent::DataModel* pFrom) {
     m_model.m_specularIntensity = pModel->m_pPhongTexturedMat->specularIntensity();
     m_model.m_shininess= pModel->m_pPhongTexturedMat->shininess();
 
-    if (pModel->m_modelPath.has_parent_path()) {
-        const auto SyncTextureImporter = [pModel](Texture::Type type, TextureImporter& importer) {
-            TextureImporter::DataModel model;
+    // The maps themselves are attached by the model import, the importers only show where they came from.
+    const auto SyncTextureImporter = [pModel](Texture::Type type, TextureImporter& importer) {
+        TextureImporter::DataModel model = *static_cast<const TextureImporter::DataModel*>(static_cast<IComponent&>(importer).dataModel());
+        model.pTextureCache = pModel->m_pTextureCache;
+
+        if (pModel->m_modelPath.has_parent_path()) {
             model.workingDirectory = pModel->m_modelPath.parent_path();
 
             if (pModel->m_texturePaths.contains(type)) {
@@ -130,26 +131,14 @@ void PhongTexturedProps::syncFrom(const IComponent::DataModel* pFrom) {
             }
             else
                 model.selectedTexturePath = "";
+        }
 
-            static_cast<IComponent&>(importer).syncFrom(&model);
-
-            std::optional<std::filesystem::path> ret;
-            if (!model.selectedTexturePath.empty())
-                ret.emplace(model.selectedTexturePath);
-
-            return ret;
-        };
+        static_cast<IComponent&>(importer).syncFrom(&model);
+    };
 
-        static TextureLoader loader;
-        if (const auto path = SyncTextureImporter(Texture::Type::Diffuse, m_diffuseTextureImporter); path)
-            diffuseMapLoaded(loader.load(*path, Texture::Target::Texture2D));
-
-        if (const auto path = SyncTextureImporter(Texture::Type::Emissive, m_emissiveTextureImporter); path)
-            emissiveMapLoaded(loader.load(*path, Texture::Target::Texture2D));
-
-        if (const auto path = SyncTextureImporter(Texture::Type::Specular, m_specularTextureImporter); path)
-            specularMapLoaded(loader.load(*path, Texture::Target::Texture2D));
-    }
+    SyncTextureImporter(Texture::Type::Diffuse, m_diffuseTextureImporter);
+    SyncTextureImporter(Texture::Type::Emissive, m_emissiveTextureImporter);
+    SyncTextureImporter(Texture::Type::Specular, m_specularTextureImporter);
 
     // Update the texture image buttons with loaded textures.
     if (const auto& texture = pModel->m_pPhongTexturedMat->diffuseMap(); texture.has_value())
@@ -11,16 +11,16 @@
 #include <sigslot/signal.hpp>
 
 class PhongTexturedMaterial;
-class Texture;
+class TextureHandle;
 
 class PhongTexturedProps : public IComponent {
 public:
     PhongTexturedProps();
     virtual ~PhongTexturedProps() = default;
 
-    sigslot::signal<const Texture&> diffuseMapLoaded;
-    sigslot::signal<const Texture&> emissiveMapLoaded;
-    sigslot::signal<const Texture&> specularMapLoaded;
+    sigslot::signal<const TextureHandle&> diffuseMapLoaded;
+    sigslot::signal<const TextureHandle&> emissiveMapLoaded;
+    sigslot::signal<const TextureHandle&> specularMapLoaded;
     sigslot::signal<> diffuseMapUnloaded;
     sigslot::signal<> emissiveMapUnloaded;
     sigslot::signal<> specularMapUnloaded;
@@ -2,7 +2,7 @@
 #include "UI/Icons.hpp"
 #include "UI/Utility.hpp"
 
-#include "IO/TextureLoader.hpp"
+#include "IO/TextureCache.hpp"
 
 #include <algorithm>
 #include <ranges>
@@ -62,11 +62,10 @@ void TextureImporter::render() {
 
         ImGui::SameLine();
 
-        ImGui::BeginDisabled(m_dataModel.selectedTexturePath.empty());
+        ImGui::BeginDisabled(m_dataModel.selectedTexturePath.empty() || !m_dataModel.pTextureCache);
         if (ImGui::Button("Import##TextureImporter", { 75, ImGui::GetFrameHeight() })) {
 
-            const Texture texture = TextureLoader::load(m_dataModel.selectedTexturePath, Texture::Target::Texture2D, m_flipUVs);
-            accepted(texture);
+            accepted(m_dataModel.pTextureCache->load(m_dataModel.selectedTexturePath, Texture::Target::Texture2D, m_flipUVs));
 
             ImGui::CloseCurrentPopup();
         }
@@ -9,13 +9,14 @@
 
 #include <sigslot/signal.hpp>
 
-class Texture;
+class TextureHandle;
+class TextureCache;
 
 class TextureImporter : public IComponent {
 public:
     static constexpr const char* kWindowId = "Texture Importer";
 
-    sigslot::signal<const Texture&> accepted;
+    sigslot::signal<const TextureHandle&> accepted;
     sigslot::signal<> canceled;
     sigslot::signal<> reset;
 
@@ -25,6 +26,7 @@ public:
     struct DataModel : public IComponent::DataModel {
         std::filesystem::path workingDirectory = std::filesystem::current_path();
         std::filesystem::path selectedTexturePath;
+        TextureCache* pTextureCache = nullptr;
     };
 
 private:
@@ -1,29 +1,32 @@
 #include "Common/Math.hpp"
 #include "Common/Constants.hpp"
 
+#include "Geometry/MeshInstance.hpp"
 #include "Geometry/VertexBuffered.hpp"
 
-glm::vec3 ComputeCenter(const std::forward_list<VertexBuffered>* pModel) {
+#include <limits>
+
+glm::vec3 ComputeCenter(const std::vector<VertexBuffered>* pModel, const std::vector<MeshInstance>* pInstances) {
 
     glm::vec3 aabbCenter{ 0.f };
     if (!pModel)
         return aabbCenter;
 
     // Compute the bounding box around the model.
-    const auto [min, max] = ComputeAABB(pModel);
+    const auto [min, max] = ComputeAABB(pModel, pInstances);
     aabbCenter = (min + max) / 2.f;
 
     return aabbCenter;
 }
 
-float ComputeScale(const std::forward_list<VertexBuffered>* pModel, const glm::vec3 maxSize) {
+float ComputeScale(const std::vector<VertexBuffered>* pModel, const glm::vec3 maxSize, const std::vector<MeshInstance>* pInstances) {
 
     if (!pModel || (maxSize.x <= 0.f || maxSize.y <= 0.f || maxSize.z <= 0.f)) {
         assert(false);
         return 1.f;
     }
 
-    const auto [min, max] = ComputeAABB(pModel);
+    const auto [min, max] = ComputeAABB(pModel, pInstances);
 
     const float width = max.x - min.x;
     const float length = max.z - min.z;
@@ -38,26 +41,74 @@ float ComputeScale(const std::forward_list<VertexBuffered>* pModel, const glm::v
     return std::max(1.f / maxDelta, kMinScale);
 }
 
-std::pair<glm::vec3, glm::vec3> ComputeAABB(const std::forward_list<VertexBuffered>* pModel) {
+std::pair<glm::vec3, glm::vec3> ComputeAABB(const VertexBuffered& buffer) {
+
+    glm::vec3 min{ std::numeric_limits<float>::max() };
+    glm::vec3 max{ std::numeric_limits<float>::lowest() };
+
+    // Released geometry only has the bounds it kept.
+    if (buffer.released()) {
+        const VertexBounds& bounds = buffer.bounds();
+        return { bounds.min, bounds.min + bounds.extent };
+    }
+
+    const auto vertices = buffer.vertices();
+    if (!vertices)
+        return { min, max };
+
+    for (const glm::vec3& vertex : *vertices) {
+        min = glm::min(min, vertex);
+        max = glm::max(max, vertex);
+    }
+
+    return { min, max };
+}
+
+std::pair<glm::vec3, glm::vec3> ComputeAABB(const std::vector<VertexBuffered>* pModel, const std::vector<MeshInstance>* pInstances) {
     
     glm::vec3 min{ std::numeric_limits<float>::max() };
     glm::vec3 max{ std::numeric_limits<float>::lowest() };
 
-    for (const VertexBuffered& buffer : *pModel) {
+    if (!pModel)
+        return { min, max };
+
+    std::vector<std::pair<glm::vec3, glm::vec3>> meshBounds;
+    meshBounds.reserve(pModel->size());
+
+    for (const VertexBuffered& buffer : *pModel)
+        meshBounds.push_back(ComputeAABB(buffer));
+
+    if (!pInstances || pInstances->empty()) {
+
+        for (const auto& [meshMin, meshMax] : meshBounds) {
+            min = glm::min(min, meshMin);
+            max = glm::max(max, meshMax);
+        }
+
+        return { min, max };
+    }
+
+    // Place each mesh's bounds once per instance, transforming the corners of the box.
+    for (const MeshInstance& instance : *pInstances) {
+
+        if (instance.meshIndex >= meshBounds.size())
+            continue;
 
-        const auto& vertices = buffer.vertices();
-        if (!vertices)
+        const auto& [meshMin, meshMax] = meshBounds[instance.meshIndex];
+        if (meshMin.x > meshMax.x)
             continue;
 
-        for (const glm::vec3& vertex : *vertices) {
+        for (int corner = 0; corner < 8; ++corner) {
 
-            min.x = std::min(min.x, vertex.x);
-            min.y = std::min(min.y, vertex.y);
-            min.z = std::min(min.z, vertex.z);
+            const glm::vec3 point{
+                corner & 1 ? meshMax.x : meshMin.x,
+                corner & 2 ? meshMax.y : meshMin.y,
+                corner & 4 ? meshMax.z : meshMin.z
+            };
 
-            max.x = std::max(max.x, vertex.x);
-            max.y = std::max(max.y, vertex.y);
-            max.z = std::max(max.z, vertex.z);
+            const glm::vec3 placed = glm::vec3{ instance.transform * glm::vec4{ point, 1.f } };
+            min = glm::min(min, placed);
+            max = glm::max(max, placed);
         }
     }
 
@@ -0,0 +1,135 @@
+#include "Common/ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+struct ThreadPool::Private {
+    explicit Private(std::size_t workerCount);
+    ~Private();
+
+    COPY_MOVE_DISABLED(Private)
+
+    void work();
+
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_tasks;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+};
+
+ThreadPool::Private::Private(std::size_t workerCount) {
+
+    if (workerCount == 0)
+        workerCount = DefaultWorkerCount();
+
+    m_workers.reserve(workerCount);
+    for (std::size_t index = 0; index < workerCount; ++index)
+        m_workers.emplace_back(&Private::work, this);
+}
+
+ThreadPool::Private::~Private() {
+
+    {
+        std::scoped_lock lock{ m_mutex };
+        m_stopping = true;
+    }
+
+    m_condition.notify_all();
+
+    for (std::thread& worker : m_workers)
+        worker.join();
+}
+
+void ThreadPool::Private::work() {
+
+    while (true) {
+
+        std::function<void()> task;
+
+        {
+            std::unique_lock lock{ m_mutex };
+            m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+
+            // Drain what is left before shutting down, callers may still be waiting on futures.
+            if (m_tasks.empty())
+                return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+
+        task();
+    }
+}
+
+
+std::size_t ThreadPool::DefaultWorkerCount() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+ThreadPool::ThreadPool(std::size_t workerCount)
+    : m_pPrivate(std::make_unique<Private>(workerCount)) {}
+
+ThreadPool::~ThreadPool() noexcept {}
+
+void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t)>& function) {
+
+    if (count == 0)
+        return;
+
+    // Shared so helpers that only get scheduled after the loop finished can still look at it safely.
+    struct State {
+        std::function<void(std::size_t)> function;
+        std::size_t count = 0;
+        std::atomic<std::size_t> next = 0;
+        std::atomic<std::size_t> finished = 0;
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+
+    auto pState = std::make_shared<State>();
+    pState->function = function;
+    pState->count = count;
+
+    const auto runIndices = [](State& state) {
+
+        std::size_t ran = 0;
+        for (std::size_t index = state.next++; index < state.count; index = state.next++) {
+            state.function(index);
+            ++ran;
+        }
+
+        if (ran > 0 && state.finished.fetch_add(ran) + ran == state.count) {
+            std::scoped_lock lock{ state.mutex };
+            state.condition.notify_all();
+        }
+    };
+
+    const std::size_t helperCount = std::min(count - 1, m_pPrivate->m_workers.size());
+    for (std::size_t helper = 0; helper < helperCount; ++helper)
+        enqueue([pState, runIndices]() { runIndices(*pState); });
+
+    runIndices(*pState);
+
+    std::unique_lock lock{ pState->mutex };
+    pState->condition.wait(lock, [&state = *pState]() { return state.finished == state.count; });
+}
+
+DEFINE_GETTER_IMMUTABLE_COPY(ThreadPool, workerCount, std::size_t, m_pPrivate->m_workers.size())
+
+void ThreadPool::enqueue(std::function<void()> task) {
+
+    {
+        std::scoped_lock lock{ m_pPrivate->m_mutex };
+        m_pPrivate->m_tasks.push(std::move(task));
+    }
+
+    m_pPrivate->m_condition.notify_one();
+}
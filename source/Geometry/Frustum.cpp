@@ -0,0 +1,33 @@
+#include "Geometry/Frustum.hpp"
+
+#include <glm/geometric.hpp>
+
+Frustum::Frustum(const glm::mat4& matrix) {
+
+    const auto Row = [&matrix](int row) { return glm::vec4{ matrix[0][row], matrix[1][row], matrix[2][row], matrix[3][row] }; };
+
+    // Left, right, bottom, top, near and far, for clip space depth in [-w, w].
+    m_planes = {
+        Row(3) + Row(0), Row(3) - Row(0),
+        Row(3) + Row(1), Row(3) - Row(1),
+        Row(3) + Row(2), Row(3) - Row(2)
+    };
+
+    // Normalized, so plane distances are in the same units as the radius.
+    for (glm::vec4& plane : m_planes) {
+
+        const float length = glm::length(glm::vec3{ plane });
+        if (length > 0.f)
+            plane /= length;
+    }
+}
+
+bool Frustum::intersects(const glm::vec3& center, float radius) const {
+
+    for (const glm::vec4& plane : m_planes) {
+        if (glm::dot(glm::vec3{ plane }, center) + plane.w < -radius)
+            return false;
+    }
+
+    return true;
+}
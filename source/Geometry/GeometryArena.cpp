@@ -0,0 +1,200 @@
+#include "Geometry/GeometryArena.hpp"
+
+#include "RangeAllocator.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+// Index data is handed out in words, so ranges of 16 and 32 bit indices both stay aligned.
+constexpr std::size_t kIndexWord = 4;
+
+// Buffers start at this size, in bytes, and grow by half again whenever they run out.
+constexpr std::size_t kMinimumCapacity = std::size_t{ 1 } << 20;
+} // end unnamed namespace
+
+struct GeometryArena::Private {
+    // One of the arena's buffers and the ranges handed out of it.
+    struct Region {
+        std::size_t unit = 1; // Bytes per allocator unit.
+        Allocation::Range Allocation::* pRange = nullptr;
+        GLuint bufferId = 0;
+        RangeAllocator ranges;
+    };
+
+    Private(std::size_t stride, AttributeSetup attributeSetup);
+    ~Private();
+
+    COPY_MOVE_DISABLED(Private)
+
+    std::optional<std::size_t> allocate(Region& region, std::size_t size, bool& repacked);
+
+    // Moves the live ranges of the region to the front of a new buffer, with room for at least the given units after.
+    void repack(Region& region, std::size_t extra);
+
+    // Points the vertex array at the current buffers.
+    void bind() const;
+
+    void release(Allocation& allocation);
+
+    GLuint m_vertexArrayId = 0;
+    Region m_vertices;
+    Region m_indices;
+    AttributeSetup m_attributeSetup;
+
+    std::unordered_set<Allocation*> m_allocations;
+};
+
+GeometryArena::Private::Private(std::size_t stride, AttributeSetup attributeSetup)
+    : m_attributeSetup(std::move(attributeSetup)) {
+
+    m_vertices.unit = stride;
+    m_vertices.pRange = &Allocation::m_vertices;
+
+    m_indices.unit = kIndexWord;
+    m_indices.pRange = &Allocation::m_indices;
+
+    glGenVertexArrays(1, &m_vertexArrayId);
+}
+
+GeometryArena::Private::~Private() {
+
+    if (m_vertexArrayId)
+        glDeleteVertexArrays(1, &m_vertexArrayId);
+
+    if (m_vertices.bufferId)
+        glDeleteBuffers(1, &m_vertices.bufferId);
+
+    if (m_indices.bufferId)
+        glDeleteBuffers(1, &m_indices.bufferId);
+}
+
+std::optional<std::size_t> GeometryArena::Private::allocate(Region& region, std::size_t size, bool& repacked) {
+
+    std::optional<std::size_t> offset = region.ranges.allocate(size);
+    if (offset)
+        return offset;
+
+    repack(region, size);
+    repacked = true;
+
+    return region.ranges.allocate(size);
+}
+
+void GeometryArena::Private::repack(Region& region, std::size_t extra) {
+
+    const std::size_t required = region.ranges.used() + extra;
+
+    std::size_t capacity = region.ranges.capacity();
+    if (required > capacity)
+        capacity = std::max(required + required / 2, kMinimumCapacity / region.unit);
+
+    GLuint bufferId = 0;
+    glGenBuffers(1, &bufferId);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, bufferId);
+    glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(capacity * region.unit), nullptr, GL_STATIC_DRAW);
+
+    // Keep the ranges in the order they had, meshes that were loaded together stay together.
+    std::vector<Allocation*> allocations{ m_allocations.cbegin(), m_allocations.cend() };
+    std::ranges::sort(allocations, {}, [&region](const Allocation* pAllocation) { return (pAllocation->*region.pRange).offset; });
+
+    glBindBuffer(GL_COPY_READ_BUFFER, region.bufferId);
+
+    std::size_t end = 0;
+    for (Allocation* pAllocation : allocations) {
+
+        Allocation::Range& range = pAllocation->*region.pRange;
+        if (region.bufferId && range.size > 0) {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                static_cast<GLintptr>(range.offset * region.unit),
+                static_cast<GLintptr>(end * region.unit),
+                static_cast<GLsizeiptr>(range.size * region.unit));
+        }
+
+        range.offset = end;
+        end += range.size;
+    }
+
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    if (region.bufferId)
+        glDeleteBuffers(1, &region.bufferId);
+
+    region.bufferId = bufferId;
+    region.ranges.reset(end, capacity);
+}
+
+void GeometryArena::Private::bind() const {
+
+    // The element buffer binding is part of the vertex array, the array buffer is captured by the attribute pointers.
+    glBindVertexArray(m_vertexArrayId);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indices.bufferId);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertices.bufferId);
+
+    if (m_attributeSetup)
+        m_attributeSetup();
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GeometryArena::Private::release(Allocation& allocation) {
+
+    m_vertices.ranges.free(allocation.m_vertices.offset, allocation.m_vertices.size);
+    m_indices.ranges.free(allocation.m_indices.offset, allocation.m_indices.size);
+    m_allocations.erase(&allocation);
+}
+
+GeometryArena::Allocation::~Allocation() {
+    m_pArena->release(*this);
+}
+
+DEFINE_GETTER_IMMUTABLE_COPY(GeometryArena::Allocation, baseVertex, std::size_t, m_vertices.offset)
+DEFINE_GETTER_IMMUTABLE_COPY(GeometryArena::Allocation, vertexCount, std::size_t, m_vertices.size)
+DEFINE_GETTER_IMMUTABLE_COPY(GeometryArena::Allocation, indexOffset, std::size_t, m_indices.offset * kIndexWord)
+DEFINE_GETTER_IMMUTABLE_COPY(GeometryArena::Allocation, indexSize, std::size_t, m_indices.size * kIndexWord)
+
+DEFINE_GETTER_IMMUTABLE_COPY(GeometryArena::Allocation, stride, std::size_t, m_pArena->m_vertices.unit)
+DEFINE_GETTER_IMMUTABLE_COPY(GeometryArena::Allocation, vertexArrayId, GLuint, m_pArena->m_vertexArrayId)
+DEFINE_GETTER_IMMUTABLE_COPY(GeometryArena::Allocation, vertexBufferId, GLuint, m_pArena->m_vertices.bufferId)
+DEFINE_GETTER_IMMUTABLE_COPY(GeometryArena::Allocation, indexBufferId, GLuint, m_pArena->m_indices.bufferId)
+
+GeometryArena::GeometryArena(std::size_t stride, AttributeSetup attributeSetup)
+    : m_pPrivate(std::make_shared<Private>(stride, std::move(attributeSetup))) {}
+
+GeometryArena::~GeometryArena() {}
+
+std::shared_ptr<GeometryArena::Allocation> GeometryArena::allocate(std::size_t vertexCount, std::size_t indexSize) {
+
+    Private& arena = *m_pPrivate;
+    const std::size_t indexWords = (indexSize + kIndexWord - 1) / kIndexWord;
+
+    bool repacked = false;
+    const std::optional<std::size_t> baseVertex = arena.allocate(arena.m_vertices, vertexCount, repacked);
+    const std::optional<std::size_t> indexOffset = arena.allocate(arena.m_indices, indexWords, repacked);
+
+    if (repacked)
+        arena.bind();
+
+    std::shared_ptr<Allocation> pAllocation{ new Allocation };
+    pAllocation->m_pArena = m_pPrivate;
+    pAllocation->m_vertices = { baseVertex.value(), vertexCount };
+    pAllocation->m_indices = { indexOffset.value(), indexWords };
+
+    arena.m_allocations.insert(pAllocation.get());
+    return pAllocation;
+}
+
+DEFINE_GETTER_IMMUTABLE_COPY(GeometryArena, stride, std::size_t, m_pPrivate->m_vertices.unit)
+DEFINE_GETTER_IMMUTABLE_COPY(GeometryArena, vertexArrayId, GLuint, m_pPrivate->m_vertexArrayId)
+
+std::size_t GeometryArena::capacity() const {
+    return m_pPrivate->m_vertices.ranges.capacity() * m_pPrivate->m_vertices.unit + m_pPrivate->m_indices.ranges.capacity() * kIndexWord;
+}
+
+std::size_t GeometryArena::used() const {
+    return m_pPrivate->m_vertices.ranges.used() * m_pPrivate->m_vertices.unit + m_pPrivate->m_indices.ranges.used() * kIndexWord;
+}
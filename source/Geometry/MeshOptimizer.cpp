@@ -0,0 +1,390 @@
+#include "Geometry/MeshOptimizer.hpp"
+
+#include "Geometry/VertexBuffer.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include <glm/geometric.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+namespace {
+constexpr std::uint32_t kNone = std::numeric_limits<std::uint32_t>::max();
+
+// FIFO post-transform cache. A vertex stays cached until cacheSize others were transformed after it.
+class CacheSimulator {
+public:
+    CacheSimulator(std::size_t vertexCount, std::size_t cacheSize)
+        : m_stamps(vertexCount, 0), m_cacheSize(cacheSize), m_time(cacheSize + 1) {}
+
+    // Returns true when the vertex had to be transformed.
+    bool access(std::uint32_t vertex) {
+
+        if (cached(vertex))
+            return false;
+
+        m_stamps[vertex] = m_time++;
+        return true;
+    }
+
+    unsigned int triangle(const std::uint32_t* pTriangle) {
+        return static_cast<unsigned int>(access(pTriangle[0])) + access(pTriangle[1]) + access(pTriangle[2]);
+    }
+
+    bool cached(std::uint32_t vertex) const { return age(vertex) <= m_cacheSize; }
+
+    // Transforms since the vertex entered the cache.
+    std::size_t age(std::uint32_t vertex) const { return m_time - m_stamps[vertex]; }
+
+    void flush() { m_time += m_cacheSize + 1; }
+
+private:
+    std::vector<std::size_t> m_stamps;
+    std::size_t m_cacheSize = 0;
+    std::size_t m_time = 0;
+};
+
+bool IsTriangleList(std::span<const std::uint32_t> indices, std::size_t vertexCount) {
+    return indices.size() % 3 == 0 && std::ranges::all_of(indices, [vertexCount](std::uint32_t index) { return index < vertexCount; });
+}
+
+template<typename T>
+void Remap(std::pmr::vector<T>& values, const std::vector<std::uint32_t>& remap) {
+
+    if (values.empty())
+        return;
+
+    // Attributes with fewer values than there are vertices are padded, the way they are when interleaved.
+    values.resize(remap.size(), T{ 0.f });
+
+    // Written back in place, so the values stay in the memory the buffer was given.
+    std::vector<T> remapped(values.size());
+    for (std::size_t vertex = 0; vertex < remap.size(); ++vertex)
+        remapped[remap[vertex]] = values[vertex];
+
+    std::ranges::copy(remapped, values.begin());
+}
+} // end unnamed namespace
+
+float MeshOptimizer::Statistics::acmr() const {
+    return triangleCount ? static_cast<float>(transformCount) / static_cast<float>(triangleCount) : 0.f;
+}
+
+float MeshOptimizer::Statistics::atvr() const {
+    return vertexCount ? static_cast<float>(transformCount) / static_cast<float>(vertexCount) : 0.f;
+}
+
+MeshOptimizer::Statistics& MeshOptimizer::Statistics::operator+=(const Statistics& other) {
+
+    triangleCount += other.triangleCount;
+    vertexCount += other.vertexCount;
+    transformCount += other.transformCount;
+    return *this;
+}
+
+MeshOptimizer::Report& MeshOptimizer::Report::operator+=(const Report& other) {
+
+    before += other.before;
+    after += other.after;
+    return *this;
+}
+
+MeshOptimizer::Statistics MeshOptimizer::Analyze(std::span<const std::uint32_t> indices, std::size_t vertexCount, std::size_t cacheSize) {
+
+    Statistics statistics;
+    statistics.triangleCount = indices.size() / 3;
+
+    CacheSimulator cache{ vertexCount, cacheSize };
+    std::vector<bool> referenced(vertexCount, false);
+
+    for (const std::uint32_t index : indices) {
+
+        if (index >= vertexCount)
+            continue;
+
+        statistics.transformCount += cache.access(index);
+
+        if (!referenced[index]) {
+            referenced[index] = true;
+            ++statistics.vertexCount;
+        }
+    }
+
+    return statistics;
+}
+
+MeshOptimizer::Report MeshOptimizer::Optimize(VertexBuffer& buffer, float overdrawThreshold) {
+
+    std::pmr::vector<std::uint32_t>& indices = buffer.indices();
+    const std::size_t vertexCount = buffer.vertices().size();
+
+    Report report;
+    report.before = Analyze(indices, vertexCount);
+
+    if (!IsTriangleList(indices, vertexCount)) {
+        report.after = report.before;
+        return report;
+    }
+
+    OptimizeVertexCache(indices, vertexCount);
+    OptimizeOverdraw(indices, buffer.vertices(), overdrawThreshold);
+    OptimizeVertexFetch(buffer);
+
+    report.after = Analyze(indices, vertexCount);
+    return report;
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::span<std::uint32_t> indices, std::size_t vertexCount, std::size_t cacheSize) {
+
+    if (indices.empty() || !IsTriangleList(indices, vertexCount))
+        return;
+
+    const std::size_t triangleCount = indices.size() / 3;
+
+    // Triangles around each vertex, packed into one array.
+    std::vector<std::uint32_t> offsets(vertexCount + 1, 0);
+    for (const std::uint32_t index : indices)
+        ++offsets[index + 1];
+
+    std::partial_sum(offsets.cbegin(), offsets.cend(), offsets.begin());
+
+    std::vector<std::uint32_t> adjacency(indices.size());
+    {
+        std::vector<std::uint32_t> cursors{ offsets.cbegin(), offsets.cend() - 1 };
+        for (std::size_t index = 0; index < indices.size(); ++index)
+            adjacency[cursors[indices[index]]++] = static_cast<std::uint32_t>(index / 3);
+    }
+
+    // Triangles each vertex still has to be emitted with.
+    std::vector<std::uint32_t> live(vertexCount);
+    for (std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+        live[vertex] = offsets[vertex + 1] - offsets[vertex];
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<std::uint32_t> deadEnds;
+    std::vector<std::uint32_t> candidates;
+
+    std::vector<std::uint32_t> ordered;
+    ordered.reserve(indices.size());
+
+    CacheSimulator cache{ vertexCount, cacheSize };
+    std::size_t cursor = 0;
+
+    // Recently used vertices first, they may still be cached. Otherwise the next vertex in input order.
+    const auto SkipDeadEnd = [&]() {
+
+        while (!deadEnds.empty()) {
+
+            const std::uint32_t vertex = deadEnds.back();
+            deadEnds.pop_back();
+
+            if (live[vertex] > 0)
+                return vertex;
+        }
+
+        for (; cursor < vertexCount; ++cursor) {
+            if (live[cursor] > 0)
+                return static_cast<std::uint32_t>(cursor);
+        }
+
+        return kNone;
+    };
+
+    std::uint32_t fanning = SkipDeadEnd();
+    while (fanning != kNone) {
+
+        candidates.clear();
+
+        for (std::uint32_t slot = offsets[fanning]; slot < offsets[fanning + 1]; ++slot) {
+
+            const std::uint32_t triangle = adjacency[slot];
+            if (emitted[triangle])
+                continue;
+
+            for (std::size_t corner = 0; corner < 3; ++corner) {
+
+                const std::uint32_t vertex = indices[triangle * 3 + corner];
+
+                ordered.push_back(vertex);
+                deadEnds.push_back(vertex);
+                candidates.push_back(vertex);
+
+                --live[vertex];
+                cache.access(vertex);
+            }
+
+            emitted[triangle] = true;
+        }
+
+        // Fan next around the oldest vertex that will still be cached once its remaining triangles are emitted.
+        std::uint32_t next = kNone;
+        std::size_t bestPriority = 0;
+
+        for (const std::uint32_t vertex : candidates) {
+
+            if (live[vertex] == 0)
+                continue;
+
+            std::size_t priority = 0;
+            if (cache.age(vertex) + 2 * live[vertex] <= cacheSize)
+                priority = cache.age(vertex);
+
+            if (next == kNone || priority > bestPriority) {
+                next = vertex;
+                bestPriority = priority;
+            }
+        }
+
+        fanning = next != kNone ? next : SkipDeadEnd();
+    }
+
+    std::ranges::copy(ordered, indices.begin());
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::span<std::uint32_t> indices, std::span<const glm::vec3> vertices, float threshold, std::size_t cacheSize) {
+
+    if (indices.empty() || !IsTriangleList(indices, vertices.size()))
+        return;
+
+    const std::size_t triangleCount = indices.size() / 3;
+
+    // Hard boundaries are where every vertex of a triangle missed, the cache order started over there.
+    std::vector<std::size_t> hardClusters;
+    {
+        CacheSimulator cache{ vertices.size(), cacheSize };
+        for (std::size_t triangle = 0; triangle < triangleCount; ++triangle) {
+            if (cache.triangle(&indices[triangle * 3]) == 3 || triangle == 0)
+                hardClusters.push_back(triangle);
+        }
+    }
+
+    hardClusters.push_back(triangleCount);
+
+    // Split each hard cluster further as soon as the part so far is close enough to the cluster's own ACMR.
+    std::vector<std::size_t> clusters;
+    {
+        CacheSimulator cache{ vertices.size(), cacheSize };
+        for (std::size_t hard = 0; hard + 1 < hardClusters.size(); ++hard) {
+
+            const std::size_t begin = hardClusters[hard];
+            const std::size_t end = hardClusters[hard + 1];
+
+            cache.flush();
+
+            std::size_t clusterMisses = 0;
+            for (std::size_t triangle = begin; triangle < end; ++triangle)
+                clusterMisses += cache.triangle(&indices[triangle * 3]);
+
+            const float clusterAcmr = static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+            cache.flush();
+
+            std::size_t start = begin;
+            std::size_t misses = 0;
+            clusters.push_back(start);
+
+            for (std::size_t triangle = begin; triangle + 1 < end; ++triangle) {
+
+                misses += cache.triangle(&indices[triangle * 3]);
+
+                const float acmr = static_cast<float>(misses) / static_cast<float>(triangle - start + 1);
+                if (acmr <= clusterAcmr * threshold) {
+
+                    start = triangle + 1;
+                    misses = 0;
+                    clusters.push_back(start);
+                    cache.flush();
+                }
+            }
+        }
+    }
+
+    clusters.push_back(triangleCount);
+
+    // Area weighted centroids and normals.
+    glm::vec3 meshCentroid{ 0.f };
+    float meshArea = 0.f;
+
+    std::vector<glm::vec3> centroids(clusters.size() - 1, glm::vec3{ 0.f });
+    std::vector<glm::vec3> normals(clusters.size() - 1, glm::vec3{ 0.f });
+
+    for (std::size_t cluster = 0; cluster + 1 < clusters.size(); ++cluster) {
+
+        float clusterArea = 0.f;
+        for (std::size_t triangle = clusters[cluster]; triangle < clusters[cluster + 1]; ++triangle) {
+
+            const glm::vec3& a = vertices[indices[triangle * 3]];
+            const glm::vec3& b = vertices[indices[triangle * 3 + 1]];
+            const glm::vec3& c = vertices[indices[triangle * 3 + 2]];
+
+            const glm::vec3 normal = glm::cross(b - a, c - a);
+            const float area = glm::length(normal);
+
+            centroids[cluster] += (a + b + c) * (area / 3.f);
+            normals[cluster] += normal;
+            clusterArea += area;
+        }
+
+        meshCentroid += centroids[cluster];
+        meshArea += clusterArea;
+
+        if (clusterArea > 0.f)
+            centroids[cluster] /= clusterArea;
+    }
+
+    if (meshArea > 0.f)
+        meshCentroid /= meshArea;
+
+    // Clusters facing away from the middle of the mesh are most likely to occlude others.
+    std::vector<float> keys(clusters.size() - 1);
+    for (std::size_t cluster = 0; cluster < keys.size(); ++cluster) {
+
+        const float length = glm::length(normals[cluster]);
+        keys[cluster] = length > 0.f ? glm::dot(centroids[cluster] - meshCentroid, normals[cluster] / length) : 0.f;
+    }
+
+    std::vector<std::size_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::stable_sort(order, [&keys](std::size_t first, std::size_t second) { return keys[first] > keys[second]; });
+
+    std::vector<std::uint32_t> ordered;
+    ordered.reserve(indices.size());
+
+    for (const std::size_t cluster : order)
+        ordered.insert(ordered.end(), indices.begin() + clusters[cluster] * 3, indices.begin() + clusters[cluster + 1] * 3);
+
+    std::ranges::copy(ordered, indices.begin());
+}
+
+void MeshOptimizer::OptimizeVertexFetch(VertexBuffer& buffer) {
+
+    const std::size_t vertexCount = buffer.vertices().size();
+    std::pmr::vector<std::uint32_t>& indices = buffer.indices();
+
+    if (!IsTriangleList(indices, vertexCount))
+        return;
+
+    std::vector<std::uint32_t> remap(vertexCount, kNone);
+    std::uint32_t next = 0;
+
+    for (const std::uint32_t index : indices) {
+        if (remap[index] == kNone)
+            remap[index] = next++;
+    }
+
+    // Unreferenced vertices are kept, after the ones in use.
+    for (std::uint32_t& target : remap) {
+        if (target == kNone)
+            target = next++;
+    }
+
+    for (std::uint32_t& index : indices)
+        index = remap[index];
+
+    Remap(buffer.colors(), remap);
+    Remap(buffer.normals(), remap);
+    Remap(buffer.texels(), remap);
+    Remap(buffer.vertices(), remap);
+}
@@ -0,0 +1,162 @@
+#include "Geometry/Meshlet.hpp"
+
+#include "Geometry/Frustum.hpp"
+#include "Geometry/VertexBuffer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+namespace {
+// Normals closer than this to perpendicular with the cone axis make the cone too wide to cull anything.
+constexpr float kMinimumConeDot = .1f;
+
+Meshlet MakeMeshlet(std::span<const std::uint32_t> indices, std::span<const glm::vec3> vertices, std::uint32_t first, std::uint32_t count) {
+
+    Meshlet meshlet;
+    meshlet.indices = { first, count };
+
+    const std::span<const std::uint32_t> triangles = indices.subspan(first, count);
+
+    glm::vec3 minimum{ std::numeric_limits<float>::max() };
+    glm::vec3 maximum{ std::numeric_limits<float>::lowest() };
+    for (const std::uint32_t index : triangles) {
+        minimum = glm::min(minimum, vertices[index]);
+        maximum = glm::max(maximum, vertices[index]);
+    }
+
+    meshlet.center = (minimum + maximum) * .5f;
+    for (const std::uint32_t index : triangles)
+        meshlet.radius = std::max(meshlet.radius, glm::length(vertices[index] - meshlet.center));
+
+    // Degenerate triangles face nowhere and are left out of the cone.
+    struct Face {
+        glm::vec3 point;
+        glm::vec3 normal;
+    };
+
+    std::vector<Face> faces;
+    faces.reserve(triangles.size() / 3);
+
+    glm::vec3 axis{ 0.f };
+    for (std::size_t index = 0; index + 2 < triangles.size(); index += 3) {
+
+        const glm::vec3& a = vertices[triangles[index]];
+        const glm::vec3 normal = glm::cross(vertices[triangles[index + 1]] - a, vertices[triangles[index + 2]] - a);
+
+        const float length = glm::length(normal);
+        if (length <= 0.f)
+            continue;
+
+        faces.push_back({ a, normal / length });
+        axis += faces.back().normal;
+    }
+
+    const float axisLength = glm::length(axis);
+    if (axisLength <= 0.f)
+        return meshlet;
+
+    axis /= axisLength;
+
+    float minimumDot = 1.f;
+    for (const Face& face : faces)
+        minimumDot = std::min(minimumDot, glm::dot(face.normal, axis));
+
+    meshlet.coneAxis = axis;
+    meshlet.coneApex = meshlet.center;
+
+    if (minimumDot <= kMinimumConeDot)
+        return meshlet;
+
+    // Move the apex back along the axis until it's behind every triangle's plane.
+    float apexDistance = 0.f;
+    for (const Face& face : faces)
+        apexDistance = std::max(apexDistance, glm::dot(meshlet.center - face.point, face.normal) / glm::dot(axis, face.normal));
+
+    meshlet.coneApex = meshlet.center - axis * apexDistance;
+    meshlet.coneCutoff = std::sqrt(1.f - minimumDot * minimumDot);
+
+    return meshlet;
+}
+} // end unnamed namespace
+
+std::vector<Meshlet> Meshlet::Build(const VertexBuffer& buffer, std::size_t maxVertices, std::size_t maxTriangles) {
+
+    const std::pmr::vector<std::uint32_t>& indices = buffer.indices();
+    const std::pmr::vector<glm::vec3>& vertices = buffer.vertices();
+
+    std::vector<Meshlet> meshlets;
+    if (indices.empty() || indices.size() % 3 != 0 || maxVertices < 3 || maxTriangles == 0)
+        return meshlets;
+
+    if (std::ranges::any_of(indices, [&vertices](std::uint32_t index) { return index >= vertices.size(); }))
+        return meshlets;
+
+    // The meshlet that last used each vertex.
+    std::vector<std::size_t> owners(vertices.size(), std::numeric_limits<std::size_t>::max());
+
+    std::size_t first = 0;
+    std::size_t vertexCount = 0;
+    std::size_t triangleCount = 0;
+
+    for (std::size_t index = 0; index < indices.size(); index += 3) {
+
+        // Repeated corners of degenerate triangles count twice, which only ends a meshlet a little early.
+        const auto NewVertices = [&]() {
+            return std::ranges::count_if(indices.begin() + index, indices.begin() + index + 3, [&](std::uint32_t vertex) { return owners[vertex] != meshlets.size(); });
+        };
+
+        std::size_t newVertices = static_cast<std::size_t>(NewVertices());
+        if (triangleCount == maxTriangles || vertexCount + newVertices > maxVertices) {
+
+            meshlets.push_back(MakeMeshlet(indices, vertices, static_cast<std::uint32_t>(first), static_cast<std::uint32_t>(index - first)));
+
+            first = index;
+            vertexCount = 0;
+            triangleCount = 0;
+            newVertices = static_cast<std::size_t>(NewVertices());
+        }
+
+        for (std::size_t corner = 0; corner < 3; ++corner)
+            owners[indices[index + corner]] = meshlets.size();
+
+        vertexCount += newVertices;
+        ++triangleCount;
+    }
+
+    meshlets.push_back(MakeMeshlet(indices, vertices, static_cast<std::uint32_t>(first), static_cast<std::uint32_t>(indices.size() - first)));
+    return meshlets;
+}
+
+void Meshlet::Cull(std::span<const Meshlet> meshlets, const Frustum& frustum, const std::optional<glm::vec3>& viewer, std::vector<IndexRange>& visible) {
+
+    visible.clear();
+
+    for (const Meshlet& meshlet : meshlets) {
+
+        if (!frustum.intersects(meshlet.center, meshlet.radius))
+            continue;
+
+        if (viewer && meshlet.backfacing(*viewer))
+            continue;
+
+        if (!visible.empty() && visible.back().first + visible.back().count == meshlet.indices.first)
+            visible.back().count += meshlet.indices.count;
+        else
+            visible.push_back(meshlet.indices);
+    }
+}
+
+bool Meshlet::backfacing(const glm::vec3& viewer) const {
+
+    if (coneCutoff >= 1.f)
+        return false;
+
+    const glm::vec3 direction = coneApex - viewer;
+    const float distance = glm::length(direction);
+
+    return distance > 0.f && glm::dot(direction / distance, coneAxis) >= coneCutoff;
+}
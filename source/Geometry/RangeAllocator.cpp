@@ -0,0 +1,62 @@
+#include "RangeAllocator.hpp"
+
+#include <iterator>
+
+std::optional<std::size_t> RangeAllocator::allocate(std::size_t size) {
+
+    if (size == 0)
+        return 0;
+
+    for (auto it = m_free.begin(); it != m_free.end(); ++it) {
+
+        const auto [offset, freeSize] = *it;
+        if (freeSize < size)
+            continue;
+
+        m_free.erase(it);
+        if (freeSize > size)
+            m_free.emplace(offset + size, freeSize - size);
+
+        m_used += size;
+        return offset;
+    }
+
+    return std::nullopt;
+}
+
+void RangeAllocator::free(std::size_t offset, std::size_t size) {
+
+    if (size == 0)
+        return;
+
+    m_used -= size;
+
+    auto it = m_free.emplace(offset, size).first;
+
+    if (const auto next = std::next(it); next != m_free.end() && offset + it->second == next->first) {
+        it->second += next->second;
+        m_free.erase(next);
+    }
+
+    if (it != m_free.begin()) {
+
+        const auto previous = std::prev(it);
+        if (previous->first + previous->second == offset) {
+            previous->second += it->second;
+            m_free.erase(it);
+        }
+    }
+}
+
+void RangeAllocator::reset(std::size_t used, std::size_t capacity) {
+
+    m_free.clear();
+    if (capacity > used)
+        m_free.emplace(used, capacity - used);
+
+    m_used = used;
+    m_capacity = capacity;
+}
+
+DEFINE_GETTER_IMMUTABLE_COPY(RangeAllocator, capacity, std::size_t, m_capacity)
+DEFINE_GETTER_IMMUTABLE_COPY(RangeAllocator, used, std::size_t, m_used)
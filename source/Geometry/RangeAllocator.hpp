@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Common/ClassMacros.hpp"
+
+#include <cstddef>
+#include <map>
+#include <optional>
+
+// Free list over the offsets [0, capacity). Ranges are handed out first fit and merged with their free neighbours
+// when they come back.
+class RangeAllocator {
+public:
+    std::optional<std::size_t> allocate(std::size_t size);
+    void free(std::size_t offset, std::size_t size);
+
+    // Marks [0, used) as taken and everything from there up to the capacity as free.
+    void reset(std::size_t used, std::size_t capacity);
+
+    DECLARE_GETTER_IMMUTABLE_COPY(capacity, std::size_t)
+    DECLARE_GETTER_IMMUTABLE_COPY(used, std::size_t)
+
+private:
+    std::map<std::size_t, std::size_t> m_free; // Offset to size.
+    std::size_t m_capacity = 0;
+    std::size_t m_used = 0;
+};
@@ -0,0 +1,401 @@
+#include "Geometry/Simplifier.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+
+#include <glm/geometric.hpp>
+
+namespace {
+// Borders are held in place by planes perpendicular to them, weighted well above the surface.
+constexpr double kBorderWeight = 10.0;
+
+// Collapses may tilt a triangle by at most about 75 degrees.
+constexpr float kFlipCosine = .25f;
+
+// Symmetric 4x4 plane quadric, accumulated with the total weight so errors come out as squared distances.
+struct Quadric {
+    static Quadric Plane(const glm::vec3& normal, float distance, double weight) {
+
+        const double a = normal.x;
+        const double b = normal.y;
+        const double c = normal.z;
+        const double d = distance;
+
+        Quadric quadric;
+        quadric.a2 = weight * a * a;
+        quadric.b2 = weight * b * b;
+        quadric.c2 = weight * c * c;
+        quadric.d2 = weight * d * d;
+        quadric.ab = weight * a * b;
+        quadric.ac = weight * a * c;
+        quadric.ad = weight * a * d;
+        quadric.bc = weight * b * c;
+        quadric.bd = weight * b * d;
+        quadric.cd = weight * c * d;
+        quadric.weight = weight;
+        return quadric;
+    }
+
+    Quadric& operator+=(const Quadric& other) {
+
+        a2 += other.a2; b2 += other.b2; c2 += other.c2; d2 += other.d2;
+        ab += other.ab; ac += other.ac; ad += other.ad;
+        bc += other.bc; bd += other.bd; cd += other.cd;
+        weight += other.weight;
+        return *this;
+    }
+
+    double error(const glm::vec3& point) const {
+
+        const double x = point.x;
+        const double y = point.y;
+        const double z = point.z;
+
+        const double rx = a2 * x + ab * y + ac * z + ad;
+        const double ry = ab * x + b2 * y + bc * z + bd;
+        const double rz = ac * x + bc * y + c2 * z + cd;
+
+        const double error = rx * x + ry * y + rz * z + ad * x + bd * y + cd * z + d2;
+        return weight > 0.0 ? std::abs(error) / weight : 0.0;
+    }
+
+    double a2 = 0.0, b2 = 0.0, c2 = 0.0, d2 = 0.0;
+    double ab = 0.0, ac = 0.0, ad = 0.0;
+    double bc = 0.0, bd = 0.0, cd = 0.0;
+    double weight = 0.0;
+};
+
+struct Collapse {
+    double cost = 0.0;
+    std::uint32_t from = 0;
+    std::uint32_t to = 0;
+};
+
+std::uint64_t EdgeKey(std::uint32_t from, std::uint32_t to) {
+    return (static_cast<std::uint64_t>(from) << 32) | to;
+}
+
+// The first vertex at each position, which stands for all of them while simplifying.
+std::vector<std::uint32_t> PositionRemap(std::span<const glm::vec3> vertices) {
+
+    std::vector<std::uint32_t> order(vertices.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    const auto Less = [&vertices](std::uint32_t first, std::uint32_t second) {
+        const glm::vec3& a = vertices[first];
+        const glm::vec3& b = vertices[second];
+        return a.x != b.x ? a.x < b.x : a.y != b.y ? a.y < b.y : a.z != b.z ? a.z < b.z : first < second;
+    };
+
+    std::ranges::sort(order, Less);
+
+    std::vector<std::uint32_t> remap(vertices.size());
+    for (std::size_t index = 0; index < order.size(); ++index) {
+
+        const bool same = index > 0 && vertices[order[index]].x == vertices[order[index - 1]].x &&
+            vertices[order[index]].y == vertices[order[index - 1]].y && vertices[order[index]].z == vertices[order[index - 1]].z;
+
+        remap[order[index]] = same ? remap[order[index - 1]] : order[index];
+    }
+
+    return remap;
+}
+
+// Directed edges of the triangle list between positions, sorted. An edge without its reverse is on a border.
+std::vector<std::uint64_t> PositionEdges(std::span<const std::uint32_t> indices, const std::vector<std::uint32_t>& remap) {
+
+    std::vector<std::uint64_t> edges;
+    edges.reserve(indices.size());
+
+    for (std::size_t index = 0; index < indices.size(); index += 3) {
+        for (std::size_t corner = 0; corner < 3; ++corner)
+            edges.push_back(EdgeKey(remap[indices[index + corner]], remap[indices[index + (corner + 1) % 3]]));
+    }
+
+    std::ranges::sort(edges);
+    return edges;
+}
+
+bool HasEdge(const std::vector<std::uint64_t>& edges, std::uint32_t from, std::uint32_t to) {
+    return std::ranges::binary_search(edges, EdgeKey(from, to));
+}
+} // end unnamed namespace
+
+Simplifier::Result Simplifier::Simplify(std::span<const std::uint32_t> indices, std::span<const glm::vec3> vertices, std::size_t targetIndexCount, float targetError, std::span<const glm::vec3> normals) {
+
+    Result result;
+    result.indices.assign(indices.begin(), indices.end());
+
+    if (result.indices.size() <= targetIndexCount || result.indices.size() % 3 != 0)
+        return result;
+
+    if (std::ranges::any_of(result.indices, [&vertices](std::uint32_t index) { return index >= vertices.size(); }))
+        return result;
+
+    if (normals.size() != vertices.size())
+        normals = {};
+
+    // Vertices at the same position, split along attribute seams, are simplified as one and move together.
+    const std::vector<std::uint32_t> remap = PositionRemap(vertices);
+
+    std::vector<std::uint32_t> groupOffsets(vertices.size() + 1, 0);
+    for (const std::uint32_t group : remap)
+        ++groupOffsets[group + 1];
+
+    std::partial_sum(groupOffsets.cbegin(), groupOffsets.cend(), groupOffsets.begin());
+
+    std::vector<std::uint32_t> groupMembers(vertices.size());
+    {
+        std::vector<std::uint32_t> cursors{ groupOffsets.cbegin(), groupOffsets.cend() - 1 };
+        for (std::uint32_t vertex = 0; vertex < vertices.size(); ++vertex)
+            groupMembers[cursors[remap[vertex]]++] = vertex;
+    }
+
+    // Area weighted planes of the surrounding triangles, and perpendicular planes along the borders.
+    std::vector<Quadric> quadrics(vertices.size());
+    {
+        const std::vector<std::uint64_t> edges = PositionEdges(result.indices, remap);
+
+        for (std::size_t index = 0; index < result.indices.size(); index += 3) {
+
+            const std::uint32_t* pTriangle = &result.indices[index];
+            const glm::vec3 normal = glm::cross(vertices[pTriangle[1]] - vertices[pTriangle[0]], vertices[pTriangle[2]] - vertices[pTriangle[0]]);
+
+            const float area = glm::length(normal);
+            if (area <= 0.f)
+                continue;
+
+            const glm::vec3 unit = normal / area;
+            const Quadric plane = Quadric::Plane(unit, -glm::dot(unit, vertices[pTriangle[0]]), area);
+
+            for (std::size_t corner = 0; corner < 3; ++corner) {
+
+                const std::uint32_t from = remap[pTriangle[corner]];
+                const std::uint32_t to = remap[pTriangle[(corner + 1) % 3]];
+
+                quadrics[from] += plane;
+
+                if (HasEdge(edges, to, from))
+                    continue;
+
+                const glm::vec3 edge = vertices[to] - vertices[from];
+                const float length = glm::length(edge);
+                if (length <= 0.f)
+                    continue;
+
+                const glm::vec3 borderNormal = glm::normalize(glm::cross(edge, unit));
+                const Quadric border = Quadric::Plane(borderNormal, -glm::dot(borderNormal, vertices[from]), kBorderWeight * length * length);
+
+                quadrics[from] += border;
+                quadrics[to] += border;
+            }
+        }
+    }
+
+    const double errorLimit = static_cast<double>(targetError) * targetError;
+    double largestCost = 0.0;
+
+    // Each pass collapses a set of edges that don't share triangles, so every collapse is checked against the mesh
+    // it's applied to. Collapses, borders and triangle fans are all between positions.
+    while (result.indices.size() > targetIndexCount) {
+
+        std::vector<std::uint32_t>& current = result.indices;
+        const std::vector<std::uint64_t> edges = PositionEdges(current, remap);
+
+        std::vector<bool> border(vertices.size(), false);
+        for (std::size_t index = 0; index < current.size(); index += 3) {
+            for (std::size_t corner = 0; corner < 3; ++corner) {
+
+                const std::uint32_t from = remap[current[index + corner]];
+                const std::uint32_t to = remap[current[index + (corner + 1) % 3]];
+                if (!HasEdge(edges, to, from))
+                    border[from] = border[to] = true;
+            }
+        }
+
+        // Border positions may only slide along their border.
+        const auto CanCollapse = [&](std::uint32_t from, bool borderEdge) {
+            return !border[from] || borderEdge;
+        };
+
+        std::vector<Collapse> collapses;
+        collapses.reserve(current.size() / 2);
+
+        for (std::size_t index = 0; index < current.size(); index += 3) {
+            for (std::size_t corner = 0; corner < 3; ++corner) {
+
+                const std::uint32_t a = remap[current[index + corner]];
+                const std::uint32_t b = remap[current[index + (corner + 1) % 3]];
+
+                // Interior edges are seen from both of their triangles, only take them once.
+                const bool borderEdge = !HasEdge(edges, b, a);
+                if (!borderEdge && a > b)
+                    continue;
+
+                Quadric combined = quadrics[a];
+                combined += quadrics[b];
+
+                Collapse best{ -1.0 };
+                if (CanCollapse(a, borderEdge))
+                    best = { combined.error(vertices[b]), a, b };
+
+                if (CanCollapse(b, borderEdge)) {
+                    const double cost = combined.error(vertices[a]);
+                    if (best.cost < 0.0 || cost < best.cost)
+                        best = { cost, b, a };
+                }
+
+                if (best.cost >= 0.0)
+                    collapses.push_back(best);
+            }
+        }
+
+        std::ranges::sort(collapses, [](const Collapse& first, const Collapse& second) { return first.cost < second.cost; });
+
+        // Triangles around each position.
+        std::vector<std::uint32_t> offsets(vertices.size() + 1, 0);
+        for (const std::uint32_t index : current)
+            ++offsets[remap[index] + 1];
+
+        std::partial_sum(offsets.cbegin(), offsets.cend(), offsets.begin());
+
+        std::vector<std::uint32_t> adjacency(current.size());
+        {
+            std::vector<std::uint32_t> cursors{ offsets.cbegin(), offsets.cend() - 1 };
+            for (std::size_t index = 0; index < current.size(); ++index)
+                adjacency[cursors[remap[current[index]]]++] = static_cast<std::uint32_t>(index / 3);
+        }
+
+        const auto Contains = [&](const std::uint32_t* pTriangle, std::uint32_t group) {
+            return remap[pTriangle[0]] == group || remap[pTriangle[1]] == group || remap[pTriangle[2]] == group;
+        };
+
+        // Moving the position must not turn any of its remaining triangles over, or far enough to fold into a neighbour.
+        const auto Flips = [&](std::uint32_t from, std::uint32_t to) {
+
+            for (std::uint32_t slot = offsets[from]; slot < offsets[from + 1]; ++slot) {
+
+                const std::uint32_t* pTriangle = &current[adjacency[slot] * 3];
+                if (Contains(pTriangle, to))
+                    continue;
+
+                std::array<glm::vec3, 3> corners{ vertices[pTriangle[0]], vertices[pTriangle[1]], vertices[pTriangle[2]] };
+                const glm::vec3 before = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+
+                for (std::size_t corner = 0; corner < 3; ++corner) {
+                    if (remap[pTriangle[corner]] == from)
+                        corners[corner] = vertices[to];
+                }
+
+                const glm::vec3 after = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+                if (glm::dot(before, after) <= kFlipCosine * glm::length(before) * glm::length(after))
+                    return true;
+            }
+
+            return false;
+        };
+
+        std::vector<std::uint32_t> collapseTo(vertices.size());
+        std::iota(collapseTo.begin(), collapseTo.end(), 0);
+
+        std::vector<bool> touched(vertices.size(), false);
+
+        const std::size_t removable = (current.size() - targetIndexCount) / 3;
+        std::size_t removed = 0;
+        std::size_t collapsed = 0;
+
+        for (const Collapse& collapse : collapses) {
+
+            if (collapse.cost > errorLimit || removed >= removable)
+                break;
+
+            if (touched[collapse.from] || touched[collapse.to] || Flips(collapse.from, collapse.to))
+                continue;
+
+            // Lock every position of the triangles that change, later collapses this pass can't see the new shape.
+            for (std::uint32_t slot = offsets[collapse.from]; slot < offsets[collapse.from + 1]; ++slot) {
+
+                const std::uint32_t* pTriangle = &current[adjacency[slot] * 3];
+                touched[remap[pTriangle[0]]] = touched[remap[pTriangle[1]]] = touched[remap[pTriangle[2]]] = true;
+
+                if (Contains(pTriangle, collapse.to))
+                    ++removed;
+            }
+
+            collapseTo[collapse.from] = collapse.to;
+            quadrics[collapse.to] += quadrics[collapse.from];
+            largestCost = std::max(largestCost, collapse.cost);
+            ++collapsed;
+        }
+
+        if (collapsed == 0)
+            break;
+
+        // A moved vertex takes the one it shares an edge with at the target, which keeps both sides of a seam apart.
+        // Without one, e.g. on flat shaded meshes, it takes the target vertex facing the same way.
+        std::vector<std::uint32_t> moveTo(vertices.size());
+        std::iota(moveTo.begin(), moveTo.end(), 0);
+
+        std::vector<bool> matched(vertices.size(), false);
+
+        for (std::size_t index = 0; index < current.size(); index += 3) {
+            for (std::size_t corner = 0; corner < 3; ++corner) {
+                for (std::size_t other = 1; other < 3; ++other) {
+
+                    const std::uint32_t vertex = current[index + corner];
+                    const std::uint32_t neighbour = current[index + (corner + other) % 3];
+
+                    if (!matched[vertex] && collapseTo[remap[vertex]] != remap[vertex] && collapseTo[remap[vertex]] == remap[neighbour]) {
+                        moveTo[vertex] = neighbour;
+                        matched[vertex] = true;
+                    }
+                }
+            }
+        }
+
+        const auto MoveTo = [&](std::uint32_t vertex) {
+
+            const std::uint32_t target = collapseTo[remap[vertex]];
+            if (target == remap[vertex] || matched[vertex])
+                return moveTo[vertex];
+
+            std::uint32_t best = target;
+            if (!normals.empty()) {
+
+                float bestFacing = -2.f;
+                for (std::uint32_t slot = groupOffsets[target]; slot < groupOffsets[target + 1]; ++slot) {
+
+                    const float facing = glm::dot(normals[vertex], normals[groupMembers[slot]]);
+                    if (facing > bestFacing) {
+                        bestFacing = facing;
+                        best = groupMembers[slot];
+                    }
+                }
+            }
+
+            moveTo[vertex] = best;
+            matched[vertex] = true;
+            return best;
+        };
+
+        std::vector<std::uint32_t> simplified;
+        simplified.reserve(current.size());
+
+        for (std::size_t index = 0; index < current.size(); index += 3) {
+
+            const std::uint32_t a = MoveTo(current[index]);
+            const std::uint32_t b = MoveTo(current[index + 1]);
+            const std::uint32_t c = MoveTo(current[index + 2]);
+
+            if (remap[a] != remap[b] && remap[b] != remap[c] && remap[a] != remap[c])
+                simplified.insert(simplified.end(), { a, b, c });
+        }
+
+        current = std::move(simplified);
+    }
+
+    result.error = static_cast<float>(std::sqrt(largestCost));
+    return result;
+}
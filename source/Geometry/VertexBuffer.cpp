@@ -1,16 +1,46 @@
 #include "Geometry/VertexBuffer.hpp"
 
 struct VertexBuffer::Private {
-    std::vector<glm::vec4> m_colors;
-    std::vector<uint32_t> m_indices;
-    std::vector<glm::vec3> m_normals;
-    std::vector<glm::vec2> m_texels;
-    std::vector<glm::vec3> m_vertices;
+    explicit Private(std::shared_ptr<std::pmr::memory_resource> pMemory);
+
+    // Copies are made on the heap, they may outlive the memory of the original.
+    Private(const Private& other);
+
+    std::pmr::memory_resource* resource() const;
+
+    std::shared_ptr<std::pmr::memory_resource> m_pMemory; // Declared first, the arrays are released before it.
+
+    std::pmr::vector<glm::vec4> m_colors;
+    std::pmr::vector<uint32_t> m_indices;
+    std::pmr::vector<glm::vec3> m_normals;
+    std::pmr::vector<glm::vec2> m_texels;
+    std::pmr::vector<glm::vec3> m_vertices;
 };
 
+VertexBuffer::Private::Private(std::shared_ptr<std::pmr::memory_resource> pMemory)
+    : m_pMemory(std::move(pMemory))
+    , m_colors(resource())
+    , m_indices(resource())
+    , m_normals(resource())
+    , m_texels(resource())
+    , m_vertices(resource()) {}
+
+std::pmr::memory_resource* VertexBuffer::Private::resource() const {
+    return m_pMemory ? m_pMemory.get() : std::pmr::get_default_resource();
+}
+
+VertexBuffer::Private::Private(const Private& other)
+    : m_colors(other.m_colors, std::pmr::get_default_resource())
+    , m_indices(other.m_indices, std::pmr::get_default_resource())
+    , m_normals(other.m_normals, std::pmr::get_default_resource())
+    , m_texels(other.m_texels, std::pmr::get_default_resource())
+    , m_vertices(other.m_vertices, std::pmr::get_default_resource()) {}
 
 VertexBuffer::VertexBuffer()
-    : m_pPrivate(std::make_unique<Private>()) {}
+    : m_pPrivate(std::make_unique<Private>(nullptr)) {}
+
+VertexBuffer::VertexBuffer(std::shared_ptr<std::pmr::memory_resource> pMemory)
+    : m_pPrivate(std::make_unique<Private>(std::move(pMemory))) {}
 
 VertexBuffer::VertexBuffer(const VertexBuffer& other) {
     *this = other;
@@ -58,8 +88,50 @@ void VertexBuffer::addIndex(uint32_t index) {
     m_pPrivate->m_indices.push_back(index);
 }
 
-DEFINE_GETTER_CONST_CORRECT(VertexBuffer, colors, std::vector<glm::vec4>, m_pPrivate->m_colors)
-DEFINE_GETTER_CONST_CORRECT(VertexBuffer, indices, std::vector<uint32_t>, m_pPrivate->m_indices)
-DEFINE_GETTER_CONST_CORRECT(VertexBuffer, normals, std::vector<glm::vec3>, m_pPrivate->m_normals)
-DEFINE_GETTER_CONST_CORRECT(VertexBuffer, texels, std::vector<glm::vec2>, m_pPrivate->m_texels)
-DEFINE_GETTER_CONST_CORRECT(VertexBuffer, vertices, std::vector<glm::vec3>, m_pPrivate->m_vertices)
+namespace {
+template<typename T>
+void Append(std::pmr::vector<T>& destination, std::span<const T> source) {
+    destination.insert(destination.end(), source.begin(), source.end());
+}
+} // end unnamed namespace
+
+void VertexBuffer::addColors(std::span<const glm::vec4> colors) {
+    Append(m_pPrivate->m_colors, colors);
+}
+
+void VertexBuffer::addIndices(std::span<const uint32_t> indices) {
+    Append(m_pPrivate->m_indices, indices);
+}
+
+void VertexBuffer::addNormals(std::span<const glm::vec3> normals) {
+    Append(m_pPrivate->m_normals, normals);
+}
+
+void VertexBuffer::addTexels(std::span<const glm::vec2> texels) {
+    Append(m_pPrivate->m_texels, texels);
+}
+
+void VertexBuffer::addVertices(std::span<const glm::vec3> vertices) {
+    Append(m_pPrivate->m_vertices, vertices);
+}
+
+void VertexBuffer::reserve(std::size_t vertexCount, std::size_t indexCount, bool normals, bool texels, bool colors) {
+
+    m_pPrivate->m_vertices.reserve(vertexCount);
+    m_pPrivate->m_indices.reserve(indexCount);
+
+    if (normals)
+        m_pPrivate->m_normals.reserve(vertexCount);
+
+    if (texels)
+        m_pPrivate->m_texels.reserve(vertexCount);
+
+    if (colors)
+        m_pPrivate->m_colors.reserve(vertexCount);
+}
+
+DEFINE_GETTER_CONST_CORRECT(VertexBuffer, colors, std::pmr::vector<glm::vec4>, m_pPrivate->m_colors)
+DEFINE_GETTER_CONST_CORRECT(VertexBuffer, indices, std::pmr::vector<uint32_t>, m_pPrivate->m_indices)
+DEFINE_GETTER_CONST_CORRECT(VertexBuffer, normals, std::pmr::vector<glm::vec3>, m_pPrivate->m_normals)
+DEFINE_GETTER_CONST_CORRECT(VertexBuffer, texels, std::pmr::vector<glm::vec2>, m_pPrivate->m_texels)
+DEFINE_GETTER_CONST_CORRECT(VertexBuffer, vertices, std::pmr::vector<glm::vec3>, m_pPrivate->m_vertices)
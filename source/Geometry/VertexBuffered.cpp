@@ -1,6 +1,38 @@
 #include "Geometry/VertexBuffered.hpp"
 
+#include "Geometry/MeshOptimizer.hpp"
+#include "Geometry/Simplifier.hpp"
+
+#include <limits>
+
+namespace {
+// Each level aims for half the triangles of the one before it.
+constexpr std::size_t kMaxLods = 6;
+constexpr std::size_t kMinLodTriangles = 64;
+
+// A level that keeps more than this share of its parent's triangles isn't worth drawing.
+constexpr float kMinLodReduction = .9f;
+} // end unnamed namespace
+
 struct VertexBuffered::Private {
+    // What's left of the buffer once it was released.
+    struct Summary {
+        std::size_t vertexCount = 0;
+        std::size_t indexCount = 0;
+        std::vector<std::size_t> lodIndexCounts;
+        bool colors = false;
+        bool normals = false;
+        bool texels = false;
+    };
+
+    Private() = default;
+    ~Private();
+
+    // Deletes the geometry's own buffer objects, e.g. once it draws from an arena instead.
+    void destroyBuffers();
+
+    COPY_MOVE_DISABLED(Private)
+
     GLuint m_bufferId = 0; // Named vertex array object.
     GLuint m_colorId = 0; // Named buffer object for color data.
     GLuint m_indexId = 0; // Named element buffer object.
@@ -10,44 +42,70 @@ struct VertexBuffered::Private {
 
     bool m_initialized = false; // Flag indicating if buffer objects were created
     PrimativeType m_primativeType = PrimativeType::Triangles; // Rendering primative used in drawing.
+    Layout m_layout = Layout::Interleaved;
+    VertexEncoding m_encoding = VertexEncoding::Float;
+    VertexBounds m_bounds;
+    std::vector<Meshlet> m_meshlets;
+    std::vector<Lod> m_lods;
+    std::shared_ptr<GeometryArena::Allocation> m_pAllocation;
+    std::optional<Summary> m_released;
 };
 
+VertexBuffered::Private::~Private() {
+    destroyBuffers();
+}
 
-VertexBuffered::VertexBuffered()
-    : m_pPrivate(std::make_unique<Private>()) {}
-
-VertexBuffered::VertexBuffered(const VertexBuffer& buffer)
-    : m_buffer(buffer), m_pPrivate(std::make_unique<Private>()) {}
-
-VertexBuffered::~VertexBuffered() noexcept {
+void VertexBuffered::Private::destroyBuffers() {
 
-    if (m_pPrivate->m_bufferId)
-        glDeleteVertexArrays(1, &m_pPrivate->m_bufferId);
+    if (m_bufferId)
+        glDeleteVertexArrays(1, &m_bufferId);
 
-    if (m_pPrivate->m_colorId)
-        glDeleteBuffers(1, &m_pPrivate->m_colorId);
+    if (m_colorId)
+        glDeleteBuffers(1, &m_colorId);
 
-    if (m_pPrivate->m_indexId)
-        glDeleteBuffers(1, &m_pPrivate->m_indexId);
+    if (m_indexId)
+        glDeleteBuffers(1, &m_indexId);
     
-    if (m_pPrivate->m_normalId)
-        glDeleteBuffers(1, &m_pPrivate->m_normalId);
+    if (m_normalId)
+        glDeleteBuffers(1, &m_normalId);
     
-    if (m_pPrivate->m_texelId)
-        glDeleteBuffers(1, &m_pPrivate->m_texelId);
+    if (m_texelId)
+        glDeleteBuffers(1, &m_texelId);
         
-    if (m_pPrivate->m_vertexId)
-        glDeleteBuffers(1, &m_pPrivate->m_vertexId);
+    if (m_vertexId)
+        glDeleteBuffers(1, &m_vertexId);
+
+    m_bufferId = m_colorId = m_indexId = m_normalId = m_texelId = m_vertexId = 0;
 }
 
+
+VertexBuffered::VertexBuffered()
+    : m_pPrivate(std::make_unique<Private>()) {}
+
+VertexBuffered::VertexBuffered(const VertexBuffer& buffer)
+    : m_buffer(buffer), m_pPrivate(std::make_unique<Private>()) {}
+
+VertexBuffered::VertexBuffered(VertexBuffer&& buffer)
+    : m_buffer(std::move(buffer)), m_pPrivate(std::make_unique<Private>()) {}
+
+VertexBuffered::~VertexBuffered() noexcept {}
+
 VertexBuffered::VertexBuffered(const VertexBuffered& other) {
     *this = other;
 }
 
 VertexBuffered& VertexBuffered::operator=(const VertexBuffered& other) {
 
+    // Copies get their own buffer objects, only the attribute data is shared.
     if (this != &other) {
         m_pPrivate = std::make_unique<Private>();
+        m_pPrivate->m_primativeType = other.m_pPrivate->m_primativeType;
+        m_pPrivate->m_layout = other.m_pPrivate->m_layout;
+        m_pPrivate->m_encoding = other.m_pPrivate->m_encoding;
+        m_pPrivate->m_meshlets = other.m_pPrivate->m_meshlets;
+        m_pPrivate->m_lods = other.m_pPrivate->m_lods;
+        m_pPrivate->m_bounds = other.m_pPrivate->m_bounds;
+        m_pPrivate->m_released = other.m_pPrivate->m_released;
         m_buffer = other.m_buffer;
     }
 
@@ -61,51 +119,64 @@ VertexBuffered::VertexBuffered(VertexBuffered&& other) noexcept {
 VertexBuffered& VertexBuffered::operator=(VertexBuffered&& other) noexcept {
 
     if (this != &other) {
-        m_pPrivate = std::make_unique<Private>();
+        m_pPrivate = std::exchange(other.m_pPrivate, nullptr);
         m_buffer = std::move(other.m_buffer);
     }
 
     return *this;
 }
 
-std::optional<std::vector<glm::vec4>> VertexBuffered::colors() const {
+namespace {
+template<typename T>
+std::optional<std::span<const T>> MakeView(const std::pmr::vector<T>& data) {
 
-    if (m_buffer.colors().empty())
+    if (data.empty())
         return std::nullopt;
 
-    return m_buffer.colors();
+    return std::span<const T>{ data };
 }
+} // end unnamed namespace
 
-std::optional<std::vector<uint32_t>> VertexBuffered::indices() const {
-
-    if (m_buffer.indices().empty())
-        return std::nullopt;
+std::optional<std::span<const glm::vec4>> VertexBuffered::colors() const {
+    return MakeView(m_buffer.colors());
+}
 
-    return m_buffer.indices();
+std::optional<std::span<const uint32_t>> VertexBuffered::indices() const {
+    return MakeView(m_buffer.indices());
 }
 
-std::optional<std::vector<glm::vec3>> VertexBuffered::normals() const {
+std::optional<std::span<const glm::vec3>> VertexBuffered::normals() const {
+    return MakeView(m_buffer.normals());
+}
 
-    if (m_buffer.normals().empty())
-        return std::nullopt;
+std::optional<std::span<const glm::vec2>> VertexBuffered::texels() const {
+    return MakeView(m_buffer.texels());
+}
 
-    return m_buffer.normals();
+std::optional<std::span<const glm::vec3>> VertexBuffered::vertices() const {
+    return MakeView(m_buffer.vertices());
 }
 
-std::optional<std::vector<glm::vec2>> VertexBuffered::texels() const {
+DEFINE_GETTER_CONST_CORRECT(VertexBuffered, buffer, VertexBuffer, m_buffer)
 
-    if (m_buffer.texels().empty())
-        return std::nullopt;
+std::size_t VertexBuffered::indexCount() const {
+    return m_pPrivate->m_released ? m_pPrivate->m_released->indexCount : m_buffer.indices().size();
+}
 
-    return m_buffer.texels();
+std::size_t VertexBuffered::vertexCount() const {
+    return m_pPrivate->m_released ? m_pPrivate->m_released->vertexCount : m_buffer.vertices().size();
 }
 
-std::optional<std::vector<glm::vec3>> VertexBuffered::vertices() const {
+bool VertexBuffered::hasColors() const {
+    return m_pPrivate->m_released ? m_pPrivate->m_released->colors : !m_buffer.colors().empty();
+}
 
-    if (m_buffer.vertices().empty())
-        return std::nullopt;
+bool VertexBuffered::hasNormals() const {
+    return m_pPrivate->m_released ? m_pPrivate->m_released->normals : !m_buffer.normals().empty();
+}
 
-    return m_buffer.vertices();
+bool VertexBuffered::hasTexels() const {
+    return m_pPrivate->m_released ? m_pPrivate->m_released->texels : !m_buffer.texels().empty();
 }
 
 DEFINE_GETTER_IMMUTABLE_COPY(VertexBuffered, id, GLuint, m_pPrivate->m_bufferId)
@@ -117,6 +188,14 @@ DEFINE_GETTER_IMMUTABLE_COPY(VertexBuffered, vertexBufferId, GLuint, m_pPrivate-
 
 std::optional<GLuint> VertexBuffered::attributeBufferId(const std::string& name) const {
 
+    if (m_pPrivate->m_layout == Layout::Interleaved) {
+
+        if ((name == "color" || name == "normal" || name == "texel" || name == "position") && m_pPrivate->m_vertexId != 0)
+            return m_pPrivate->m_vertexId;
+
+        return std::nullopt;
+    }
+
     if (name == "color" && m_pPrivate->m_colorId != 0)
         return m_pPrivate->m_colorId;
 
@@ -135,30 +214,157 @@ std::optional<GLuint> VertexBuffered::attributeBufferId(const std::string& name)
 DEFINE_GETTER_IMMUTABLE_COPY(VertexBuffered, primativeType, VertexBuffered::PrimativeType, m_pPrivate->m_primativeType)
 DEFINE_SETTER_COPY(VertexBuffered, primativeType, m_pPrivate->m_primativeType)
 
+DEFINE_GETTER_IMMUTABLE_COPY(VertexBuffered, layout, VertexBuffered::Layout, m_pPrivate->m_layout)
+DEFINE_SETTER_COPY(VertexBuffered, layout, m_pPrivate->m_layout)
+
+VertexEncoding VertexBuffered::encoding() const {
+    return m_pPrivate->m_layout == Layout::Interleaved ? m_pPrivate->m_encoding : VertexEncoding::Float;
+}
+
+DEFINE_SETTER_COPY(VertexBuffered, encoding, m_pPrivate->m_encoding)
+
+DEFINE_GETTER_IMMUTABLE(VertexBuffered, bounds, VertexBounds, m_pPrivate->m_bounds)
+
+glm::mat4 VertexBuffered::positionTransform() const {
+
+    if (encoding() == VertexEncoding::Compact)
+        return m_pPrivate->m_bounds.dequantization();
+
+    return glm::mat4{ 1.f };
+}
+
+GLenum VertexBuffered::indexType() const {
+
+    // Every index of the mesh has to fit in 16 bits.
+    if (encoding() == VertexEncoding::Compact && vertexCount() <= std::numeric_limits<std::uint16_t>::max())
+        return GL_UNSIGNED_SHORT;
+
+    return GL_UNSIGNED_INT;
+}
+
+void VertexBuffered::buildMeshlets() {
+
+    if (m_pPrivate->m_released)
+        return;
+
+    if (m_pPrivate->m_primativeType == PrimativeType::Triangles)
+        m_pPrivate->m_meshlets = Meshlet::Build(m_buffer);
+    else
+        m_pPrivate->m_meshlets.clear();
+}
+
+DEFINE_GETTER_IMMUTABLE(VertexBuffered, meshlets, std::vector<Meshlet>, m_pPrivate->m_meshlets)
+
+void VertexBuffered::buildLods() {
+
+    if (m_pPrivate->m_released)
+        return;
+
+    std::vector<Lod>& lods = m_pPrivate->m_lods;
+    lods.clear();
+
+    if (m_pPrivate->m_primativeType != PrimativeType::Triangles)
+        return;
+
+    std::span<const std::uint32_t> previous = m_buffer.indices();
+    float error = 0.f;
+
+    while (lods.size() < kMaxLods) {
+
+        const std::size_t target = previous.size() / 6 * 3;
+        if (target < kMinLodTriangles * 3)
+            break;
+
+        Simplifier::Result level = Simplifier::Simplify(previous, m_buffer.vertices(), target, std::numeric_limits<float>::max(), m_buffer.normals());
+        if (level.indices.size() > previous.size() * kMinLodReduction)
+            break;
+
+        MeshOptimizer::OptimizeVertexCache(level.indices, m_buffer.vertices().size());
+
+        // Each level is simplified from the last, so its errors add up.
+        error += level.error;
+        lods.push_back({ std::move(level.indices), error });
+        previous = lods.back().indices;
+    }
+}
+
+DEFINE_GETTER_CONST_CORRECT(VertexBuffered, lods, std::vector<VertexBuffered::Lod>, m_pPrivate->m_lods)
+
+std::size_t VertexBuffered::lodIndexCount(std::size_t lod) const {
+    return m_pPrivate->m_released ? m_pPrivate->m_released->lodIndexCounts[lod] : m_pPrivate->m_lods[lod].indices.size();
+}
+
+void VertexBuffered::releaseBuffer() {
+
+    if (m_pPrivate->m_released)
+        return;
+
+    Private::Summary summary;
+    summary.vertexCount = m_buffer.vertices().size();
+    summary.indexCount = m_buffer.indices().size();
+    summary.colors = !m_buffer.colors().empty();
+    summary.normals = !m_buffer.normals().empty();
+    summary.texels = !m_buffer.texels().empty();
+
+    for (Lod& lod : m_pPrivate->m_lods) {
+        summary.lodIndexCounts.push_back(lod.indices.size());
+        lod.indices = {};
+    }
+
+    if (!m_pPrivate->m_initialized)
+        m_pPrivate->m_bounds = VertexBounds::Of(m_buffer);
+
+    m_pPrivate->m_released = std::move(summary);
+    m_buffer = VertexBuffer{};
+}
+
+DEFINE_GETTER_IMMUTABLE_COPY(VertexBuffered, released, bool, m_pPrivate->m_released.has_value())
+
 void VertexBuffered::initialize() {
 
+    // Geometry that switched from an arena range draws from its own buffers again.
+    m_pPrivate->m_pAllocation.reset();
+
     if (!m_pPrivate->m_bufferId)
         glGenVertexArrays(1, &m_pPrivate->m_bufferId);
 
-    if (!m_pPrivate->m_colorId && !m_buffer.colors().empty())
+    // Interleaved attributes all live in the vertex buffer.
+    const bool planar = m_pPrivate->m_layout == Layout::Planar;
+
+    if (!m_pPrivate->m_colorId && planar && !m_buffer.colors().empty())
         glGenBuffers(1, &m_pPrivate->m_colorId);
 
     if (!m_pPrivate->m_indexId && !m_buffer.indices().empty())
         glGenBuffers(1, &m_pPrivate->m_indexId);
 
-    if (!m_pPrivate->m_normalId && !m_buffer.normals().empty())
+    if (!m_pPrivate->m_normalId && planar && !m_buffer.normals().empty())
         glGenBuffers(1, &m_pPrivate->m_normalId);
 
-    if (!m_pPrivate->m_texelId && !m_buffer.texels().empty())
+    if (!m_pPrivate->m_texelId && planar && !m_buffer.texels().empty())
         glGenBuffers(1, &m_pPrivate->m_texelId);
 
     if (!m_pPrivate->m_vertexId && !m_buffer.vertices().empty())
         glGenBuffers(1, &m_pPrivate->m_vertexId);
 
+    // Released geometry keeps the bounds it had.
+    if (!m_pPrivate->m_released)
+        m_pPrivate->m_bounds = VertexBounds::Of(m_buffer);
+
+    m_pPrivate->m_initialized = true;
+}
+
+void VertexBuffered::initialize(std::shared_ptr<GeometryArena::Allocation> pAllocation) {
+
+    m_pPrivate->m_pAllocation = std::move(pAllocation);
+    m_pPrivate->destroyBuffers();
+
+    if (!m_pPrivate->m_released)
+        m_pPrivate->m_bounds = VertexBounds::Of(m_buffer);
     m_pPrivate->m_initialized = true;
 }
 
 DEFINE_GETTER_IMMUTABLE_COPY(VertexBuffered, initialized, bool, m_pPrivate->m_initialized)
+DEFINE_GETTER_IMMUTABLE(VertexBuffered, allocation, std::shared_ptr<GeometryArena::Allocation>, m_pPrivate->m_pAllocation)
 
 void VertexBuffered::color(const glm::vec4& color) {
 
@@ -0,0 +1,108 @@
+#include "Geometry/VertexFormat.hpp"
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include <glm/common.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
+
+namespace {
+template<typename... Attributes>
+struct AttributeList {};
+
+// Walks the optional attributes, keeping the ones the predicate accepts, and ends at the format made of those.
+template<typename Keep, typename... Chosen>
+VertexLayout Select(const Keep&, AttributeList<Chosen...>, AttributeList<>) {
+    return VertexFormat<Chosen...>::kLayout;
+}
+
+template<typename Keep, typename... Chosen, typename Next, typename... Rest>
+VertexLayout Select(const Keep& keep, AttributeList<Chosen...>, AttributeList<Next, Rest...>) {
+
+    if (keep(std::type_identity<Next>{}))
+        return Select(keep, AttributeList<Chosen..., Next>{}, AttributeList<Rest...>{});
+
+    return Select(keep, AttributeList<Chosen...>{}, AttributeList<Rest...>{});
+}
+
+template<typename Keep>
+VertexLayout Select(VertexEncoding encoding, const Keep& keep) {
+
+    if (encoding == VertexEncoding::Compact)
+        return Select(keep, AttributeList<QuantizedPosition>{}, AttributeList<OctahedralNormal, HalfTexel, PackedColor>{});
+
+    return Select(keep, AttributeList<Position>{}, AttributeList<Normal, Texel, Color>{});
+}
+
+template<typename T>
+T Normalize(float value) {
+    return static_cast<T>(std::lround(value * static_cast<float>(std::numeric_limits<T>::max())));
+}
+} // end unnamed namespace
+
+VertexBounds VertexBounds::Of(const VertexBuffer& buffer) {
+
+    const std::pmr::vector<glm::vec3>& vertices = buffer.vertices();
+    if (vertices.empty())
+        return {};
+
+    glm::vec3 minimum = vertices.front();
+    glm::vec3 maximum = vertices.front();
+    for (const glm::vec3& vertex : vertices) {
+        minimum = glm::min(minimum, vertex);
+        maximum = glm::max(maximum, vertex);
+    }
+
+    // Flat meshes still need a non zero extent to divide by.
+    return { minimum, glm::max(maximum - minimum, glm::vec3{ 1e-6f }) };
+}
+
+glm::mat4 VertexBounds::dequantization() const {
+    return glm::scale(glm::translate(glm::mat4{ 1.f }, min), extent);
+}
+
+QuantizedPosition::Type QuantizedPosition::Encode(const glm::vec3& position, const VertexBounds& bounds) {
+
+    const glm::vec3 unit = glm::clamp((position - bounds.min) / bounds.extent, 0.f, 1.f);
+    return { Normalize<std::uint16_t>(unit.x), Normalize<std::uint16_t>(unit.y), Normalize<std::uint16_t>(unit.z), 0 };
+}
+
+OctahedralNormal::Type OctahedralNormal::Encode(const glm::vec3& normal, const VertexBounds&) {
+
+    const float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (length <= 0.f)
+        return { 0, 0 };
+
+    glm::vec2 folded = glm::vec2{ normal.x, normal.y } / length;
+
+    // The lower hemisphere folds over the diagonals onto the corners of the square.
+    if (normal.z < 0.f) {
+        const glm::vec2 sign{ folded.x >= 0.f ? 1.f : -1.f, folded.y >= 0.f ? 1.f : -1.f };
+        folded = (1.f - glm::abs(glm::vec2{ folded.y, folded.x })) * sign;
+    }
+
+    folded = glm::clamp(folded, -1.f, 1.f);
+    return { Normalize<std::int16_t>(folded.x), Normalize<std::int16_t>(folded.y) };
+}
+
+HalfTexel::Type HalfTexel::Encode(const glm::vec2& texel, const VertexBounds&) {
+    return { glm::packHalf1x16(texel.x), glm::packHalf1x16(texel.y) };
+}
+
+PackedColor::Type PackedColor::Encode(const glm::vec4& color, const VertexBounds&) {
+
+    const glm::vec4 unit = glm::clamp(color, 0.f, 1.f);
+    return { Normalize<std::uint8_t>(unit.r), Normalize<std::uint8_t>(unit.g), Normalize<std::uint8_t>(unit.b), Normalize<std::uint8_t>(unit.a) };
+}
+
+VertexLayout VertexLayout::Select(const VertexBuffer& buffer, VertexEncoding encoding, const std::function<bool(std::string_view)>& include) {
+    return ::Select(encoding, [&buffer, &include]<typename Attribute>(std::type_identity<Attribute>) {
+        return !Attribute::Data(buffer).empty() && (!include || include(Attribute::kName));
+    });
+}
+
+VertexLayout VertexLayout::Select(VertexEncoding encoding, const std::function<bool(std::string_view)>& include) {
+    return ::Select(encoding, [&include]<typename Attribute>(std::type_identity<Attribute>) { return include(Attribute::kName); });
+}
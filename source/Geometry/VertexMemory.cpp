@@ -0,0 +1,31 @@
+#include "Geometry/VertexMemory.hpp"
+
+VertexMemory::VertexMemory() = default;
+
+std::size_t VertexMemory::allocated() const {
+
+    std::scoped_lock lock{ m_mutex };
+    return m_allocated;
+}
+
+void* VertexMemory::do_allocate(std::size_t bytes, std::size_t alignment) {
+
+    std::scoped_lock lock{ m_mutex };
+
+    void* pMemory = m_resource.allocate(bytes, alignment);
+    m_allocated += bytes;
+
+    return pMemory;
+}
+
+void VertexMemory::do_deallocate(void* pMemory, std::size_t bytes, std::size_t alignment) {
+
+    std::scoped_lock lock{ m_mutex };
+
+    m_resource.deallocate(pMemory, bytes, alignment);
+    m_allocated -= bytes;
+}
+
+bool VertexMemory::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+// 64 bit FNV-1a variant that consumes eight bytes per step. Used to fingerprint source files, it is not cryptographic.
+inline std::uint64_t Hash64(std::span<const std::byte> data, std::uint64_t seed = 0xcbf29ce484222325ull) {
+
+    constexpr std::uint64_t kPrime = 0x100000001b3ull;
+
+    std::uint64_t hash = seed;
+
+    std::size_t offset = 0;
+    for (; offset + sizeof(std::uint64_t) <= data.size(); offset += sizeof(std::uint64_t)) {
+
+        std::uint64_t word = 0;
+        std::memcpy(&word, data.data() + offset, sizeof(word));
+
+        hash ^= word;
+        hash *= kPrime;
+        hash ^= hash >> 32;
+    }
+
+    for (; offset < data.size(); ++offset) {
+        hash ^= static_cast<std::uint64_t>(data[offset]);
+        hash *= kPrime;
+    }
+
+    return hash;
+}
+
+inline std::uint64_t Hash64(std::string_view text) {
+    return Hash64(std::as_bytes(std::span{ text.data(), text.size() }));
+}
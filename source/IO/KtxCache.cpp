@@ -0,0 +1,293 @@
+#include "KtxCache.hpp"
+
+#include "MappedFile.hpp"
+#include "TempPath.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <system_error>
+#include <vector>
+
+namespace {
+constexpr std::array<std::uint8_t, 12> kIdentifier{ 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+struct FileHeader {
+    std::array<std::uint8_t, 12> identifier = kIdentifier;
+    std::uint32_t vkFormat = 0;
+    std::uint32_t typeSize = 1;
+    std::uint32_t pixelWidth = 0;
+    std::uint32_t pixelHeight = 0;
+    std::uint32_t pixelDepth = 0;
+    std::uint32_t layerCount = 0;
+    std::uint32_t faceCount = 1;
+    std::uint32_t levelCount = 1;
+    std::uint32_t supercompressionScheme = 0;
+    std::uint32_t dfdByteOffset = 0;
+    std::uint32_t dfdByteLength = 0;
+    std::uint32_t kvdByteOffset = 0;
+    std::uint32_t kvdByteLength = 0;
+    std::uint64_t sgdByteOffset = 0;
+    std::uint64_t sgdByteLength = 0;
+};
+
+struct LevelIndex {
+    std::uint64_t byteOffset = 0;
+    std::uint64_t byteLength = 0;
+    std::uint64_t uncompressedByteLength = 0;
+};
+
+static_assert(sizeof(FileHeader) == 80 && sizeof(LevelIndex) == 24, "KTX2 headers must be tightly packed.");
+
+struct FormatInfo {
+    Texture::Channels format;
+    std::uint32_t vkFormat;
+    std::uint8_t colorModel;
+    std::uint32_t blockBytes; // Bytes per 4x4 block, or per pixel for uncompressed formats
+};
+
+// Vulkan format and Khronos data format descriptor color model for each format the cache stores.
+constexpr std::array<FormatInfo, 10> kFormats{ {
+    { Texture::Channels::R, 9, 1, 1 },
+    { Texture::Channels::RG, 16, 1, 2 },
+    { Texture::Channels::RGB, 23, 1, 3 },
+    { Texture::Channels::RGBA, 37, 1, 4 },
+    { Texture::Channels::BGRA, 44, 1, 4 },
+    { Texture::Channels::BC1, 131, 128, 8 },
+    { Texture::Channels::BC3, 137, 130, 16 },
+    { Texture::Channels::BC4, 139, 131, 8 },
+    { Texture::Channels::BC5, 141, 132, 16 },
+    { Texture::Channels::BC7, 145, 134, 16 },
+} };
+
+const FormatInfo* FindFormat(Texture::Channels format) {
+
+    for (const FormatInfo& info : kFormats) {
+        if (info.format == format)
+            return &info;
+    }
+
+    return nullptr;
+}
+
+const FormatInfo* FindVkFormat(std::uint32_t vkFormat) {
+
+    for (const FormatInfo& info : kFormats) {
+        if (info.vkFormat == vkFormat)
+            return &info;
+    }
+
+    return nullptr;
+}
+
+void Append(std::vector<std::uint8_t>& bytes, std::uint32_t value, std::size_t size) {
+
+    for (std::size_t byte = 0; byte < size; ++byte)
+        bytes.push_back(static_cast<std::uint8_t>(value >> (byte * 8)));
+}
+
+// Basic data format descriptor. Block formats get one sample per 64 bit half of the block, uncompressed formats
+// one per 8 bit channel.
+std::vector<std::uint8_t> MakeDescriptor(const FormatInfo& info) {
+
+    struct Sample {
+        std::uint32_t bitOffset;
+        std::uint32_t bitLength;
+        std::uint32_t channel;
+        std::uint32_t upper;
+    };
+
+    constexpr std::uint32_t kRed = 0;
+    constexpr std::uint32_t kGreen = 1;
+    constexpr std::uint32_t kBlue = 2;
+    constexpr std::uint32_t kAlpha = 15;
+
+    std::vector<Sample> samples;
+    switch (info.format) {
+    case Texture::Channels::R: samples = { { 0, 7, kRed, 255 } }; break;
+    case Texture::Channels::RG: samples = { { 0, 7, kRed, 255 }, { 8, 7, kGreen, 255 } }; break;
+    case Texture::Channels::RGB: samples = { { 0, 7, kRed, 255 }, { 8, 7, kGreen, 255 }, { 16, 7, kBlue, 255 } }; break;
+    case Texture::Channels::RGBA: samples = { { 0, 7, kRed, 255 }, { 8, 7, kGreen, 255 }, { 16, 7, kBlue, 255 }, { 24, 7, kAlpha, 255 } }; break;
+    case Texture::Channels::BGRA: samples = { { 0, 7, kBlue, 255 }, { 8, 7, kGreen, 255 }, { 16, 7, kRed, 255 }, { 24, 7, kAlpha, 255 } }; break;
+    case Texture::Channels::BC3: samples = { { 0, 63, kAlpha, 0xFFFFFFFF }, { 64, 63, kRed, 0xFFFFFFFF } }; break;
+    case Texture::Channels::BC5: samples = { { 0, 63, kRed, 0xFFFFFFFF }, { 64, 63, kGreen, 0xFFFFFFFF } }; break;
+    case Texture::Channels::BC7: samples = { { 0, 127, kRed, 0xFFFFFFFF } }; break;
+    default: samples = { { 0, 63, kRed, 0xFFFFFFFF } }; break;
+    }
+
+    const bool compressed = Texture::IsCompressed(info.format);
+    const auto blockSize = static_cast<std::uint32_t>(24 + samples.size() * 16);
+
+    std::vector<std::uint8_t> bytes;
+    Append(bytes, blockSize + 4, 4);                    // Total size
+    Append(bytes, 0, 4);                                // Khronos vendor, basic descriptor type
+    Append(bytes, 2, 2);                                // Version
+    Append(bytes, blockSize, 2);
+    Append(bytes, info.colorModel, 1);
+    Append(bytes, 1, 1);                                // BT.709 primaries
+    Append(bytes, 1, 1);                                // Linear transfer
+    Append(bytes, 0, 1);                                // Straight alpha
+    Append(bytes, compressed ? 0x00000303 : 0, 4);      // Texel block dimensions minus one
+    Append(bytes, info.blockBytes, 4);
+    Append(bytes, 0, 4);
+
+    for (const Sample& sample : samples) {
+        Append(bytes, sample.bitOffset, 2);
+        Append(bytes, sample.bitLength, 1);
+        Append(bytes, sample.channel, 1);
+        Append(bytes, 0, 4);
+        Append(bytes, 0, 4);
+        Append(bytes, sample.upper, 4);
+    }
+
+    return bytes;
+}
+
+std::uint64_t AlignUp(std::uint64_t offset, std::uint64_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+} // end unnamed namespace
+
+std::filesystem::path KtxCache::CachePath(std::uint64_t sourceHash, const std::filesystem::path& cacheDirectory) {
+
+    std::filesystem::path directory = cacheDirectory;
+    if (directory.empty()) {
+
+        std::error_code error;
+        directory = std::filesystem::temp_directory_path(error);
+        if (error)
+            directory = std::filesystem::current_path(error);
+
+        directory /= "ModelViewer";
+        directory /= "KtxCache";
+    }
+
+    return directory / std::format("{:016x}.ktx2", sourceHash);
+}
+
+std::optional<Image> KtxCache::Read(const std::filesystem::path& cachePath) {
+
+    std::error_code error;
+    if (!std::filesystem::exists(cachePath, error))
+        return std::nullopt;
+
+    const MappedFile file{ cachePath };
+    if (!file.valid())
+        return std::nullopt;
+
+    const std::span<const std::byte> data = file.data();
+
+    FileHeader header;
+    if (data.size() < sizeof(header))
+        return std::nullopt;
+
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    if (header.identifier != kIdentifier || header.supercompressionScheme != 0 || header.pixelDepth != 0 || header.layerCount != 0 || header.faceCount != 1)
+        return std::nullopt;
+
+    const FormatInfo* pFormat = FindVkFormat(header.vkFormat);
+    if (!pFormat)
+        return std::nullopt;
+
+    const unsigned int levelCount = std::max(header.levelCount, 1u);
+    if (levelCount > Image::MaxLevelCount(header.pixelWidth, header.pixelHeight) || data.size() < sizeof(header) + levelCount * sizeof(LevelIndex))
+        return std::nullopt;
+
+    const Image layout{ header.pixelWidth, header.pixelHeight, pFormat->format, {}, levelCount };
+    std::vector<std::uint8_t> pixels(layout.levelOffset(levelCount));
+
+    for (unsigned int level = 0; level < levelCount; ++level) {
+
+        LevelIndex index;
+        std::memcpy(&index, data.data() + sizeof(header) + level * sizeof(LevelIndex), sizeof(index));
+
+        if (index.byteLength != layout.levelSize(level) || index.byteOffset > data.size() || index.byteLength > data.size() - index.byteOffset) {
+            std::cerr << "Warning: Texture cache " << cachePath << " is truncated, ignoring it.\n";
+            return std::nullopt;
+        }
+
+        std::memcpy(pixels.data() + layout.levelOffset(level), data.data() + index.byteOffset, static_cast<std::size_t>(index.byteLength));
+    }
+
+    return Image{ header.pixelWidth, header.pixelHeight, pFormat->format, std::move(pixels), levelCount };
+}
+
+bool KtxCache::Write(const std::filesystem::path& cachePath, const Image& image) {
+
+    const FormatInfo* pFormat = FindFormat(image.channels());
+    if (!pFormat || image.empty() || image.pixels().size() < image.levelOffset(image.levelCount()))
+        return false;
+
+    std::error_code error;
+    if (cachePath.has_parent_path())
+        std::filesystem::create_directories(cachePath.parent_path(), error);
+
+    const std::vector<std::uint8_t> descriptor = MakeDescriptor(*pFormat);
+    const unsigned int levelCount = image.levelCount();
+
+    FileHeader header;
+    header.vkFormat = pFormat->vkFormat;
+    header.pixelWidth = image.width();
+    header.pixelHeight = image.height();
+    header.levelCount = levelCount;
+    header.dfdByteOffset = static_cast<std::uint32_t>(sizeof(FileHeader) + levelCount * sizeof(LevelIndex));
+    header.dfdByteLength = static_cast<std::uint32_t>(descriptor.size());
+
+    // Level data goes smallest first, each level aligned to a whole number of blocks and to 4 bytes.
+    const std::uint64_t alignment = std::lcm<std::uint64_t>(pFormat->blockBytes, 4);
+
+    std::vector<LevelIndex> levels(levelCount);
+    std::uint64_t offset = header.dfdByteOffset + header.dfdByteLength;
+
+    for (unsigned int level = levelCount; level-- > 0;) {
+        offset = AlignUp(offset, alignment);
+        levels[level] = { offset, image.levelSize(level), image.levelSize(level) };
+        offset += levels[level].byteLength;
+    }
+
+    // Write next to the destination and swap it in, so a crash never leaves a half written cache behind.
+    const std::filesystem::path tempPath = TempPath(cachePath);
+
+    {
+        std::ofstream stream{ tempPath, std::ios::binary | std::ios::trunc };
+        if (!stream) {
+            std::cerr << "Warning: Unable to write texture cache " << cachePath << ".\n";
+            return false;
+        }
+
+        static constexpr std::array<char, 16> kPadding{};
+
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        stream.write(reinterpret_cast<const char*>(levels.data()), static_cast<std::streamsize>(levels.size() * sizeof(LevelIndex)));
+        stream.write(reinterpret_cast<const char*>(descriptor.data()), static_cast<std::streamsize>(descriptor.size()));
+
+        std::uint64_t written = header.dfdByteOffset + header.dfdByteLength;
+        for (unsigned int level = levelCount; level-- > 0;) {
+
+            stream.write(kPadding.data(), static_cast<std::streamsize>(levels[level].byteOffset - written));
+            stream.write(reinterpret_cast<const char*>(image.pixels().data() + image.levelOffset(level)), static_cast<std::streamsize>(levels[level].byteLength));
+            written = levels[level].byteOffset + levels[level].byteLength;
+        }
+
+        if (!stream) {
+            std::cerr << "Warning: Unable to write texture cache " << cachePath << ".\n";
+            stream.close();
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error) {
+        std::cerr << "Warning: Unable to write texture cache " << cachePath << ": " << error.message() << "\n";
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    return true;
+}
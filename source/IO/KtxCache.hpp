@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Texture/Image.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+// Processed images, with their mip chains, stored as KTX2 files named after a hash of the encoded source.
+class KtxCache {
+public:
+    // Without a cache directory the files go to a ModelViewer folder in the system temp directory.
+    static std::filesystem::path CachePath(std::uint64_t sourceHash, const std::filesystem::path& cacheDirectory);
+
+    static std::optional<Image> Read(const std::filesystem::path& cachePath);
+    static bool Write(const std::filesystem::path& cachePath, const Image& image);
+};
@@ -0,0 +1,141 @@
+#include "MappedFile.hpp"
+
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct MappedFile::Private {
+    Private() = default;
+    Private(const std::filesystem::path& path);
+    ~Private();
+
+    COPY_MOVE_DISABLED(Private)
+
+    const std::byte* m_pData = nullptr;
+    std::size_t m_size = 0;
+
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#else
+    int m_file = -1;
+#endif
+};
+
+#ifdef _WIN32
+MappedFile::Private::Private(const std::filesystem::path& path) {
+
+    m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Error: Unable to open " << path << " for mapping.\n";
+        return;
+    }
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart == 0)
+        return;
+
+    m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping) {
+        std::cerr << "Error: Unable to create a file mapping for " << path << ".\n";
+        return;
+    }
+
+    m_pData = static_cast<const std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_pData)
+        m_size = static_cast<std::size_t>(fileSize.QuadPart);
+}
+
+MappedFile::Private::~Private() {
+
+    if (m_pData)
+        UnmapViewOfFile(m_pData);
+
+    if (m_mapping)
+        CloseHandle(m_mapping);
+
+    if (m_file != INVALID_HANDLE_VALUE)
+        CloseHandle(m_file);
+}
+#else
+MappedFile::Private::Private(const std::filesystem::path& path) {
+
+    m_file = open(path.c_str(), O_RDONLY);
+    if (m_file < 0) {
+        std::cerr << "Error: Unable to open " << path << " for mapping.\n";
+        return;
+    }
+
+    struct stat status{};
+    if (fstat(m_file, &status) != 0 || status.st_size == 0)
+        return;
+
+    void* pMapped = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, m_file, 0);
+    if (pMapped == MAP_FAILED) {
+        std::cerr << "Error: Unable to map " << path << " into memory.\n";
+        return;
+    }
+
+    // Mapped files are read front to back, let the kernel read ahead aggressively.
+    madvise(pMapped, static_cast<std::size_t>(status.st_size), MADV_SEQUENTIAL);
+
+    m_pData = static_cast<const std::byte*>(pMapped);
+    m_size = static_cast<std::size_t>(status.st_size);
+}
+
+MappedFile::Private::~Private() {
+
+    if (m_pData)
+        munmap(const_cast<std::byte*>(m_pData), m_size);
+
+    if (m_file >= 0)
+        close(m_file);
+}
+#endif
+
+
+MappedFile::MappedFile()
+    : m_pPrivate(std::make_unique<Private>()) {}
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+    : m_pPrivate(std::make_unique<Private>(path)) {}
+
+MappedFile::~MappedFile() noexcept {}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+
+    if (this != &other)
+        m_pPrivate = std::exchange(other.m_pPrivate, nullptr);
+
+    return *this;
+}
+
+bool MappedFile::valid() const {
+    return m_pPrivate && m_pPrivate->m_pData;
+}
+
+std::span<const std::byte> MappedFile::data() const {
+
+    if (!valid())
+        return {};
+
+    return { m_pPrivate->m_pData, m_pPrivate->m_size };
+}
+
+std::size_t MappedFile::size() const {
+    return valid() ? m_pPrivate->m_size : 0;
+}
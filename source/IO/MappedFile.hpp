@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Common/ClassMacros.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+class MappedFile {
+public:
+    MappedFile();
+    explicit MappedFile(const std::filesystem::path& path);
+
+    bool valid() const;
+
+    DECLARE_GETTER_IMMUTABLE_COPY(data, std::span<const std::byte>)
+    DECLARE_GETTER_IMMUTABLE_COPY(size, std::size_t)
+
+private:
+    COMPILATION_FIREWALL_MOVE(MappedFile)
+};
@@ -0,0 +1,413 @@
+#include "MeshCache.hpp"
+
+#include "Hash.hpp"
+#include "MappedFile.hpp"
+#include "TempPath.hpp"
+
+#include "Geometry/VertexBuffer.hpp"
+#include "Geometry/VertexBuffered.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace {
+constexpr std::array<char, 8> kMagic{ 'M', 'V', 'C', 'A', 'C', 'H', 'E', '\0' };
+constexpr std::uint32_t kVersion = 5;
+constexpr std::uint32_t kByteOrderMark = 0x01020304;
+constexpr std::size_t kArrayAlignment = 16;
+
+// Sanity limit on the level count read back, far above what the loader builds.
+constexpr std::uint64_t kMaxLods = 64;
+
+struct FileHeader {
+    std::array<char, 8> magic = kMagic;
+    std::uint32_t version = kVersion;
+    std::uint32_t byteOrder = kByteOrderMark;
+    std::uint64_t sourceSize = 0;
+    std::int64_t sourceWriteTime = 0;
+    std::uint64_t sourceHash = 0;
+    std::uint64_t importFlags = 0;
+    std::uint32_t meshCount = 0;
+    std::uint32_t texturePathCount = 0;
+    std::uint32_t instanceCount = 0;
+    std::uint32_t embeddedTextureCount = 0;
+};
+
+struct MeshHeader {
+    std::uint64_t vertexCount = 0;
+    std::uint64_t normalCount = 0;
+    std::uint64_t texelCount = 0;
+    std::uint64_t colorCount = 0;
+    std::uint64_t indexCount = 0;
+    std::uint64_t lodCount = 0;
+};
+
+struct EmbeddedTexture {
+    std::uint32_t type = 0;
+    std::uint32_t reserved = 0;
+    std::uint64_t key = 0;
+};
+
+struct LodHeader {
+    std::uint64_t indexCount = 0;
+    float error = 0.f;
+    std::uint32_t reserved = 0;
+};
+
+struct SourceStamp {
+    std::uint64_t size = 0;
+    std::int64_t writeTime = 0;
+};
+
+std::optional<SourceStamp> StampSource(const std::filesystem::path& source) {
+
+    std::error_code error;
+
+    const std::uintmax_t size = std::filesystem::file_size(source, error);
+    if (error)
+        return std::nullopt;
+
+    const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(source, error);
+    if (error)
+        return std::nullopt;
+
+    return SourceStamp{ static_cast<std::uint64_t>(size), static_cast<std::int64_t>(writeTime.time_since_epoch().count()) };
+}
+
+std::optional<std::uint64_t> HashSource(const std::filesystem::path& source) {
+
+    const MappedFile file{ source };
+    if (!file.valid())
+        return std::nullopt;
+
+    return Hash64(file.data());
+}
+
+template<typename Indices>
+bool IndicesInRange(const Indices& indices, std::uint64_t vertexCount) {
+    return std::ranges::all_of(indices, [vertexCount](auto index) { return index < vertexCount; });
+}
+
+// Bounds checked cursor over the mapped cache file.
+class Reader {
+public:
+    explicit Reader(std::span<const std::byte> data)
+        : m_data(data) {}
+
+    template<typename T>
+    bool read(T& value) {
+
+        if (m_offset + sizeof(T) > m_data.size())
+            return false;
+
+        std::memcpy(&value, m_data.data() + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return true;
+    }
+
+    template<typename T, typename Allocator>
+    bool readArray(std::vector<T, Allocator>& values, std::uint64_t count) {
+
+        align();
+
+        if (count > (m_data.size() - m_offset) / sizeof(T))
+            return false;
+
+        values.resize(static_cast<std::size_t>(count));
+        std::memcpy(values.data(), m_data.data() + m_offset, values.size() * sizeof(T));
+        m_offset += values.size() * sizeof(T);
+        return true;
+    }
+
+    bool readString(std::string& value, std::uint32_t length) {
+
+        if (length > m_data.size() - m_offset)
+            return false;
+
+        value.assign(reinterpret_cast<const char*>(m_data.data() + m_offset), length);
+        m_offset += length;
+        return true;
+    }
+
+private:
+    void align() {
+        m_offset = std::min(m_data.size(), (m_offset + kArrayAlignment - 1) & ~(kArrayAlignment - 1));
+    }
+
+    std::span<const std::byte> m_data;
+    std::size_t m_offset = 0;
+};
+
+class Writer {
+public:
+    explicit Writer(std::ofstream& stream)
+        : m_stream(stream) {}
+
+    template<typename T>
+    void write(const T& value) {
+        write(&value, sizeof(T));
+    }
+
+    template<typename T, typename Allocator>
+    void writeArray(const std::vector<T, Allocator>& values) {
+
+        align();
+        write(values.data(), values.size() * sizeof(T));
+    }
+
+    void write(const void* pData, std::size_t size) {
+
+        m_stream.write(static_cast<const char*>(pData), static_cast<std::streamsize>(size));
+        m_offset += size;
+    }
+
+private:
+    void align() {
+
+        static constexpr std::array<char, kArrayAlignment> kPadding{};
+
+        const std::size_t padding = ((m_offset + kArrayAlignment - 1) & ~(kArrayAlignment - 1)) - m_offset;
+        write(kPadding.data(), padding);
+    }
+
+    std::ofstream& m_stream;
+    std::size_t m_offset = 0;
+};
+} // end unnamed namespace
+
+std::filesystem::path MeshCache::CachePath(const std::filesystem::path& source, const std::filesystem::path& cacheDirectory) {
+
+    if (cacheDirectory.empty()) {
+        std::filesystem::path cachePath = source;
+        cachePath += ".mvcache";
+        return cachePath;
+    }
+
+    std::error_code error;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(source, error);
+    if (error)
+        canonical = std::filesystem::absolute(source);
+
+    return cacheDirectory / std::format("{:016x}.mvcache", Hash64(canonical.generic_string()));
+}
+
+std::optional<MeshCache::Entry> MeshCache::Read(const std::filesystem::path& cachePath, const std::filesystem::path& source, std::uint64_t importFlags, const std::shared_ptr<std::pmr::memory_resource>& pMemory) {
+
+    std::error_code error;
+    if (!std::filesystem::exists(cachePath, error))
+        return std::nullopt;
+
+    const std::optional<SourceStamp> stamp = StampSource(source);
+    if (!stamp)
+        return std::nullopt;
+
+    const MappedFile file{ cachePath };
+    if (!file.valid())
+        return std::nullopt;
+
+    Reader reader{ file.data() };
+
+    FileHeader header;
+    if (!reader.read(header) || header.magic != kMagic || header.version != kVersion || header.byteOrder != kByteOrderMark)
+        return std::nullopt;
+
+    if (header.importFlags != importFlags || header.sourceSize != stamp->size)
+        return std::nullopt;
+
+    // A touched but otherwise identical source is still a hit, only pay for hashing when the timestamp moved.
+    if (header.sourceWriteTime != stamp->writeTime && HashSource(source) != header.sourceHash)
+        return std::nullopt;
+
+    Entry entry;
+    ModelLoader::ModelProperties& properties = entry.properties;
+    properties.meshes.reserve(header.meshCount);
+
+    for (std::uint32_t meshIndex = 0; meshIndex < header.meshCount; ++meshIndex) {
+
+        MeshHeader meshHeader;
+        if (!reader.read(meshHeader))
+            return std::nullopt;
+
+        VertexBuffer buffer{ pMemory };
+        if (!reader.readArray(buffer.vertices(), meshHeader.vertexCount) ||
+            !reader.readArray(buffer.normals(), meshHeader.normalCount) ||
+            !reader.readArray(buffer.texels(), meshHeader.texelCount) ||
+            !reader.readArray(buffer.colors(), meshHeader.colorCount) ||
+            !reader.readArray(buffer.indices(), meshHeader.indexCount)) {
+            std::cerr << "Warning: Mesh cache " << cachePath << " is truncated, ignoring it.\n";
+            return std::nullopt;
+        }
+
+        const auto perVertex = [&meshHeader](std::uint64_t count) { return count == 0 || count == meshHeader.vertexCount; };
+
+        if (meshHeader.lodCount > kMaxLods || !perVertex(meshHeader.normalCount) || !perVertex(meshHeader.texelCount) || !perVertex(meshHeader.colorCount)) {
+            std::cerr << "Warning: Mesh cache " << cachePath << " is corrupt, ignoring it.\n";
+            return std::nullopt;
+        }
+
+        std::vector<VertexBuffered::Lod> lods(static_cast<std::size_t>(meshHeader.lodCount));
+
+        for (VertexBuffered::Lod& lod : lods) {
+
+            LodHeader lodHeader;
+            if (!reader.read(lodHeader) || !reader.readArray(lod.indices, lodHeader.indexCount)) {
+                std::cerr << "Warning: Mesh cache " << cachePath << " is truncated, ignoring it.\n";
+                return std::nullopt;
+            }
+
+            lod.error = lodHeader.error;
+        }
+
+        // The arrays are uploaded and drawn as is, so an index past the vertices would read outside the buffers.
+        const bool inRange = IndicesInRange(buffer.indices(), meshHeader.vertexCount) &&
+            std::ranges::all_of(lods, [&meshHeader](const VertexBuffered::Lod& lod) { return IndicesInRange(lod.indices, meshHeader.vertexCount); });
+
+        if (!inRange) {
+            std::cerr << "Warning: Mesh cache " << cachePath << " is corrupt, ignoring it.\n";
+            return std::nullopt;
+        }
+
+        properties.meshes.emplace_back(std::move(buffer));
+        properties.meshes.back().lods() = std::move(lods);
+    }
+
+    if (!reader.readArray(properties.instances, header.instanceCount)) {
+        std::cerr << "Warning: Mesh cache " << cachePath << " is truncated, ignoring it.\n";
+        return std::nullopt;
+    }
+
+    if (!std::ranges::all_of(properties.instances, [&properties](const MeshInstance& instance) { return instance.meshIndex < properties.meshes.size(); })) {
+        std::cerr << "Warning: Mesh cache " << cachePath << " is corrupt, ignoring it.\n";
+        return std::nullopt;
+    }
+
+    for (std::uint32_t pathIndex = 0; pathIndex < header.texturePathCount; ++pathIndex) {
+
+        std::uint32_t type = 0;
+        std::uint32_t length = 0;
+        std::string path;
+
+        if (!reader.read(type) || !reader.read(length) || !reader.readString(path, length)) {
+            std::cerr << "Warning: Mesh cache " << cachePath << " is truncated, ignoring it.\n";
+            return std::nullopt;
+        }
+
+        properties.texturePaths.emplace(static_cast<Texture::Type>(type), std::filesystem::path{ std::u8string{ path.cbegin(), path.cend() } });
+    }
+
+    for (std::uint32_t textureIndex = 0; textureIndex < header.embeddedTextureCount; ++textureIndex) {
+
+        EmbeddedTexture texture;
+        if (!reader.read(texture)) {
+            std::cerr << "Warning: Mesh cache " << cachePath << " is truncated, ignoring it.\n";
+            return std::nullopt;
+        }
+
+        entry.embeddedTextures.emplace(static_cast<Texture::Type>(texture.type), texture.key);
+    }
+
+    return entry;
+}
+
+bool MeshCache::Write(const std::filesystem::path& cachePath, const std::filesystem::path& source, std::uint64_t importFlags, const ModelLoader::ModelProperties& properties, const EmbeddedTextures& embeddedTextures) {
+
+    const std::optional<SourceStamp> stamp = StampSource(source);
+    const std::optional<std::uint64_t> sourceHash = HashSource(source);
+    if (!stamp || !sourceHash)
+        return false;
+
+    std::error_code error;
+    if (cachePath.has_parent_path())
+        std::filesystem::create_directories(cachePath.parent_path(), error);
+
+    // Write next to the destination and swap it in, so a crash never leaves a half written cache behind.
+    const std::filesystem::path tempPath = TempPath(cachePath);
+
+    {
+        std::ofstream stream{ tempPath, std::ios::binary | std::ios::trunc };
+        if (!stream) {
+            std::cerr << "Warning: Unable to write mesh cache " << cachePath << ".\n";
+            return false;
+        }
+
+        FileHeader header;
+        header.sourceSize = stamp->size;
+        header.sourceWriteTime = stamp->writeTime;
+        header.sourceHash = *sourceHash;
+        header.importFlags = importFlags;
+        header.meshCount = static_cast<std::uint32_t>(properties.meshes.size());
+        header.texturePathCount = static_cast<std::uint32_t>(properties.texturePaths.size());
+        header.instanceCount = static_cast<std::uint32_t>(properties.instances.size());
+        header.embeddedTextureCount = static_cast<std::uint32_t>(embeddedTextures.size());
+
+        Writer writer{ stream };
+        writer.write(header);
+
+        for (const VertexBuffered& mesh : properties.meshes) {
+
+            const VertexBuffer& buffer = mesh.buffer();
+
+            MeshHeader meshHeader;
+            meshHeader.vertexCount = buffer.vertices().size();
+            meshHeader.normalCount = buffer.normals().size();
+            meshHeader.texelCount = buffer.texels().size();
+            meshHeader.colorCount = buffer.colors().size();
+            meshHeader.indexCount = buffer.indices().size();
+            meshHeader.lodCount = mesh.lods().size();
+
+            writer.write(meshHeader);
+            writer.writeArray(buffer.vertices());
+            writer.writeArray(buffer.normals());
+            writer.writeArray(buffer.texels());
+            writer.writeArray(buffer.colors());
+            writer.writeArray(buffer.indices());
+
+            for (const VertexBuffered::Lod& lod : mesh.lods()) {
+
+                LodHeader lodHeader;
+                lodHeader.indexCount = lod.indices.size();
+                lodHeader.error = lod.error;
+
+                writer.write(lodHeader);
+                writer.writeArray(lod.indices);
+            }
+        }
+
+        writer.writeArray(properties.instances);
+
+        for (const auto& [type, path] : properties.texturePaths) {
+
+            const std::u8string utf8 = path.u8string();
+
+            writer.write(static_cast<std::uint32_t>(type));
+            writer.write(static_cast<std::uint32_t>(utf8.size()));
+            writer.write(utf8.data(), utf8.size());
+        }
+
+        for (const auto& [type, key] : embeddedTextures)
+            writer.write(EmbeddedTexture{ static_cast<std::uint32_t>(type), 0, key });
+
+        if (!stream) {
+            std::cerr << "Warning: Unable to write mesh cache " << cachePath << ".\n";
+            stream.close();
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error) {
+        std::cerr << "Warning: Unable to write mesh cache " << cachePath << ": " << error.message() << "\n";
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    return true;
+}
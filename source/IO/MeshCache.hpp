@@ -0,0 +1,28 @@
+#pragma once
+
+#include "IO/ModelLoader.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <unordered_map>
+
+// Binary snapshot of an imported model. Lets repeat loads of an unchanged source skip Assimp entirely.
+class MeshCache {
+public:
+    // Location of the cache file for the given source. Without a cache directory it lives next to the source.
+    static std::filesystem::path CachePath(const std::filesystem::path& source, const std::filesystem::path& cacheDirectory);
+
+    // Embedded textures live in the KTX cache, the mesh cache only keeps the key of each one.
+    using EmbeddedTextures = std::unordered_map<Texture::Type, std::uint64_t>;
+
+    struct Entry {
+        ModelLoader::ModelProperties properties;
+        EmbeddedTextures embeddedTextures;
+    };
+
+    static std::optional<Entry> Read(const std::filesystem::path& cachePath, const std::filesystem::path& source, std::uint64_t importFlags, const std::shared_ptr<std::pmr::memory_resource>& pMemory);
+    static bool Write(const std::filesystem::path& cachePath, const std::filesystem::path& source, std::uint64_t importFlags, const ModelLoader::ModelProperties& properties, const EmbeddedTextures& embeddedTextures);
+};
@@ -1,50 +1,261 @@
 #include "IO/ModelLoader.hpp"
 #include "IO/TextureLoader.hpp"
 
-#include "Geometry/VertexBuffer.hpp"
+#include "Hash.hpp"
+#include "KtxCache.hpp"
+#include "MeshCache.hpp"
+#include "ObjParser.hpp"
+#include "PlyParser.hpp"
+#include "StlParser.hpp"
+
+#include "Common/ThreadPool.hpp"
 
+#include "Geometry/VertexBuffer.hpp"
+#include "Geometry/VertexMemory.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstring>
 #include <filesystem>
+#include <format>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <stack>
 #include <sstream>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
+#include <assimp/ProgressHandler.hpp>
 #include <assimp/scene.h>
 
+#include <glm/mat4x4.hpp>
+
+namespace {
+// Assimp matrices are row major, glm is column major.
+glm::mat4 ToGlm(const aiMatrix4x4& matrix) {
+    return {
+        matrix.a1, matrix.b1, matrix.c1, matrix.d1,
+        matrix.a2, matrix.b2, matrix.c2, matrix.d2,
+        matrix.a3, matrix.b3, matrix.c3, matrix.d3,
+        matrix.a4, matrix.b4, matrix.c4, matrix.d4
+    };
+}
+
+// Share of the overall progress reported while Assimp reads and post-processes the file.
+constexpr float kImportShare = .8f;
+
+// Cache key bits for the loader's own passes, above the 32 used by Assimp's post-processing flags.
+constexpr std::uint64_t kOptimizeGeometryFlag = std::uint64_t{ 1 } << 32;
+constexpr std::uint64_t kGenerateLodsFlag = std::uint64_t{ 1 } << 33;
+
+// Forwards Assimp's progress to a ModelLoader::ProgressCallback, and aborts the import when it asks to cancel.
+// Progress is mapped into the import's share and never moves backwards. Also notes when post-processing starts, so
+// the single pass Assimp makes can be timed as reading and post-processing.
+class ProgressForwarder : public Assimp::ProgressHandler {
+public:
+    explicit ProgressForwarder(const ModelLoader::ProgressCallback& callback)
+        : m_callback(callback) {}
+
+    virtual bool Update(float percentage) override {
+
+        if (percentage >= 0.f)
+            m_progress = std::max(m_progress, std::clamp(percentage, 0.f, 1.f) * kImportShare);
+
+        m_cancelled = m_callback && !m_callback(m_progress);
+        return !m_cancelled;
+    }
+
+    virtual void UpdatePostProcess(int currentStep, int numberOfSteps) override {
+
+        if (!m_postProcessStart)
+            m_postProcessStart = std::chrono::steady_clock::now();
+
+        ProgressHandler::UpdatePostProcess(currentStep, numberOfSteps);
+    }
+
+    bool cancelled() const { return m_cancelled; }
+
+    const std::optional<std::chrono::steady_clock::time_point>& postProcessStart() const { return m_postProcessStart; }
+
+private:
+    const ModelLoader::ProgressCallback& m_callback;
+    std::optional<std::chrono::steady_clock::time_point> m_postProcessStart;
+    float m_progress = 0.f;
+    bool m_cancelled = false;
+};
+
+// Assimp orders the steps itself and runs them in one pass, applying them one at a time changes what they produce.
+unsigned int PostProcessFlags(ModelLoader::Profile profile) {
+
+    using enum ModelLoader::Profile;
+
+    switch (profile) {
+    case FastPreview:
+        return aiProcess_Triangulate | aiProcess_GenNormals;
+    case Balanced:
+        return aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices | aiProcess_SplitLargeMeshes;
+    case FullQuality:
+    default:
+        return aiProcess_Triangulate | aiProcess_FindDegenerates | aiProcess_FindInvalidData | aiProcess_OptimizeMeshes
+            | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices | aiProcess_SplitLargeMeshes;
+    }
+}
+
+// Materials only have one map of each type, these are the ones decoded with the model.
+constexpr std::array<Texture::Type, 3> kDecodedTypes{ Texture::Type::Diffuse, Texture::Type::Emissive, Texture::Type::Specular };
+
+// Part of the KTX cache key of embedded textures, bump along with the texture encoder's version.
+constexpr int kEmbeddedVersion = 1;
+
+// A texture decoding on the pool.
+struct PendingTexture {
+    Texture::Type type = Texture::Type::Unknown;
+    std::filesystem::path path;
+    std::future<std::optional<Image>> image;
+};
+
+// A height of zero means the texels hold a compressed file of mWidth bytes, otherwise they are raw BGRA8888.
+std::optional<Image> DecodeEmbedded(const aiTexture& texture, const TextureLoader::Processing& processing, ThreadPool& pool) {
+
+    static_assert(sizeof(aiTexel) == 4);
+
+    if (!texture.pcData)
+        return std::nullopt;
+
+    if (texture.mHeight == 0)
+        return TextureLoader::decode(std::span{ reinterpret_cast<const std::byte*>(texture.pcData), texture.mWidth }, false, processing, pool);
+
+    const auto pTexels = reinterpret_cast<const std::uint8_t*>(texture.pcData);
+    const std::size_t size = static_cast<std::size_t>(texture.mWidth) * texture.mHeight * sizeof(aiTexel);
+
+    return TextureLoader::process(Image{ texture.mWidth, texture.mHeight, Texture::Channels::BGRA, std::vector<std::uint8_t>(pTexels, pTexels + size) }, processing, pool);
+}
+
+// Key of an embedded texture's processed pixels in the KTX cache, which lets cached models keep them.
+std::uint64_t EmbeddedKey(const aiTexture& texture, const TextureLoader::Processing& processing) {
+
+    const std::size_t size = texture.mHeight == 0 ? texture.mWidth : static_cast<std::size_t>(texture.mWidth) * texture.mHeight * sizeof(aiTexel);
+    const std::uint64_t seed = Hash64(std::format("{}:{}x{}:{}:{}:{}", kEmbeddedVersion, texture.mWidth, texture.mHeight, processing.mipmaps, processing.compress, processing.highQuality));
+
+    return Hash64(std::span{ reinterpret_cast<const std::byte*>(texture.pcData), size }, seed);
+}
+
+// Workers shared by a loader and its copies, started by the first load that needs them.
+struct SharedPool {
+    std::once_flag started;
+    std::unique_ptr<ThreadPool> pPool;
+};
+
+// Times a single import stage and records it.
+class StageTimer {
+public:
+    StageTimer(std::vector<ModelLoader::StageTiming>& timings, const char* name)
+        : m_timings(timings), m_name(name), m_start(std::chrono::steady_clock::now()) {}
+
+    ~StageTimer() {
+        const std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - m_start;
+        m_timings.push_back({ m_name, elapsed.count() });
+    }
+
+    COPY_MOVE_DISABLED(StageTimer)
+
+private:
+    std::vector<ModelLoader::StageTiming>& m_timings;
+    const char* m_name = "";
+    std::chrono::steady_clock::time_point m_start;
+};
+} // end unnamed namespace
+
 struct ModelLoader::Private {
 
-    ModelLoader::ModelProperties importMesh(aiNode* pNode, const aiScene* pScene) const;
-    VertexBuffered processMesh(aiMesh* pMesh, const aiScene* pScene) const;
-    void getTexturePathsByType(aiMaterial* pMaterial, aiTextureType textureType, std::unordered_multimap<Texture::Type, std::filesystem::path>& paths) const;
+    std::optional<ModelLoader::ModelProperties> importMesh(const std::filesystem::path& path, aiNode* pNode, const aiScene* pScene, const ProgressCallback& progress, const std::shared_ptr<std::pmr::memory_resource>& pMemory) const;
+    VertexBuffered processMesh(aiMesh* pMesh, const aiScene* pScene, const std::shared_ptr<std::pmr::memory_resource>& pMemory) const;
+    void getTexturePathsByType(aiMaterial* pMaterial, aiTextureType textureType, const aiScene* pScene, std::unordered_multimap<Texture::Type, std::filesystem::path>& paths) const;
     Texture::Type mapAiTextureType(aiTextureType type) const;
 
+    std::vector<PendingTexture> decodeTextures(const std::filesystem::path& modelPath, const std::unordered_multimap<Texture::Type, std::filesystem::path>& texturePaths, const aiScene* pScene = nullptr) const;
+    void collectTextures(std::vector<PendingTexture>& pending, ModelProperties& properties) const;
+
+    // Stores the embedded textures the model uses in the KTX cache, and returns their keys. Nothing when one couldn't be stored.
+    std::optional<MeshCache::EmbeddedTextures> cacheEmbeddedTextures(const aiScene* pScene, const ModelProperties& properties) const;
+
+    // Returns false when one of the textures is no longer in the KTX cache.
+    bool readEmbeddedTextures(const MeshCache::EmbeddedTextures& embeddedTextures, ModelProperties& properties) const;
+
+    void optimizeGeometry(ModelProperties& properties) const;
+    void buildLods(ModelProperties& properties) const;
+
+    // Applies the loader's settings to the meshes however they were loaded, and hands over the timings.
+    void finish(ModelProperties& properties, std::vector<StageTiming>&& timings) const;
+
+    // Started on first use, safe from concurrent loads. Copies share the workers until one changes its worker count.
+    ThreadPool& pool() const;
+
+    // Memory for the vertex buffers of one import, or none to keep them on the heap.
+    std::shared_ptr<std::pmr::memory_resource> geometryMemory() const;
+
+    Profile m_profile = Profile::FullQuality;
+
+    std::filesystem::path m_cacheDirectory;
+    bool m_cacheEnabled = true;
+    bool m_decodeTextures = true;
+    bool m_optimizeGeometry = true;
+    bool m_generateLods = true;
+    bool m_pooledGeometry = false;
+    TextureLoader::Processing m_textureProcessing;
+    TextureFilter m_textureFilter;
+    VertexEncoding m_vertexEncoding = VertexEncoding::Float;
+
+    std::size_t m_workerCount = 0;
+    std::shared_ptr<SharedPool> m_pPool = std::make_shared<SharedPool>();
 };
 
-ModelLoader::ModelProperties ModelLoader::Private::importMesh(aiNode* pRoot, const aiScene* pScene) const {
+std::optional<ModelLoader::ModelProperties> ModelLoader::Private::importMesh(const std::filesystem::path& path, aiNode* pRoot, const aiScene* pScene, const ProgressCallback& progress, const std::shared_ptr<std::pmr::memory_resource>& pMemory) const {
 
     ModelProperties properties;
 
-    std::stack<aiNode*> nodes;
-    std::unordered_map<aiNode*, bool> visited;
+    std::stack<std::pair<aiNode*, glm::mat4>> nodes;
+    std::unordered_set<aiNode*> visited;
+
+    // Scene mesh index to the index of its converted mesh. Each aiMesh is converted once, however many nodes use it.
+    std::unordered_map<unsigned int, std::uint32_t> meshSlots;
+    std::vector<aiMesh*> meshes;
 
-    nodes.push(pRoot);
+    // Gather the meshes in traversal order first, so the parallel conversion below fills deterministic slots.
+    nodes.emplace(pRoot, glm::mat4{ 1.f });
     while (!nodes.empty()) {
 
-        aiNode* pNode = nodes.top();
-        
-        if (visited[pNode])
+        const auto [pNode, parentTransform] = nodes.top();
+        nodes.pop();
+
+        if (!visited.insert(pNode).second)
             continue;
 
-        visited[pNode] = true;
-        nodes.pop();
+        const glm::mat4 transform = parentTransform * ToGlm(pNode->mTransformation);
 
         for (unsigned int meshIndex = 0; meshIndex < pNode->mNumMeshes; ++meshIndex) {
 
-            aiMesh* pMesh = pScene->mMeshes[pNode->mMeshes[meshIndex]];
-            properties.meshes.push_front(processMesh(pMesh, pScene));
+            const unsigned int sceneMeshIndex = pNode->mMeshes[meshIndex];
+
+            const auto [slotIter, inserted] = meshSlots.emplace(sceneMeshIndex, static_cast<std::uint32_t>(meshes.size()));
+            properties.instances.push_back({ slotIter->second, transform });
+
+            if (!inserted)
+                continue;
+
+            aiMesh* pMesh = pScene->mMeshes[sceneMeshIndex];
+            meshes.push_back(pMesh);
 
             if (pMesh->mMaterialIndex >= 0) {
 
@@ -54,63 +265,124 @@ ModelLoader::ModelProperties ModelLoader::Private::importMesh(aiNode* pRoot, con
                     if (!pMaterial)
                         continue;
 
-                    getTexturePathsByType(pMaterial, static_cast<aiTextureType>(typeIndex), properties.texturePaths);
+                    getTexturePathsByType(pMaterial, static_cast<aiTextureType>(typeIndex), pScene, properties.texturePaths);
                 }
             }
         }
 
         // Add all children so we can process their meshes too.
         for (unsigned int childIndex = 0; childIndex < pNode->mNumChildren; ++childIndex)
-            nodes.push(pNode->mChildren[childIndex]);
+            nodes.emplace(pNode->mChildren[childIndex], transform);
+    }
+
+    // Queued ahead of the conversion, so free workers decode textures while the rest convert geometry.
+    std::vector<PendingTexture> pendingTextures = decodeTextures(path, properties.texturePaths, pScene);
+
+    properties.meshes.resize(meshes.size());
+
+    std::atomic<std::size_t> convertedCount = 0;
+    std::atomic<bool> cancelled = false;
+    std::mutex progressMutex;
+
+    pool().parallelFor(meshes.size(), [&](std::size_t index) {
+
+        if (cancelled)
+            return;
+
+        properties.meshes[index] = processMesh(meshes[index], pScene, pMemory);
+
+        if (progress) {
+            const float fraction = static_cast<float>(++convertedCount) / static_cast<float>(meshes.size());
+
+            std::scoped_lock lock{ progressMutex };
+            if (!progress(kImportShare + fraction * (1.f - kImportShare)))
+                cancelled = true;
+        }
+    });
+
+    // Embedded decodes read the scene, which the importer frees once this returns.
+    if (cancelled) {
+        for (PendingTexture& texture : pendingTextures)
+            texture.image.wait();
+
+        return std::nullopt;
     }
 
+    collectTextures(pendingTextures, properties);
     return properties;
 }
 
-VertexBuffered ModelLoader::Private::processMesh(aiMesh* pMesh, const aiScene* pScene) const {
+ThreadPool& ModelLoader::Private::pool() const {
 
-    VertexBuffer buffer;
+    std::call_once(m_pPool->started, [this] { m_pPool->pPool = std::make_unique<ThreadPool>(m_workerCount); });
+    return *m_pPool->pPool;
+}
 
-    for (unsigned int vertIndex = 0; vertIndex < pMesh->mNumVertices; ++vertIndex) {
+std::shared_ptr<std::pmr::memory_resource> ModelLoader::Private::geometryMemory() const {
 
-        if (pMesh->HasPositions()) {
-            const aiVector3D& vertex = pMesh->mVertices[vertIndex];
-            buffer.addVertex({ vertex.x, vertex.y , vertex.z });
-        }
+    if (!m_pooledGeometry)
+        return nullptr;
 
-        if (pMesh->HasNormals()) {
-            const aiVector3D& normal = pMesh->mNormals[vertIndex];
-            buffer.addNormal({ normal.x, normal.y, normal.z });
-        }
+    return std::make_shared<VertexMemory>();
+}
 
-        // Only support the first set out of many.
-        static constexpr unsigned int kSetIndex = 0;
+VertexBuffered ModelLoader::Private::processMesh(aiMesh* pMesh, const aiScene* pScene, const std::shared_ptr<std::pmr::memory_resource>& pMemory) const {
 
-        if (pMesh->HasTextureCoords(kSetIndex)) {
-            const aiVector3D& texel = pMesh->mTextureCoords[kSetIndex][vertIndex];
-            buffer.addTexel({ texel.x, texel.y });
-        }
+    // Assimp vectors and colors are plain float triples / quads, so whole arrays can be copied as glm types.
+    static_assert(sizeof(aiVector3D) == sizeof(glm::vec3) && alignof(aiVector3D) <= alignof(glm::vec3));
+    static_assert(sizeof(aiColor4D) == sizeof(glm::vec4) && alignof(aiColor4D) <= alignof(glm::vec4));
+    static_assert(sizeof(*aiFace::mIndices) == sizeof(uint32_t));
 
-        if (pMesh->HasVertexColors(kSetIndex)) {
-            const aiColor4D& color = pMesh->mColors[kSetIndex][vertIndex];
-            buffer.addColor({ color.r, color.g, color.b, color.a });
-        }
+    // Only support the first set out of many.
+    static constexpr unsigned int kSetIndex = 0;
+
+    const std::size_t vertexCount = pMesh->mNumVertices;
+
+    std::size_t indexCount = 0;
+    for (unsigned int faceIndex = 0; faceIndex < pMesh->mNumFaces; ++faceIndex)
+        indexCount += pMesh->mFaces[faceIndex].mNumIndices;
+
+    VertexBuffer buffer{ pMemory };
+    buffer.reserve(vertexCount, indexCount, pMesh->HasNormals(), pMesh->HasTextureCoords(kSetIndex), pMesh->HasVertexColors(kSetIndex));
+
+    if (pMesh->HasPositions())
+        buffer.addVertices({ reinterpret_cast<const glm::vec3*>(pMesh->mVertices), vertexCount });
+
+    if (pMesh->HasNormals())
+        buffer.addNormals({ reinterpret_cast<const glm::vec3*>(pMesh->mNormals), vertexCount });
+
+    if (pMesh->HasVertexColors(kSetIndex))
+        buffer.addColors({ reinterpret_cast<const glm::vec4*>(pMesh->mColors[kSetIndex]), vertexCount });
+
+    // Texels are stored as 3D coordinates by Assimp, so they need a strided copy.
+    if (pMesh->HasTextureCoords(kSetIndex)) {
+
+        std::pmr::vector<glm::vec2>& texels = buffer.texels();
+        texels.resize(vertexCount);
+
+        const aiVector3D* pTexels = pMesh->mTextureCoords[kSetIndex];
+        for (std::size_t index = 0; index < vertexCount; ++index)
+            texels[index] = { pTexels[index].x, pTexels[index].y };
     }
 
-    if (pMesh->HasFaces())
-    {
-        for (unsigned int faceIndex = 0; faceIndex < pMesh->mNumFaces; ++faceIndex)
-        {
+    if (pMesh->HasFaces()) {
+
+        std::pmr::vector<uint32_t>& indices = buffer.indices();
+        indices.resize(indexCount);
+
+        uint32_t* pDestination = indices.data();
+        for (unsigned int faceIndex = 0; faceIndex < pMesh->mNumFaces; ++faceIndex) {
+
             const aiFace& face = pMesh->mFaces[faceIndex];
-            for (unsigned int index = 0; index < face.mNumIndices; ++index)
-                buffer.addIndex(face.mIndices[index]);
+            std::memcpy(pDestination, face.mIndices, face.mNumIndices * sizeof(uint32_t));
+            pDestination += face.mNumIndices;
         }
     }
 
     return buffer;
 }
 
-void ModelLoader::Private::getTexturePathsByType(aiMaterial* pMaterial, aiTextureType textureType, std::unordered_multimap<Texture::Type, std::filesystem::path>& paths) const {
+void ModelLoader::Private::getTexturePathsByType(aiMaterial* pMaterial, aiTextureType textureType, const aiScene* pScene, std::unordered_multimap<Texture::Type, std::filesystem::path>& paths) const {
     
     if (!pMaterial)
         return;
@@ -119,11 +391,152 @@ void ModelLoader::Private::getTexturePathsByType(aiMaterial* pMaterial, aiTextur
         aiString name;
         pMaterial->GetTexture(textureType, index, &name);
 
-        if (const std::filesystem::path path = name.C_Str(); path.has_filename())
+        // Embedded textures keep their full reference ("*0" or the original file name), it's how the scene looks them up.
+        if (pScene->GetEmbeddedTexture(name.C_Str()))
+            paths.emplace(mapAiTextureType(textureType), name.C_Str());
+        else if (const std::filesystem::path path = name.C_Str(); path.has_filename())
             paths.emplace(mapAiTextureType(textureType), path.filename());
     }
 }
 
+std::vector<PendingTexture> ModelLoader::Private::decodeTextures(const std::filesystem::path& modelPath, const std::unordered_multimap<Texture::Type, std::filesystem::path>& texturePaths, const aiScene* pScene) const {
+
+    std::vector<PendingTexture> pending;
+    if (!m_decodeTextures)
+        return pending;
+
+    // The first path of each type wins.
+    for (const Texture::Type type : kDecodedTypes) {
+
+        const auto foundIter = texturePaths.find(type);
+        if (foundIter == texturePaths.cend())
+            continue;
+
+        std::filesystem::path texturePath = foundIter->second;
+
+        // Embedded textures are read straight out of the scene, callers wait on the decodes before releasing it.
+        if (const aiTexture* pTexture = pScene ? pScene->GetEmbeddedTexture(texturePath.string().c_str()) : nullptr; pTexture) {
+            pending.push_back({ type, std::move(texturePath), pool().submit([this, pTexture] { return DecodeEmbedded(*pTexture, m_textureProcessing, pool()); }) });
+            continue;
+        }
+
+        if (texturePath.is_relative())
+            texturePath = modelPath.parent_path() / texturePath;
+
+        if (m_textureFilter && !m_textureFilter(texturePath))
+            continue;
+
+        std::future<std::optional<Image>> image = pool().submit([this, texturePath] { return TextureLoader::decode(texturePath, false, m_textureProcessing, pool()); });
+        pending.push_back({ type, std::move(texturePath), std::move(image) });
+    }
+
+    return pending;
+}
+
+void ModelLoader::Private::collectTextures(std::vector<PendingTexture>& pending, ModelProperties& properties) const {
+
+    for (PendingTexture& texture : pending) {
+
+        std::optional<Image> image = texture.image.get();
+        if (!image) {
+            std::cerr << "Warning: Unable to load texture " << texture.path << ".\n";
+            continue;
+        }
+
+        properties.textures.emplace(texture.type, std::move(*image));
+    }
+}
+
+std::optional<MeshCache::EmbeddedTextures> ModelLoader::Private::cacheEmbeddedTextures(const aiScene* pScene, const ModelProperties& properties) const {
+
+    MeshCache::EmbeddedTextures embeddedTextures;
+
+    for (const Texture::Type type : kDecodedTypes) {
+
+        const auto pathIter = properties.texturePaths.find(type);
+        if (pathIter == properties.texturePaths.cend())
+            continue;
+
+        const aiTexture* pTexture = pScene->GetEmbeddedTexture(pathIter->second.string().c_str());
+        if (!pTexture || !pTexture->pcData)
+            continue;
+
+        const std::uint64_t key = EmbeddedKey(*pTexture, m_textureProcessing);
+        const std::filesystem::path cachePath = KtxCache::CachePath(key, m_textureProcessing.cacheDirectory);
+
+        std::error_code error;
+        if (!std::filesystem::exists(cachePath, error)) {
+
+            // The import decoded it already unless texture decoding is off.
+            std::optional<Image> decoded;
+            const auto imageIter = properties.textures.find(type);
+            if (imageIter == properties.textures.cend())
+                decoded = DecodeEmbedded(*pTexture, m_textureProcessing, pool());
+
+            const Image* pImage = imageIter != properties.textures.cend() ? &imageIter->second : decoded ? &*decoded : nullptr;
+            if (!pImage)
+                continue;
+
+            if (!KtxCache::Write(cachePath, *pImage))
+                return std::nullopt;
+        }
+
+        embeddedTextures.emplace(type, key);
+    }
+
+    return embeddedTextures;
+}
+
+bool ModelLoader::Private::readEmbeddedTextures(const MeshCache::EmbeddedTextures& embeddedTextures, ModelProperties& properties) const {
+
+    if (!m_decodeTextures)
+        return true;
+
+    for (const auto& [type, key] : embeddedTextures) {
+
+        std::optional<Image> image = KtxCache::Read(KtxCache::CachePath(key, m_textureProcessing.cacheDirectory));
+        if (!image)
+            return false;
+
+        properties.textures.insert_or_assign(type, std::move(*image));
+    }
+
+    return true;
+}
+
+void ModelLoader::Private::optimizeGeometry(ModelProperties& properties) const {
+
+    std::vector<MeshOptimizer::Report> reports(properties.meshes.size());
+
+    pool().parallelFor(properties.meshes.size(), [&](std::size_t index) {
+
+        VertexBuffered& mesh = properties.meshes[index];
+        if (mesh.primativeType() == VertexBuffered::PrimativeType::Triangles)
+            reports[index] = MeshOptimizer::Optimize(mesh.buffer());
+    });
+
+    properties.vertexCache.emplace();
+    for (const MeshOptimizer::Report& report : reports)
+        *properties.vertexCache += report;
+}
+
+void ModelLoader::Private::buildLods(ModelProperties& properties) const {
+    pool().parallelFor(properties.meshes.size(), [&properties](std::size_t index) { properties.meshes[index].buildLods(); });
+}
+
+void ModelLoader::Private::finish(ModelProperties& properties, std::vector<StageTiming>&& timings) const {
+
+    for (VertexBuffered& mesh : properties.meshes)
+        mesh.encoding(m_vertexEncoding);
+
+    {
+        StageTimer timer{ timings, "Build meshlets" };
+        pool().parallelFor(properties.meshes.size(), [&properties](std::size_t index) { properties.meshes[index].buildMeshlets(); });
+    }
+
+    properties.stageTimings = std::move(timings);
+}
+
 Texture::Type ModelLoader::Private::mapAiTextureType(aiTextureType type) const {
     switch (type) {
     case aiTextureType_DIFFUSE: return Texture::Type::Diffuse;
@@ -180,25 +593,218 @@ ModelLoader& ModelLoader::operator=(ModelLoader&& other) noexcept {
     return *this;
 }
 
-ModelLoader::ModelProperties ModelLoader::load(const std::filesystem::path& path) const {
+ModelLoader::ModelProperties ModelLoader::load(const std::filesystem::path& path, const ProgressCallback& progress) const {
+
+    const unsigned int postProcessingFlags = PostProcessFlags(m_pPrivate->m_profile);
+
+    // Our own passes change what gets cached, so they're keyed alongside Assimp's steps.
+    std::uint64_t importFlags = postProcessingFlags;
+    if (m_pPrivate->m_optimizeGeometry)
+        importFlags |= kOptimizeGeometryFlag;
+
+    if (m_pPrivate->m_generateLods)
+        importFlags |= kGenerateLodsFlag;
 
-    constexpr unsigned int kPostProcessingFlags =
-        aiProcess_Triangulate |
-        aiProcess_GenSmoothNormals |
-        aiProcess_OptimizeGraph |
-        aiProcess_OptimizeMeshes |
-        aiProcess_JoinIdenticalVertices |
-        aiProcess_SplitLargeMeshes |
-        aiProcess_FindDegenerates |
-        aiProcess_FindInvalidData;
+    std::vector<StageTiming> timings;
+
+    // Shared by every mesh of this import and released with the last of them.
+    const std::shared_ptr<std::pmr::memory_resource> pMemory = m_pPrivate->geometryMemory();
+
+    // Formats with a native parser skip Assimp and the mesh cache, they already parse at close to disk speed.
+    // Anything the parsers don't understand falls through to Assimp.
+    std::string extension = path.extension().string();
+    std::ranges::transform(extension, extension.begin(), [](unsigned char character) { return static_cast<char>(std::tolower(character)); });
+
+    using NativeParser = std::optional<ModelProperties>(*)(const std::filesystem::path&, ThreadPool&, const std::shared_ptr<std::pmr::memory_resource>&, const ProgressCallback&);
+    NativeParser pParser = nullptr;
+
+    if (extension == ".obj")
+        pParser = &ObjParser::Parse;
+    else if (extension == ".ply")
+        pParser = &PlyParser::Parse;
+    else if (extension == ".stl")
+        pParser = &StlParser::Parse;
+
+    if (pParser) {
+
+        if (progress && !progress(0.f))
+            return {};
+
+        // Parsing takes the import's share, a parser returns nothing both when cancelled and when it gives up.
+        bool cancelled = false;
+        ProgressCallback parseProgress;
+        if (progress) {
+            parseProgress = [&progress, &cancelled](float fraction) {
+                cancelled = !progress(fraction * kImportShare);
+                return !cancelled;
+            };
+        }
+
+        std::optional<ModelProperties> parsed;
+        {
+            StageTimer timer{ timings, "Parse" };
+            parsed = pParser(path, m_pPrivate->pool(), pMemory, parseProgress);
+        }
+
+        if (cancelled)
+            return {};
+
+        if (parsed) {
+
+            if (m_pPrivate->m_optimizeGeometry) {
+                StageTimer timer{ timings, "Optimize geometry" };
+                m_pPrivate->optimizeGeometry(*parsed);
+            }
+
+            if (m_pPrivate->m_generateLods) {
+                StageTimer timer{ timings, "Build LODs" };
+                m_pPrivate->buildLods(*parsed);
+            }
+
+            {
+                StageTimer timer{ timings, "Decode textures" };
+                std::vector<PendingTexture> pendingTextures = m_pPrivate->decodeTextures(path, parsed->texturePaths);
+                m_pPrivate->collectTextures(pendingTextures, *parsed);
+            }
+
+            if (progress && !progress(1.f))
+                return {};
+
+            m_pPrivate->finish(*parsed, std::move(timings));
+            return std::move(*parsed);
+        }
+    }
+
+    std::filesystem::path cachePath;
+    if (m_pPrivate->m_cacheEnabled) {
+
+        cachePath = MeshCache::CachePath(path, m_pPrivate->m_cacheDirectory);
+
+        std::optional<MeshCache::Entry> cached;
+        {
+            StageTimer timer{ timings, "Read cache" };
+            cached = MeshCache::Read(cachePath, path, importFlags, pMemory);
+        }
+
+        if (cached) {
+
+            ModelProperties& properties = cached->properties;
+            bool complete = true;
+            {
+                StageTimer timer{ timings, "Decode textures" };
+
+                // Embedded textures come back from the KTX cache, only the maps next to the model are decoded.
+                std::unordered_multimap<Texture::Type, std::filesystem::path> texturePaths = properties.texturePaths;
+                for (const auto& [type, key] : cached->embeddedTextures)
+                    texturePaths.erase(type);
+
+                std::vector<PendingTexture> pendingTextures = m_pPrivate->decodeTextures(path, texturePaths);
+                complete = m_pPrivate->readEmbeddedTextures(cached->embeddedTextures, properties);
+                m_pPrivate->collectTextures(pendingTextures, properties);
+            }
+
+            // With an embedded texture evicted from the KTX cache, the model has to be imported again.
+            if (complete) {
+
+                if (progress)
+                    progress(1.f);
+
+                m_pPrivate->finish(properties, std::move(timings));
+                return std::move(properties);
+            }
+        }
+    }
+
+    // Declared before the importer so it outlives it, the importer doesn't take ownership of the handler.
+    ProgressForwarder forwarder{ progress };
 
     Assimp::Importer importer;
-    const aiScene* pScene = importer.ReadFile(path.string(), kPostProcessingFlags);
+    importer.SetProgressHandler(&forwarder);
+
+    // The steps of a profile only have a combined cost, split from reading where Assimp starts post-processing.
+    const auto readStart = std::chrono::steady_clock::now();
+    const aiScene* pScene = importer.ReadFile(path.string(), postProcessingFlags);
+    const auto readEnd = std::chrono::steady_clock::now();
+
+    const auto postProcessStart = forwarder.postProcessStart().value_or(readEnd);
+    timings.push_back({ "Read", std::chrono::duration<float, std::milli>(postProcessStart - readStart).count() });
+    timings.push_back({ "Post-process", std::chrono::duration<float, std::milli>(readEnd - postProcessStart).count() });
+
+    if (forwarder.cancelled())
+        return {};
 
     if (!pScene || pScene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !pScene->mRootNode) {
         std::cerr << "ASSIMP Import Error: " << importer.GetErrorString() << "\n";
         return {};
     }
 
-    return m_pPrivate->importMesh(pScene->mRootNode, pScene);
+    std::optional<ModelProperties> properties;
+    {
+        StageTimer timer{ timings, "Convert" };
+        properties = m_pPrivate->importMesh(path, pScene->mRootNode, pScene, progress, pMemory);
+    }
+
+    if (!properties)
+        return {};
+
+    if (m_pPrivate->m_optimizeGeometry) {
+        StageTimer timer{ timings, "Optimize geometry" };
+        m_pPrivate->optimizeGeometry(*properties);
+    }
+
+    if (m_pPrivate->m_generateLods) {
+        StageTimer timer{ timings, "Build LODs" };
+        m_pPrivate->buildLods(*properties);
+    }
+
+    if (m_pPrivate->m_cacheEnabled) {
+        StageTimer timer{ timings, "Write cache" };
+
+        if (const std::optional<MeshCache::EmbeddedTextures> embeddedTextures = m_pPrivate->cacheEmbeddedTextures(pScene, *properties))
+            MeshCache::Write(cachePath, path, importFlags, *properties, *embeddedTextures);
+    }
+
+    m_pPrivate->finish(*properties, std::move(timings));
+    return std::move(*properties);
+}
+
+DEFINE_GETTER_IMMUTABLE_COPY(ModelLoader, profile, ModelLoader::Profile, m_pPrivate->m_profile)
+DEFINE_SETTER_COPY(ModelLoader, profile, m_pPrivate->m_profile)
+
+DEFINE_GETTER_IMMUTABLE(ModelLoader, cacheDirectory, std::filesystem::path, m_pPrivate->m_cacheDirectory)
+DEFINE_SETTER_CONSTREF(ModelLoader, cacheDirectory, m_pPrivate->m_cacheDirectory)
+
+DEFINE_GETTER_IMMUTABLE_COPY(ModelLoader, cacheEnabled, bool, m_pPrivate->m_cacheEnabled)
+DEFINE_SETTER_COPY(ModelLoader, cacheEnabled, m_pPrivate->m_cacheEnabled)
+
+DEFINE_GETTER_IMMUTABLE_COPY(ModelLoader, decodeTextures, bool, m_pPrivate->m_decodeTextures)
+DEFINE_SETTER_COPY(ModelLoader, decodeTextures, m_pPrivate->m_decodeTextures)
+
+DEFINE_GETTER_IMMUTABLE_COPY(ModelLoader, optimizeGeometry, bool, m_pPrivate->m_optimizeGeometry)
+DEFINE_SETTER_COPY(ModelLoader, optimizeGeometry, m_pPrivate->m_optimizeGeometry)
+
+DEFINE_GETTER_IMMUTABLE_COPY(ModelLoader, generateLods, bool, m_pPrivate->m_generateLods)
+DEFINE_SETTER_COPY(ModelLoader, generateLods, m_pPrivate->m_generateLods)
+
+DEFINE_GETTER_IMMUTABLE_COPY(ModelLoader, pooledGeometry, bool, m_pPrivate->m_pooledGeometry)
+DEFINE_SETTER_COPY(ModelLoader, pooledGeometry, m_pPrivate->m_pooledGeometry)
+
+DEFINE_GETTER_IMMUTABLE(ModelLoader, textureFilter, ModelLoader::TextureFilter, m_pPrivate->m_textureFilter)
+DEFINE_SETTER_CONSTREF(ModelLoader, textureFilter, m_pPrivate->m_textureFilter)
+
+DEFINE_GETTER_IMMUTABLE(ModelLoader, textureProcessing, TextureLoader::Processing, m_pPrivate->m_textureProcessing)
+DEFINE_SETTER_CONSTREF(ModelLoader, textureProcessing, m_pPrivate->m_textureProcessing)
+
+DEFINE_GETTER_IMMUTABLE_COPY(ModelLoader, vertexEncoding, VertexEncoding, m_pPrivate->m_vertexEncoding)
+DEFINE_SETTER_COPY(ModelLoader, vertexEncoding, m_pPrivate->m_vertexEncoding)
+
+DEFINE_GETTER_IMMUTABLE_COPY(ModelLoader, workerCount, std::size_t, m_pPrivate->m_workerCount)
+
+void ModelLoader::workerCount(std::size_t count) {
+
+    if (count == m_pPrivate->m_workerCount)
+        return;
+
+    m_pPrivate->m_workerCount = count;
+    m_pPrivate->m_pPool = std::make_shared<SharedPool>();
 }
@@ -0,0 +1,443 @@
+#include "ObjParser.hpp"
+#include "MappedFile.hpp"
+#include "ParseUtility.hpp"
+
+#include "Common/ThreadPool.hpp"
+
+#include "Geometry/VertexBuffer.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+// Index of a position, texel or normal. Relative references count from the end of the chunk's own attributes and
+// may reach back into earlier chunks, they're made file wide once the chunk offsets are known.
+struct Reference {
+    enum class Kind : std::uint8_t { Absent, Absolute, Relative };
+
+    std::int64_t index = 0;
+    Kind kind = Kind::Absent;
+
+    bool absent() const { return kind == Kind::Absent; }
+};
+
+struct Corner {
+    Reference position;
+    Reference texel;
+    Reference normal;
+};
+
+struct Chunk {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec4> colors;
+    std::vector<glm::vec2> texels;
+    std::vector<glm::vec3> normals;
+    std::vector<Corner> corners; // Three per triangle.
+    std::vector<std::string> materialLibraries;
+    bool hasColors = false;
+    bool valid = true;
+};
+
+bool IsSpace(char character) {
+    return character == ' ' || character == '\t' || character == '\r';
+}
+
+std::string_view TrimLeft(std::string_view text) {
+
+    while (!text.empty() && IsSpace(text.front()))
+        text.remove_prefix(1);
+
+    return text;
+}
+
+std::string_view Trim(std::string_view text) {
+
+    text = TrimLeft(text);
+    while (!text.empty() && IsSpace(text.back()))
+        text.remove_suffix(1);
+
+    return text;
+}
+
+// Parses up to Count floats, returns how many were read.
+template<std::size_t Count>
+std::size_t ParseFloats(std::string_view text, std::array<float, Count>& values) {
+
+    std::size_t parsed = 0;
+    for (; parsed < Count; ++parsed) {
+
+        text = TrimLeft(text);
+        if (text.empty())
+            break;
+
+        const auto [pEnd, error] = std::from_chars(text.data(), text.data() + text.size(), values[parsed]);
+        if (error != std::errc{})
+            break;
+
+        text.remove_prefix(static_cast<std::size_t>(pEnd - text.data()));
+    }
+
+    return parsed;
+}
+
+// Resolves a 1 based, possibly negative OBJ index. Zero means the component is absent.
+Reference MakeReference(std::int64_t index, std::size_t localCount) {
+
+    if (index > 0)
+        return { index - 1, Reference::Kind::Absolute };
+
+    if (index < 0)
+        return { static_cast<std::int64_t>(localCount) + index, Reference::Kind::Relative };
+
+    return {};
+}
+
+bool ParseCorner(std::string_view token, const Chunk& chunk, Corner& corner) {
+
+    std::array<std::int64_t, 3> indices{ 0, 0, 0 };
+
+    for (std::size_t component = 0; component < indices.size() && !token.empty(); ++component) {
+
+        const std::size_t slash = token.find('/');
+        const std::string_view part = token.substr(0, slash);
+
+        if (!part.empty()) {
+            const auto [pEnd, error] = std::from_chars(part.data(), part.data() + part.size(), indices[component]);
+            if (error != std::errc{})
+                return false;
+        }
+
+        if (slash == std::string_view::npos)
+            break;
+
+        token.remove_prefix(slash + 1);
+    }
+
+    corner.position = MakeReference(indices[0], chunk.positions.size());
+    corner.texel = MakeReference(indices[1], chunk.texels.size());
+    corner.normal = MakeReference(indices[2], chunk.normals.size());
+
+    return !corner.position.absent();
+}
+
+void ParseFace(std::string_view text, Chunk& chunk) {
+
+    Corner first;
+    Corner previous;
+    std::size_t cornerCount = 0;
+
+    while (true) {
+
+        text = TrimLeft(text);
+        if (text.empty())
+            break;
+
+        std::size_t end = 0;
+        while (end < text.size() && !IsSpace(text[end]))
+            ++end;
+
+        Corner corner;
+        if (!ParseCorner(text.substr(0, end), chunk, corner)) {
+            chunk.valid = false;
+            return;
+        }
+
+        text.remove_prefix(end);
+
+        // Fan triangulation around the first corner.
+        if (cornerCount == 0)
+            first = corner;
+        else if (cornerCount >= 2)
+            chunk.corners.insert(chunk.corners.end(), { first, previous, corner });
+
+        previous = corner;
+        ++cornerCount;
+    }
+}
+
+void ParseChunk(std::string_view text, Chunk& chunk) {
+
+    while (!text.empty() && chunk.valid) {
+
+        const std::size_t newline = text.find('\n');
+        std::string_view line = TrimLeft(text.substr(0, newline));
+        text.remove_prefix(newline == std::string_view::npos ? text.size() : newline + 1);
+
+        if (line.size() < 2)
+            continue;
+
+        if (line[0] == 'v' && IsSpace(line[1])) {
+
+            std::array<float, 7> values{};
+            const std::size_t count = ParseFloats(line.substr(2), values);
+            if (count < 3) {
+                chunk.valid = false;
+                break;
+            }
+
+            chunk.positions.emplace_back(values[0], values[1], values[2]);
+
+            // Some exporters append an RGB vertex color to the position.
+            if (count >= 6) {
+                chunk.colors.resize(chunk.positions.size() - 1, glm::vec4{ 1.f });
+                chunk.colors.emplace_back(values[3], values[4], values[5], 1.f);
+                chunk.hasColors = true;
+            }
+        }
+        else if (line.size() > 2 && line.starts_with("vt") && IsSpace(line[2])) {
+
+            std::array<float, 2> values{};
+            ParseFloats(line.substr(3), values);
+            chunk.texels.emplace_back(values[0], values[1]);
+        }
+        else if (line.size() > 2 && line.starts_with("vn") && IsSpace(line[2])) {
+
+            std::array<float, 3> values{};
+            if (ParseFloats(line.substr(3), values) < 3) {
+                chunk.valid = false;
+                break;
+            }
+
+            chunk.normals.emplace_back(values[0], values[1], values[2]);
+        }
+        else if (line[0] == 'f' && IsSpace(line[1])) {
+            ParseFace(line.substr(2), chunk);
+        }
+        else if (line.starts_with("mtllib") && line.size() > 6 && IsSpace(line[6])) {
+            chunk.materialLibraries.emplace_back(Trim(line.substr(7)));
+        }
+    }
+
+    if (chunk.hasColors)
+        chunk.colors.resize(chunk.positions.size(), glm::vec4{ 1.f });
+}
+
+// Pulls the texture maps out of a material library. Options before the file name are skipped.
+void ReadMaterialLibrary(const std::filesystem::path& path, std::unordered_multimap<Texture::Type, std::filesystem::path>& texturePaths) {
+
+    std::ifstream stream{ path };
+    if (!stream)
+        return;
+
+    static const std::array<std::pair<std::string_view, Texture::Type>, 3> kMaps{ {
+        { "map_Kd", Texture::Type::Diffuse },
+        { "map_Ke", Texture::Type::Emissive },
+        { "map_Ks", Texture::Type::Specular }
+    } };
+
+    std::string line;
+    while (std::getline(stream, line)) {
+
+        const std::string_view trimmed = Trim(line);
+
+        for (const auto& [keyword, type] : kMaps) {
+
+            if (!trimmed.starts_with(keyword) || trimmed.size() <= keyword.size() || !IsSpace(trimmed[keyword.size()]))
+                continue;
+
+            const std::string_view arguments = Trim(trimmed.substr(keyword.size()));
+            const std::size_t lastSpace = arguments.find_last_of(" \t");
+            const std::filesystem::path texturePath = arguments.substr(lastSpace == std::string_view::npos ? 0 : lastSpace + 1);
+
+            if (texturePath.has_filename())
+                texturePaths.emplace(type, texturePath.filename());
+        }
+    }
+}
+
+struct CornerKey {
+    std::uint32_t position = 0;
+    std::uint32_t texel = 0;
+    std::uint32_t normal = 0;
+
+    bool operator==(const CornerKey& other) const = default;
+};
+
+struct CornerKeyHash {
+    std::size_t operator()(const CornerKey& key) const {
+
+        std::uint64_t hash = key.position * 0x9e3779b97f4a7c15ull;
+        hash ^= (hash >> 29) + key.texel * 0xbf58476d1ce4e5b9ull;
+        hash ^= (hash >> 31) + key.normal * 0x94d049bb133111ebull;
+        return static_cast<std::size_t>(hash ^ (hash >> 32));
+    }
+};
+} // end unnamed namespace
+
+std::optional<ModelLoader::ModelProperties> ObjParser::Parse(const std::filesystem::path& path, ThreadPool& pool, const std::shared_ptr<std::pmr::memory_resource>& pMemory, const ModelLoader::ProgressCallback& callback) {
+
+    const MappedFile file{ path };
+    if (!file.valid())
+        return std::nullopt;
+
+    const std::string_view text{ reinterpret_cast<const char*>(file.data().data()), file.size() };
+
+    const std::vector<std::string_view> chunkText = ParseUtility::SplitLines(text, ParseUtility::ChunkCount(text.size(), 1 << 20, pool));
+    std::vector<Chunk> chunks(chunkText.size());
+
+    ParseProgress progress{ callback };
+    progress.pass(chunks.size(), .6f);
+
+    pool.parallelFor(chunks.size(), [&](std::size_t index) {
+
+        if (progress.cancelled())
+            return;
+
+        ParseChunk(chunkText[index], chunks[index]);
+        progress.advance();
+    });
+
+    if (progress.cancelled())
+        return std::nullopt;
+
+    // Offsets of each chunk's attributes in the file wide arrays.
+    std::vector<std::array<std::size_t, 3>> offsets(chunks.size());
+    std::array<std::size_t, 3> totals{ 0, 0, 0 };
+    bool hasColors = false;
+
+    for (std::size_t index = 0; index < chunks.size(); ++index) {
+
+        const Chunk& chunk = chunks[index];
+        if (!chunk.valid)
+            return std::nullopt;
+
+        offsets[index] = totals;
+        totals[0] += chunk.positions.size();
+        totals[1] += chunk.texels.size();
+        totals[2] += chunk.normals.size();
+        hasColors |= chunk.hasColors;
+    }
+
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec4> colors;
+    std::vector<glm::vec2> texels;
+    std::vector<glm::vec3> normals;
+
+    positions.reserve(totals[0]);
+    texels.reserve(totals[1]);
+    normals.reserve(totals[2]);
+
+    if (hasColors)
+        colors.reserve(totals[0]);
+
+    for (Chunk& chunk : chunks) {
+
+        positions.insert(positions.end(), chunk.positions.cbegin(), chunk.positions.cend());
+        texels.insert(texels.end(), chunk.texels.cbegin(), chunk.texels.cend());
+        normals.insert(normals.end(), chunk.normals.cbegin(), chunk.normals.cend());
+
+        if (hasColors) {
+            if (chunk.hasColors)
+                colors.insert(colors.end(), chunk.colors.cbegin(), chunk.colors.cend());
+            else
+                colors.resize(colors.size() + chunk.positions.size(), glm::vec4{ 1.f });
+        }
+    }
+
+    // Every face must reference a position, texels and normals are only kept when every face has them.
+    bool allTexels = true;
+    bool allNormals = true;
+    std::size_t cornerCount = 0;
+
+    pool.parallelFor(chunks.size(), [&](std::size_t index) {
+
+        const auto Resolve = [](Reference& reference, std::size_t offset, std::size_t total) {
+
+            if (reference.kind == Reference::Kind::Relative)
+                reference = { static_cast<std::int64_t>(offset) + reference.index, Reference::Kind::Absolute };
+
+            if (reference.index < 0 || reference.index >= static_cast<std::int64_t>(total))
+                reference = {};
+        };
+
+        for (Corner& corner : chunks[index].corners) {
+            Resolve(corner.position, offsets[index][0], totals[0]);
+            Resolve(corner.texel, offsets[index][1], totals[1]);
+            Resolve(corner.normal, offsets[index][2], totals[2]);
+        }
+    });
+
+    for (const Chunk& chunk : chunks) {
+
+        cornerCount += chunk.corners.size();
+
+        for (const Corner& corner : chunk.corners) {
+
+            if (corner.position.absent())
+                return std::nullopt;
+
+            allTexels &= !corner.texel.absent();
+            allNormals &= !corner.normal.absent();
+        }
+    }
+
+    if (cornerCount == 0)
+        return std::nullopt;
+
+    VertexBuffer buffer{ pMemory };
+    buffer.reserve(std::min(cornerCount, positions.size() * 2), cornerCount, true, allTexels, hasColors);
+
+    std::unordered_map<CornerKey, std::uint32_t, CornerKeyHash> vertexMap;
+    vertexMap.reserve(positions.size() * 2);
+
+    progress.pass(chunks.size(), allNormals ? 1.f : .8f);
+
+    for (const Chunk& chunk : chunks) {
+
+        for (const Corner& corner : chunk.corners) {
+
+            const CornerKey key{
+                static_cast<std::uint32_t>(corner.position.index),
+                allTexels ? static_cast<std::uint32_t>(corner.texel.index) : 0,
+                allNormals ? static_cast<std::uint32_t>(corner.normal.index) : 0
+            };
+
+            const auto [iter, inserted] = vertexMap.try_emplace(key, static_cast<std::uint32_t>(buffer.vertices().size()));
+            if (inserted) {
+
+                buffer.addVertex(positions[key.position]);
+
+                if (allTexels)
+                    buffer.addTexel(texels[key.texel]);
+
+                if (allNormals)
+                    buffer.addNormal(normals[key.normal]);
+
+                if (hasColors)
+                    buffer.addColor(colors[key.position]);
+            }
+
+            buffer.addIndex(iter->second);
+        }
+
+        if (!progress.advance())
+            return std::nullopt;
+    }
+
+    if (!allNormals) {
+        progress.pass(1, 1.f);
+        ParseUtility::GenerateSmoothNormals(buffer, pool);
+
+        if (!progress.advance())
+            return std::nullopt;
+    }
+
+    ModelLoader::ModelProperties properties;
+
+    for (const Chunk& chunk : chunks) {
+        for (const std::string& library : chunk.materialLibraries)
+            ReadMaterialLibrary(path.parent_path() / library, properties.texturePaths);
+    }
+
+    properties.meshes.emplace_back(std::move(buffer));
+    properties.instances.push_back({ 0, glm::mat4{ 1.f } });
+
+    return properties;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "IO/ModelLoader.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+class ThreadPool;
+
+// Wavefront OBJ reader. Faces are fan triangulated and identical position/texel/normal triplets share a vertex.
+class ObjParser {
+public:
+    static std::optional<ModelLoader::ModelProperties> Parse(const std::filesystem::path& path, ThreadPool& pool, const std::shared_ptr<std::pmr::memory_resource>& pMemory, const ModelLoader::ProgressCallback& progress);
+};
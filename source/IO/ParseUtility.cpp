@@ -0,0 +1,113 @@
+#include "ParseUtility.hpp"
+
+#include "Common/ThreadPool.hpp"
+
+#include "Geometry/VertexBuffer.hpp"
+
+#include <algorithm>
+
+#include <glm/geometric.hpp>
+
+std::vector<std::string_view> ParseUtility::SplitLines(std::string_view text, std::size_t chunkCount) {
+
+    std::vector<std::string_view> chunks;
+    if (text.empty())
+        return chunks;
+
+    chunkCount = std::max<std::size_t>(chunkCount, 1);
+    const std::size_t chunkSize = text.size() / chunkCount + 1;
+
+    std::size_t begin = 0;
+    while (begin < text.size()) {
+
+        std::size_t end = std::min(begin + chunkSize, text.size());
+
+        // Extend the chunk to the end of the line it stopped in.
+        if (end < text.size()) {
+            const std::size_t newline = text.find('\n', end);
+            end = newline == std::string_view::npos ? text.size() : newline + 1;
+        }
+
+        chunks.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+
+    return chunks;
+}
+
+void ParseUtility::GenerateSmoothNormals(VertexBuffer& buffer, ThreadPool& pool) {
+
+    const std::pmr::vector<glm::vec3>& vertices = buffer.vertices();
+    const std::pmr::vector<uint32_t>& indices = buffer.indices();
+
+    std::pmr::vector<glm::vec3>& normals = buffer.normals();
+    normals.assign(vertices.size(), glm::vec3{ 0.f });
+
+    // The unnormalized cross product weights each face by its area.
+    for (std::size_t index = 0; index + 2 < indices.size(); index += 3) {
+
+        const uint32_t a = indices[index];
+        const uint32_t b = indices[index + 1];
+        const uint32_t c = indices[index + 2];
+
+        if (a >= vertices.size() || b >= vertices.size() || c >= vertices.size())
+            continue;
+
+        const glm::vec3 faceNormal = glm::cross(vertices[b] - vertices[a], vertices[c] - vertices[a]);
+        normals[a] += faceNormal;
+        normals[b] += faceNormal;
+        normals[c] += faceNormal;
+    }
+
+    const std::size_t chunkCount = ChunkCount(normals.size(), 1 << 16, pool);
+    const std::size_t chunkSize = normals.size() / chunkCount + 1;
+
+    pool.parallelFor(chunkCount, [&](std::size_t chunk) {
+
+        const std::size_t end = std::min(normals.size(), (chunk + 1) * chunkSize);
+        for (std::size_t index = chunk * chunkSize; index < end; ++index) {
+
+            const float length = glm::length(normals[index]);
+            normals[index] = length > 0.f ? normals[index] / length : glm::vec3{ 0.f, 0.f, 1.f };
+        }
+    });
+}
+
+std::size_t ParseUtility::ChunkCount(std::size_t itemCount, std::size_t minimumChunkSize, const ThreadPool& pool) {
+
+    // A few chunks per worker keeps them busy when chunks take uneven time.
+    const std::size_t maximum = pool.workerCount() * 4;
+    return std::clamp<std::size_t>(itemCount / std::max<std::size_t>(minimumChunkSize, 1), 1, std::max<std::size_t>(maximum, 1));
+}
+
+ParseProgress::ParseProgress(const ModelLoader::ProgressCallback& callback)
+    : m_callback(callback) {}
+
+void ParseProgress::pass(std::size_t chunkCount, float end) {
+
+    std::scoped_lock lock{ m_mutex };
+
+    m_begin = m_end;
+    m_end = end;
+    m_chunkCount = std::max<std::size_t>(chunkCount, 1);
+    m_finishedCount = 0;
+}
+
+bool ParseProgress::advance() {
+
+    if (m_cancelled)
+        return false;
+
+    if (!m_callback)
+        return true;
+
+    std::scoped_lock lock{ m_mutex };
+
+    ++m_finishedCount;
+    const float fraction = static_cast<float>(m_finishedCount) / static_cast<float>(m_chunkCount);
+
+    if (!m_callback(m_begin + (m_end - m_begin) * std::min(fraction, 1.f)))
+        m_cancelled = true;
+
+    return !m_cancelled;
+}
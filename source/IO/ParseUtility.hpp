@@ -0,0 +1,49 @@
+#pragma once
+
+#include "IO/ModelLoader.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <vector>
+
+class ThreadPool;
+class VertexBuffer;
+
+// Helpers shared by the native model parsers.
+struct ParseUtility {
+    // Splits text into roughly equal chunks that each end on a line boundary.
+    static std::vector<std::string_view> SplitLines(std::string_view text, std::size_t chunkCount);
+
+    // Area weighted vertex normals for indexed triangles.
+    static void GenerateSmoothNormals(VertexBuffer& buffer, ThreadPool& pool);
+
+    // Number of chunks worth splitting the given amount of work into.
+    static std::size_t ChunkCount(std::size_t itemCount, std::size_t minimumChunkSize, const ThreadPool& pool);
+};
+
+// Reports finished chunks of a parse to the loader's progress callback. The parse runs in passes, each covering the
+// progress up to its end. Chunks may finish on any worker, the callback is only invoked by one at a time.
+class ParseProgress {
+public:
+    explicit ParseProgress(const ModelLoader::ProgressCallback& callback);
+
+    void pass(std::size_t chunkCount, float end);
+
+    // Returns false once the callback asked to cancel.
+    bool advance();
+
+    bool cancelled() const { return m_cancelled; }
+
+private:
+    const ModelLoader::ProgressCallback& m_callback;
+    std::mutex m_mutex;
+    std::atomic<bool> m_cancelled = false;
+
+    float m_begin = 0.f;
+    float m_end = 0.f;
+    std::size_t m_chunkCount = 0;
+    std::size_t m_finishedCount = 0;
+};
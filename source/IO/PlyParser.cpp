@@ -0,0 +1,459 @@
+#include "PlyParser.hpp"
+#include "MappedFile.hpp"
+#include "ParseUtility.hpp"
+
+#include "Common/ThreadPool.hpp"
+
+#include "Geometry/VertexBuffer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+enum class ScalarType : std::uint8_t {
+    Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64, Invalid
+};
+
+struct Property {
+    std::string name;
+    ScalarType type = ScalarType::Invalid;
+    ScalarType countType = ScalarType::Invalid; // Set for list properties.
+    std::size_t offset = 0; // Byte offset of a scalar property within its element.
+
+    bool isList() const { return countType != ScalarType::Invalid; }
+};
+
+struct Element {
+    std::string name;
+    std::size_t count = 0;
+    std::vector<Property> properties;
+
+    bool hasLists() const {
+        return std::ranges::any_of(properties, &Property::isList);
+    }
+
+    std::size_t stride() const;
+};
+
+struct Header {
+    bool bigEndian = false;
+    std::vector<Element> elements;
+    std::size_t dataOffset = 0;
+};
+
+ScalarType ToScalarType(std::string_view name) {
+
+    static const std::array<std::pair<std::string_view, ScalarType>, 16> kTypes{ {
+        { "char", ScalarType::Int8 }, { "int8", ScalarType::Int8 },
+        { "uchar", ScalarType::UInt8 }, { "uint8", ScalarType::UInt8 },
+        { "short", ScalarType::Int16 }, { "int16", ScalarType::Int16 },
+        { "ushort", ScalarType::UInt16 }, { "uint16", ScalarType::UInt16 },
+        { "int", ScalarType::Int32 }, { "int32", ScalarType::Int32 },
+        { "uint", ScalarType::UInt32 }, { "uint32", ScalarType::UInt32 },
+        { "float", ScalarType::Float32 }, { "float32", ScalarType::Float32 },
+        { "double", ScalarType::Float64 }, { "float64", ScalarType::Float64 }
+    } };
+
+    const auto iter = std::ranges::find(kTypes, name, &std::pair<std::string_view, ScalarType>::first);
+    return iter != kTypes.cend() ? iter->second : ScalarType::Invalid;
+}
+
+std::size_t SizeOf(ScalarType type) {
+
+    switch (type) {
+    case ScalarType::Int8:
+    case ScalarType::UInt8: return 1;
+    case ScalarType::Int16:
+    case ScalarType::UInt16: return 2;
+    case ScalarType::Int32:
+    case ScalarType::UInt32:
+    case ScalarType::Float32: return 4;
+    case ScalarType::Float64: return 8;
+    default: return 0;
+    }
+}
+
+std::size_t Element::stride() const {
+
+    std::size_t size = 0;
+    for (const Property& property : properties)
+        size += SizeOf(property.type);
+
+    return size;
+}
+
+template<typename T>
+T Load(const std::byte* pData, bool bigEndian) {
+
+    std::array<std::byte, sizeof(T)> bytes;
+    std::memcpy(bytes.data(), pData, sizeof(T));
+
+    if (bigEndian != (std::endian::native == std::endian::big))
+        std::ranges::reverse(bytes);
+
+    return std::bit_cast<T>(bytes);
+}
+
+double LoadScalar(const std::byte* pData, ScalarType type, bool bigEndian) {
+
+    switch (type) {
+    case ScalarType::Int8: return Load<std::int8_t>(pData, bigEndian);
+    case ScalarType::UInt8: return Load<std::uint8_t>(pData, bigEndian);
+    case ScalarType::Int16: return Load<std::int16_t>(pData, bigEndian);
+    case ScalarType::UInt16: return Load<std::uint16_t>(pData, bigEndian);
+    case ScalarType::Int32: return Load<std::int32_t>(pData, bigEndian);
+    case ScalarType::UInt32: return Load<std::uint32_t>(pData, bigEndian);
+    case ScalarType::Float32: return Load<float>(pData, bigEndian);
+    case ScalarType::Float64: return Load<double>(pData, bigEndian);
+    default: return 0.0;
+    }
+}
+
+std::optional<Header> ReadHeader(std::string_view text) {
+
+    constexpr std::string_view kEndHeader = "end_header";
+
+    const std::size_t end = text.find(kEndHeader);
+    if (!text.starts_with("ply") || end == std::string_view::npos)
+        return std::nullopt;
+
+    const std::size_t newline = text.find('\n', end);
+    if (newline == std::string_view::npos)
+        return std::nullopt;
+
+    Header header;
+    header.dataOffset = newline + 1;
+
+    std::istringstream stream{ std::string{ text.substr(0, end) } };
+    std::string line;
+
+    while (std::getline(stream, line)) {
+
+        std::istringstream tokens{ line };
+        std::string keyword;
+        tokens >> keyword;
+
+        if (keyword == "format") {
+
+            std::string format;
+            tokens >> format;
+
+            if (format == "binary_big_endian")
+                header.bigEndian = true;
+            else if (format != "binary_little_endian")
+                return std::nullopt;
+        }
+        else if (keyword == "element") {
+
+            Element element;
+            tokens >> element.name >> element.count;
+            if (!tokens)
+                return std::nullopt;
+
+            header.elements.push_back(std::move(element));
+        }
+        else if (keyword == "property") {
+
+            if (header.elements.empty())
+                return std::nullopt;
+
+            Property property;
+            std::string type;
+            tokens >> type;
+
+            if (type == "list") {
+
+                std::string countType;
+                tokens >> countType >> type;
+                property.countType = ToScalarType(countType);
+                if (property.countType == ScalarType::Invalid)
+                    return std::nullopt;
+            }
+
+            tokens >> property.name;
+            property.type = ToScalarType(type);
+            if (!tokens || property.type == ScalarType::Invalid)
+                return std::nullopt;
+
+            Element& element = header.elements.back();
+            if (!property.isList())
+                property.offset = element.stride();
+
+            element.properties.push_back(std::move(property));
+        }
+    }
+
+    return header;
+}
+
+const Property* FindProperty(const Element& element, std::initializer_list<std::string_view> names) {
+
+    for (const std::string_view name : names) {
+
+        const auto iter = std::ranges::find(element.properties, name, &Property::name);
+        if (iter != element.properties.cend() && !iter->isList())
+            return &*iter;
+    }
+
+    return nullptr;
+}
+} // end unnamed namespace
+
+std::optional<ModelLoader::ModelProperties> PlyParser::Parse(const std::filesystem::path& path, ThreadPool& pool, const std::shared_ptr<std::pmr::memory_resource>& pMemory, const ModelLoader::ProgressCallback& callback) {
+
+    const MappedFile file{ path };
+    if (!file.valid())
+        return std::nullopt;
+
+    const std::span<const std::byte> data = file.data();
+    const std::optional<Header> header = ReadHeader({ reinterpret_cast<const char*>(data.data()), data.size() });
+    if (!header)
+        return std::nullopt;
+
+    const bool bigEndian = header->bigEndian;
+
+    // Locate the vertex and face blocks, skipping over any other fixed size elements.
+    const Element* pVertexElement = nullptr;
+    const Element* pFaceElement = nullptr;
+    std::size_t vertexOffset = 0;
+    std::size_t faceOffset = 0;
+    std::size_t offset = header->dataOffset;
+
+    for (const Element& element : header->elements) {
+
+        if (element.name == "vertex" && !pVertexElement && !element.hasLists()) {
+            pVertexElement = &element;
+            vertexOffset = offset;
+        }
+        else if (element.name == "face" && !pFaceElement) {
+            pFaceElement = &element;
+            faceOffset = offset;
+            break;
+        }
+        else if (element.hasLists()) {
+            return std::nullopt;
+        }
+
+        if (element.count > (data.size() - std::min(offset, data.size())) / std::max<std::size_t>(element.stride(), 1))
+            return std::nullopt;
+
+        offset += element.count * element.stride();
+    }
+
+    if (!pVertexElement || !pFaceElement)
+        return std::nullopt;
+
+    // Faces need exactly one index list, anything scalar around it is skipped.
+    const auto listIter = std::ranges::find_if(pFaceElement->properties, [](const Property& property) {
+        return property.isList() && (property.name == "vertex_indices" || property.name == "vertex_index");
+    });
+
+    if (listIter == pFaceElement->properties.cend() || std::ranges::count_if(pFaceElement->properties, &Property::isList) != 1)
+        return std::nullopt;
+
+    const Property& indexList = *listIter;
+    std::size_t scalarsBeforeList = 0;
+    std::size_t scalarsAfterList = 0;
+
+    for (auto iter = pFaceElement->properties.cbegin(); iter != pFaceElement->properties.cend(); ++iter) {
+        if (iter < listIter)
+            scalarsBeforeList += SizeOf(iter->type);
+        else if (iter > listIter)
+            scalarsAfterList += SizeOf(iter->type);
+    }
+
+    const std::array<const Property*, 3> position{
+        FindProperty(*pVertexElement, { "x" }), FindProperty(*pVertexElement, { "y" }), FindProperty(*pVertexElement, { "z" })
+    };
+
+    const std::array<const Property*, 3> normal{
+        FindProperty(*pVertexElement, { "nx" }), FindProperty(*pVertexElement, { "ny" }), FindProperty(*pVertexElement, { "nz" })
+    };
+
+    const std::array<const Property*, 4> color{
+        FindProperty(*pVertexElement, { "red", "r" }), FindProperty(*pVertexElement, { "green", "g" }),
+        FindProperty(*pVertexElement, { "blue", "b" }), FindProperty(*pVertexElement, { "alpha", "a" })
+    };
+
+    const std::array<const Property*, 2> texel{
+        FindProperty(*pVertexElement, { "u", "s", "texture_u", "texture_s" }),
+        FindProperty(*pVertexElement, { "v", "t", "texture_v", "texture_t" })
+    };
+
+    if (std::ranges::find(position, nullptr) != position.cend())
+        return std::nullopt;
+
+    const bool hasNormals = std::ranges::find(normal, nullptr) == normal.cend();
+    const bool hasColors = color[0] && color[1] && color[2];
+    const bool hasTexels = texel[0] && texel[1];
+
+    const std::size_t vertexCount = pVertexElement->count;
+    const std::size_t vertexStride = pVertexElement->stride();
+
+    VertexBuffer buffer{ pMemory };
+    std::pmr::vector<glm::vec3>& vertices = buffer.vertices();
+    std::pmr::vector<glm::vec3>& normals = buffer.normals();
+    std::pmr::vector<glm::vec4>& colors = buffer.colors();
+    std::pmr::vector<glm::vec2>& texels = buffer.texels();
+
+    vertices.resize(vertexCount);
+    if (hasNormals)
+        normals.resize(vertexCount);
+    if (hasColors)
+        colors.resize(vertexCount);
+    if (hasTexels)
+        texels.resize(vertexCount);
+
+    // Integer colors are normalized, floating point colors are taken as they are.
+    const auto LoadColor = [bigEndian](const std::byte* pVertex, const Property& property) {
+
+        const float value = static_cast<float>(LoadScalar(pVertex + property.offset, property.type, bigEndian));
+        return property.type == ScalarType::Float32 || property.type == ScalarType::Float64 ? value : value / 255.f;
+    };
+
+    const std::size_t vertexChunkCount = ParseUtility::ChunkCount(vertexCount, 1 << 16, pool);
+    const std::size_t vertexChunkSize = vertexCount / vertexChunkCount + 1;
+
+    ParseProgress progress{ callback };
+    progress.pass(vertexChunkCount, .4f);
+
+    pool.parallelFor(vertexChunkCount, [&](std::size_t chunk) {
+
+        if (progress.cancelled())
+            return;
+
+        const std::size_t end = std::min(vertexCount, (chunk + 1) * vertexChunkSize);
+        for (std::size_t index = chunk * vertexChunkSize; index < end; ++index) {
+
+            const std::byte* pVertex = data.data() + vertexOffset + index * vertexStride;
+
+            for (std::size_t axis = 0; axis < 3; ++axis)
+                vertices[index][axis] = static_cast<float>(LoadScalar(pVertex + position[axis]->offset, position[axis]->type, bigEndian));
+
+            if (hasNormals) {
+                for (std::size_t axis = 0; axis < 3; ++axis)
+                    normals[index][axis] = static_cast<float>(LoadScalar(pVertex + normal[axis]->offset, normal[axis]->type, bigEndian));
+            }
+
+            if (hasColors) {
+                colors[index] = glm::vec4{
+                    LoadColor(pVertex, *color[0]), LoadColor(pVertex, *color[1]), LoadColor(pVertex, *color[2]),
+                    color[3] ? LoadColor(pVertex, *color[3]) : 1.f
+                };
+            }
+
+            if (hasTexels) {
+                texels[index] = glm::vec2{
+                    static_cast<float>(LoadScalar(pVertex + texel[0]->offset, texel[0]->type, bigEndian)),
+                    static_cast<float>(LoadScalar(pVertex + texel[1]->offset, texel[1]->type, bigEndian))
+                };
+            }
+        }
+
+        progress.advance();
+    });
+
+    if (progress.cancelled())
+        return std::nullopt;
+
+    // Faces are variable length, so a serial pass finds where each chunk of faces starts and how many indices it emits.
+    const std::size_t faceCount = pFaceElement->count;
+    const std::size_t countSize = SizeOf(indexList.countType);
+    const std::size_t indexSize = SizeOf(indexList.type);
+
+    const std::size_t faceChunkCount = ParseUtility::ChunkCount(faceCount, 1 << 16, pool);
+    const std::size_t faceChunkSize = faceCount / faceChunkCount + 1;
+
+    std::vector<std::size_t> chunkOffsets(faceChunkCount, 0);
+    std::vector<std::size_t> chunkIndexOffsets(faceChunkCount + 1, 0);
+
+    offset = faceOffset;
+    std::size_t indexCount = 0;
+
+    for (std::size_t face = 0; face < faceCount; ++face) {
+
+        if (face % faceChunkSize == 0) {
+            chunkOffsets[face / faceChunkSize] = offset;
+            chunkIndexOffsets[face / faceChunkSize] = indexCount;
+        }
+
+        offset += scalarsBeforeList;
+        if (offset + countSize > data.size())
+            return std::nullopt;
+
+        const auto cornerCount = static_cast<std::size_t>(LoadScalar(data.data() + offset, indexList.countType, bigEndian));
+        offset += countSize + cornerCount * indexSize + scalarsAfterList;
+
+        if (offset > data.size())
+            return std::nullopt;
+
+        if (cornerCount >= 3)
+            indexCount += (cornerCount - 2) * 3;
+    }
+
+    chunkIndexOffsets.back() = indexCount;
+
+    std::pmr::vector<std::uint32_t>& indices = buffer.indices();
+    indices.resize(indexCount);
+
+    progress.pass(faceChunkCount, hasNormals ? 1.f : .8f);
+
+    pool.parallelFor(faceChunkCount, [&](std::size_t chunk) {
+
+        if (progress.cancelled())
+            return;
+
+        const std::byte* pFace = data.data() + chunkOffsets[chunk];
+        std::size_t output = chunkIndexOffsets[chunk];
+
+        const std::size_t end = std::min(faceCount, (chunk + 1) * faceChunkSize);
+        for (std::size_t face = chunk * faceChunkSize; face < end; ++face) {
+
+            pFace += scalarsBeforeList;
+            const auto cornerCount = static_cast<std::size_t>(LoadScalar(pFace, indexList.countType, bigEndian));
+            pFace += countSize;
+
+            const auto LoadIndex = [&](std::size_t corner) {
+                return static_cast<std::uint32_t>(LoadScalar(pFace + corner * indexSize, indexList.type, bigEndian));
+            };
+
+            // Fan triangulation around the first corner.
+            for (std::size_t corner = 2; corner < cornerCount; ++corner) {
+                indices[output++] = LoadIndex(0);
+                indices[output++] = LoadIndex(corner - 1);
+                indices[output++] = LoadIndex(corner);
+            }
+
+            pFace += cornerCount * indexSize + scalarsAfterList;
+        }
+
+        progress.advance();
+    });
+
+    if (progress.cancelled())
+        return std::nullopt;
+
+    if (std::ranges::any_of(indices, [vertexCount](std::uint32_t index) { return index >= vertexCount; }))
+        return std::nullopt;
+
+    if (!hasNormals) {
+        progress.pass(1, 1.f);
+        ParseUtility::GenerateSmoothNormals(buffer, pool);
+
+        if (!progress.advance())
+            return std::nullopt;
+    }
+
+    ModelLoader::ModelProperties properties;
+    properties.meshes.emplace_back(std::move(buffer));
+    properties.instances.push_back({ 0, glm::mat4{ 1.f } });
+
+    return properties;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "IO/ModelLoader.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+class ThreadPool;
+
+// Binary PLY reader for triangle and polygon meshes. ASCII files and layouts it does not understand return nothing.
+class PlyParser {
+public:
+    static std::optional<ModelLoader::ModelProperties> Parse(const std::filesystem::path& path, ThreadPool& pool, const std::shared_ptr<std::pmr::memory_resource>& pMemory, const ModelLoader::ProgressCallback& progress);
+};
@@ -0,0 +1,102 @@
+#include "StlParser.hpp"
+#include "MappedFile.hpp"
+#include "ParseUtility.hpp"
+
+#include "Common/ThreadPool.hpp"
+
+#include "Geometry/VertexBuffer.hpp"
+
+#include <cstring>
+#include <numeric>
+
+#include <glm/geometric.hpp>
+
+namespace {
+constexpr std::size_t kHeaderSize = 80;
+constexpr std::size_t kTriangleSize = 50; // Normal, three vertices and a 16 bit attribute count.
+
+glm::vec3 ReadVec3(const std::byte* pData) {
+
+    glm::vec3 value;
+    std::memcpy(&value, pData, sizeof(value));
+    return value;
+}
+} // end unnamed namespace
+
+std::optional<ModelLoader::ModelProperties> StlParser::Parse(const std::filesystem::path& path, ThreadPool& pool, const std::shared_ptr<std::pmr::memory_resource>& pMemory, const ModelLoader::ProgressCallback& callback) {
+
+    static_assert(sizeof(glm::vec3) == 12);
+
+    const MappedFile file{ path };
+    if (!file.valid() || file.size() < kHeaderSize + sizeof(std::uint32_t))
+        return std::nullopt;
+
+    const std::byte* pData = file.data().data();
+
+    std::uint32_t triangleCount = 0;
+    std::memcpy(&triangleCount, pData + kHeaderSize, sizeof(triangleCount));
+
+    // ASCII files start with "solid" too, so the size is the only reliable way to tell them apart.
+    if (file.size() != kHeaderSize + sizeof(std::uint32_t) + std::size_t{ triangleCount } * kTriangleSize)
+        return std::nullopt;
+
+    const std::byte* pTriangles = pData + kHeaderSize + sizeof(std::uint32_t);
+    const std::size_t vertexCount = std::size_t{ triangleCount } * 3;
+
+    VertexBuffer buffer{ pMemory };
+    buffer.vertices().resize(vertexCount);
+    buffer.normals().resize(vertexCount);
+    buffer.indices().resize(vertexCount);
+
+    const std::size_t chunkCount = ParseUtility::ChunkCount(triangleCount, 1 << 14, pool);
+    const std::size_t chunkSize = triangleCount / chunkCount + 1;
+
+    ParseProgress progress{ callback };
+    progress.pass(chunkCount, 1.f);
+
+    pool.parallelFor(chunkCount, [&](std::size_t chunk) {
+
+        if (progress.cancelled())
+            return;
+
+        const std::size_t end = std::min<std::size_t>(triangleCount, (chunk + 1) * chunkSize);
+        for (std::size_t triangle = chunk * chunkSize; triangle < end; ++triangle) {
+
+            const std::byte* pTriangle = pTriangles + triangle * kTriangleSize;
+
+            const glm::vec3 a = ReadVec3(pTriangle + 12);
+            const glm::vec3 b = ReadVec3(pTriangle + 24);
+            const glm::vec3 c = ReadVec3(pTriangle + 36);
+
+            // Plenty of exporters write zero normals, derive them from the winding instead.
+            glm::vec3 normal = ReadVec3(pTriangle);
+            if (glm::dot(normal, normal) == 0.f) {
+                const glm::vec3 cross = glm::cross(b - a, c - a);
+                const float length = glm::length(cross);
+                normal = length > 0.f ? cross / length : glm::vec3{ 0.f, 0.f, 1.f };
+            }
+
+            const std::size_t first = triangle * 3;
+            buffer.vertices()[first] = a;
+            buffer.vertices()[first + 1] = b;
+            buffer.vertices()[first + 2] = c;
+
+            buffer.normals()[first] = normal;
+            buffer.normals()[first + 1] = normal;
+            buffer.normals()[first + 2] = normal;
+        }
+
+        progress.advance();
+    });
+
+    if (progress.cancelled())
+        return std::nullopt;
+
+    std::iota(buffer.indices().begin(), buffer.indices().end(), 0u);
+
+    ModelLoader::ModelProperties properties;
+    properties.meshes.emplace_back(std::move(buffer));
+    properties.instances.push_back({ 0, glm::mat4{ 1.f } });
+
+    return properties;
+}
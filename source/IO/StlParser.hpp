@@ -0,0 +1,16 @@
+#pragma once
+
+#include "IO/ModelLoader.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+class ThreadPool;
+
+// Binary STL reader. ASCII files are left to Assimp.
+class StlParser {
+public:
+    static std::optional<ModelLoader::ModelProperties> Parse(const std::filesystem::path& path, ThreadPool& pool, const std::shared_ptr<std::pmr::memory_resource>& pMemory, const ModelLoader::ProgressCallback& progress);
+};
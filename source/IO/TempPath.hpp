@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <random>
+#include <thread>
+
+// Temp file to write a cache file through before it is renamed into place. Unique per process and thread, so loader
+// workers and other viewers writing the same cache file never share one.
+inline std::filesystem::path TempPath(const std::filesystem::path& destination) {
+
+    static const std::uint64_t processToken = [] {
+        std::random_device device;
+        return (std::uint64_t{ device() } << 32) | device();
+    }();
+
+    std::filesystem::path tempPath = destination;
+    tempPath += std::format(".{:x}.{:x}.tmp", processToken, std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    return tempPath;
+}
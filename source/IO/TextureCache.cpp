@@ -0,0 +1,297 @@
+#include "IO/TextureCache.hpp"
+#include "IO/TextureUploader.hpp"
+
+#include "Hash.hpp"
+#include "MappedFile.hpp"
+
+#include "Renderer/Renderer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+// Evicted textures keep their levels up to this size, so they still draw something while the rest streams back in.
+constexpr unsigned int kEvictedSize = 64;
+
+struct Entry {
+    TextureHandle handle;
+    std::filesystem::path source; // Evicted levels are reloaded from here. Empty when there is nothing to reload from.
+    bool flipUVs = false;
+    bool evicted = false;
+};
+struct FileStamp {
+    std::uint64_t size = 0;
+    std::int64_t writeTime = 0;
+    std::uint64_t contentKey = 0; // Texture the file was last seen to hold
+};
+
+std::optional<FileStamp> StampFile(const std::filesystem::path& path) {
+
+    std::error_code error;
+
+    const std::uintmax_t size = std::filesystem::file_size(path, error);
+    if (error)
+        return std::nullopt;
+
+    const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(path, error);
+    if (error)
+        return std::nullopt;
+
+    return FileStamp{ static_cast<std::uint64_t>(size), static_cast<std::int64_t>(writeTime.time_since_epoch().count()) };
+}
+
+std::string FileKey(const std::filesystem::path& path, Texture::Target target, bool flipUVs) {
+
+    std::error_code error;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+    if (error)
+        canonical = std::filesystem::absolute(path);
+
+    return std::format("{}|{}|{}", canonical.generic_string(), static_cast<GLenum>(target), flipUVs);
+}
+
+// Files and decoded images hash different bytes, the seeds keep their keys apart.
+std::uint64_t FileContentKey(std::span<const std::byte> contents, Texture::Target target, bool flipUVs) {
+    return Hash64(contents, Hash64(std::format("file|{}|{}", static_cast<GLenum>(target), flipUVs)));
+}
+
+std::uint64_t ImageContentKey(const Image& image, Texture::Target target) {
+
+    const std::string layout = std::format("image|{}|{}|{}|{}|{}", static_cast<GLenum>(target), image.width(), image.height(), static_cast<GLint>(image.channels()), image.levelCount());
+    return Hash64(std::as_bytes(std::span{ image.pixels() }), Hash64(layout));
+}
+
+// Level an evicted texture keeps as its base. Zero when it has no smaller levels to fall back on.
+unsigned int EvictionLevel(const Texture& texture) {
+
+    unsigned int level = 0;
+    while (level + 1 < texture.levelCount() && std::max(texture.width() >> level, texture.height() >> level) > kEvictedSize)
+        ++level;
+
+    return level;
+}
+} // end unnamed namespace
+
+struct TextureCache::Private {
+    explicit Private(TextureUploader& uploader)
+        : m_uploader(uploader) {}
+
+    // A usable texture for the content, or nothing when it still has to be loaded.
+    std::optional<TextureHandle> find(std::uint64_t contentKey) const;
+
+    // Reloads evicted textures that were drawn again and evicts the least recently drawn ones over the budget.
+    void manageResidency();
+
+    TextureUploader& m_uploader;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, FileStamp> m_files;
+    std::unordered_map<std::uint64_t, Entry> m_textures;
+
+    std::size_t m_budget = std::numeric_limits<std::size_t>::max();
+    std::size_t m_residentSize = 0;
+    std::uint64_t m_lastCollect = 0; // Use clock at the previous collect(), textures drawn since are in use.
+};
+
+std::optional<TextureHandle> TextureCache::Private::find(std::uint64_t contentKey) const {
+
+    const auto foundIter = m_textures.find(contentKey);
+    if (foundIter == m_textures.cend() || foundIter->second.handle.status() == TextureHandle::Status::Failed)
+        return std::nullopt;
+
+    return foundIter->second.handle;
+}
+
+void TextureCache::Private::manageResidency() {
+
+    const std::uint64_t lastCollect = std::exchange(m_lastCollect, Texture::UseClock());
+
+    std::vector<Entry*> candidates;
+    m_residentSize = 0;
+
+    for (auto& [contentKey, entry] : m_textures) {
+
+        if (!entry.handle.ready())
+            continue;
+
+        const Texture& texture = entry.handle.texture();
+        const bool used = texture.lastUsed() > lastCollect;
+
+        if (entry.evicted && used) {
+            m_uploader.reload(texture, entry.source, entry.flipUVs);
+            entry.evicted = false;
+        }
+
+        m_residentSize += texture.residentSize();
+
+        // Textures still streaming in aren't fully resident yet, leave them be.
+        if (!used && !entry.evicted && !entry.source.empty() && texture.baseLevel() == 0 && EvictionLevel(texture) > 0)
+            candidates.push_back(&entry);
+    }
+
+    if (m_residentSize <= m_budget)
+        return;
+
+    std::ranges::sort(candidates, {}, [](const Entry* pEntry) { return pEntry->handle.texture().lastUsed(); });
+
+    for (Entry* pEntry : candidates) {
+
+        if (m_residentSize <= m_budget)
+            break;
+
+        Texture texture = pEntry->handle.texture();
+        const std::size_t size = texture.residentSize();
+
+        Renderer::Evict(texture, EvictionLevel(texture));
+        pEntry->evicted = true;
+
+        m_residentSize -= size - texture.residentSize();
+    }
+}
+
+
+TextureCache::TextureCache(TextureUploader& uploader)
+    : m_pPrivate(std::make_unique<Private>(uploader)) {}
+
+TextureCache::~TextureCache() noexcept {}
+
+TextureHandle TextureCache::load(const std::filesystem::path& path, Texture::Target target, bool flipUVs) {
+
+    std::optional<FileStamp> stamp = StampFile(path);
+    if (!stamp) {
+        TextureHandle handle;
+        handle.fail();
+        return handle;
+    }
+
+    const std::string fileKey = FileKey(path, target, flipUVs);
+
+    // An unchanged file holds what it held last time, otherwise look at what it holds now.
+    bool known = false;
+    {
+        std::scoped_lock lock{ m_pPrivate->m_mutex };
+
+        const auto foundIter = m_pPrivate->m_files.find(fileKey);
+        if (foundIter != m_pPrivate->m_files.cend() && foundIter->second.size == stamp->size && foundIter->second.writeTime == stamp->writeTime) {
+            stamp->contentKey = foundIter->second.contentKey;
+            known = true;
+        }
+    }
+
+    // Hashed without the lock, so import workers asking contains() don't wait on a large file.
+    if (!known) {
+
+        const MappedFile file{ path };
+        if (!file.valid()) {
+            TextureHandle handle;
+            handle.fail();
+            return handle;
+        }
+
+        stamp->contentKey = FileContentKey(file.data(), target, flipUVs);
+    }
+
+    std::scoped_lock lock{ m_pPrivate->m_mutex };
+
+    m_pPrivate->m_files[fileKey] = *stamp;
+
+    if (std::optional<TextureHandle> handle = m_pPrivate->find(stamp->contentKey))
+        return *handle;
+
+    TextureHandle handle = m_pPrivate->m_uploader.load(path, target, flipUVs);
+    m_pPrivate->m_textures.insert_or_assign(stamp->contentKey, Entry{ handle, path, flipUVs });
+
+    return handle;
+}
+
+TextureHandle TextureCache::upload(Image&& image, Texture::Target target, const std::filesystem::path& source) {
+
+    const std::uint64_t contentKey = ImageContentKey(image, target);
+
+    std::scoped_lock lock{ m_pPrivate->m_mutex };
+
+    // Only pixels that came from a file can be reloaded after an eviction.
+    std::filesystem::path reloadSource;
+    if (!source.empty()) {
+        if (std::optional<FileStamp> stamp = StampFile(source); stamp) {
+            stamp->contentKey = contentKey;
+            m_pPrivate->m_files[FileKey(source, target, false)] = *stamp;
+            reloadSource = source;
+        }
+    }
+
+    if (std::optional<TextureHandle> handle = m_pPrivate->find(contentKey)) {
+
+        if (Entry& entry = m_pPrivate->m_textures.at(contentKey); entry.source.empty())
+            entry.source = reloadSource;
+
+        return *handle;
+    }
+
+    TextureHandle handle = m_pPrivate->m_uploader.upload(std::move(image), target);
+    m_pPrivate->m_textures.insert_or_assign(contentKey, Entry{ handle, reloadSource });
+
+    return handle;
+}
+
+bool TextureCache::contains(const std::filesystem::path& path, Texture::Target target, bool flipUVs) const {
+
+    const std::optional<FileStamp> stamp = StampFile(path);
+    if (!stamp)
+        return false;
+
+    const std::string fileKey = FileKey(path, target, flipUVs);
+
+    std::scoped_lock lock{ m_pPrivate->m_mutex };
+
+    const auto foundIter = m_pPrivate->m_files.find(fileKey);
+    if (foundIter == m_pPrivate->m_files.cend() || foundIter->second.size != stamp->size || foundIter->second.writeTime != stamp->writeTime)
+        return false;
+
+    return m_pPrivate->find(foundIter->second.contentKey).has_value();
+}
+
+void TextureCache::collect() {
+
+    std::scoped_lock lock{ m_pPrivate->m_mutex };
+
+    // The cache holds one handle and the handle one copy of the texture. Anything beyond that is a user.
+    std::erase_if(m_pPrivate->m_textures, [](const auto& entry) {
+
+        const TextureHandle& handle = entry.second.handle;
+        if (handle.useCount() > 1)
+            return false;
+
+        switch (handle.status()) {
+        case TextureHandle::Status::Ready:
+
+            if (handle.texture().useCount() > 1)
+                return false;
+
+            handle.texture().destroy();
+            return true;
+
+        case TextureHandle::Status::Failed: return true;
+        default: return false;
+        }
+    });
+
+    std::erase_if(m_pPrivate->m_files, [this](const auto& entry) { return !m_pPrivate->m_textures.contains(entry.second.contentKey); });
+
+    m_pPrivate->manageResidency();
+}
+
+DEFINE_GETTER_IMMUTABLE_COPY(TextureCache, textureCount, std::size_t, m_pPrivate->m_textures.size())
+
+DEFINE_GETTER_IMMUTABLE_COPY(TextureCache, budget, std::size_t, m_pPrivate->m_budget)
+DEFINE_SETTER_COPY(TextureCache, budget, m_pPrivate->m_budget)
+
+DEFINE_GETTER_IMMUTABLE_COPY(TextureCache, residentSize, std::size_t, m_pPrivate->m_residentSize)
@@ -1,48 +1,198 @@
 #include "IO/TextureLoader.hpp"
 #include "Renderer/Renderer.hpp"
 
+#include "Hash.hpp"
+#include "MappedFile.hpp"
+#include "KtxCache.hpp"
+
+#include "Common/ThreadPool.hpp"
+
+#include "Texture/BlockCompression.hpp"
+#include "Texture/MipChain.hpp"
+
+#include <algorithm>
+#include <format>
+#include <limits>
+
 #include <glad/glad.h>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+namespace {
+// stb's flip flag is global state, flipping here keeps decoding safe to run on several threads.
+void FlipRows(std::vector<std::uint8_t>& pixels, std::size_t rowSize) {
+
+    if (rowSize == 0)
+        return;
+
+    const std::size_t rowCount = pixels.size() / rowSize;
+    for (std::size_t row = 0; row < rowCount / 2; ++row)
+        std::swap_ranges(pixels.begin() + row * rowSize, pixels.begin() + (row + 1) * rowSize, pixels.begin() + (rowCount - row - 1) * rowSize);
+}
+
+// Takes ownership of pixels returned by stb.
+std::optional<Image> MakeImage(stbi_uc* pData, int width, int height, int channels, bool flipUVs) {
+
+    if (!pData)
+        return std::nullopt;
+
+    const Texture::Channels format = [&channels] {
+        switch (channels) {
+        case 1: return Texture::Channels::R;
+        case 2: return Texture::Channels::RG;
+        case 3: return Texture::Channels::RGB;
+        case 4: return Texture::Channels::RGBA;
+        default: return Texture::Channels::RGB;
+        }
+    }();
+
+    const std::size_t rowSize = static_cast<std::size_t>(width) * static_cast<std::size_t>(channels);
+    std::vector<std::uint8_t> pixels(pData, pData + rowSize * static_cast<std::size_t>(height));
+    stbi_image_free(pData);
+
+    if (flipUVs)
+        FlipRows(pixels, rowSize);
+
+    return Image{ static_cast<unsigned int>(width), static_cast<unsigned int>(height), format, std::move(pixels) };
+}
+
+// Bump when the encoder output changes so stale cache entries are no longer found.
+constexpr int kEncoderVersion = 1;
+} // end unnamed namespace
+
 Texture TextureLoader::load(const std::filesystem::path& path, Texture::Target target) {
     return load(path, target, false);
 }
 
 Texture TextureLoader::load(const std::filesystem::path& path, Texture::Target target, bool flipUVs) {
 
-    Texture texture;
+    const std::optional<Image> image = decode(path, flipUVs);
+    if (!image)
+        return Texture{};
+
+    return upload(*image, target);
+}
+
+std::optional<Image> TextureLoader::decode(const std::filesystem::path& path, bool flipUVs) {
+
     if (!std::filesystem::is_regular_file(path))
-        return texture;
+        return std::nullopt;
 
     int width = 0;
     int height = 0;
     int channels = 0;
 
-    stbi_set_flip_vertically_on_load(flipUVs);
     stbi_uc* pData = stbi_load(path.string().c_str(), &width, &height, &channels, STBI_default);
+    return MakeImage(pData, width, height, channels, flipUVs);
+}
+
+std::optional<Image> TextureLoader::decode(std::span<const std::byte> encoded, bool flipUVs) {
 
-    if (pData) {
-
-        const Texture::Channels format = [&channels] {
-            switch (channels) {
-            case 1: return Texture::Channels::R;
-            case 2: return Texture::Channels::RG;
-            case 3: return Texture::Channels::RGB;
-            case 4: return Texture::Channels::RGBA;
-            default: return Texture::Channels::RGB;
-            }
-        }();
-        
-        texture = Texture{ static_cast<GLuint>(width), static_cast<GLuint>(height), format, format, target };
-        texture.initialize();
-        
-        Renderer::Configure(texture);
-        Renderer::Allocate(texture, pData);
-
-        stbi_image_free(pData);
+    if (encoded.empty() || encoded.size() > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+        return std::nullopt;
+
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+
+    const auto pEncoded = reinterpret_cast<const stbi_uc*>(encoded.data());
+    stbi_uc* pData = stbi_load_from_memory(pEncoded, static_cast<int>(encoded.size()), &width, &height, &channels, STBI_default);
+    return MakeImage(pData, width, height, channels, flipUVs);
+}
+
+std::optional<Image> TextureLoader::decode(const std::filesystem::path& path, bool flipUVs, const Processing& processing, ThreadPool& pool) {
+
+    if (!std::filesystem::is_regular_file(path))
+        return std::nullopt;
+
+    const MappedFile file{ path };
+    if (!file.valid())
+        return std::nullopt;
+
+    return decode(file.data(), flipUVs, processing, pool);
+}
+
+std::optional<Image> TextureLoader::decode(std::span<const std::byte> encoded, bool flipUVs, const Processing& processing, ThreadPool& pool) {
+
+    if (encoded.empty())
+        return std::nullopt;
+
+    if (!processing.mipmaps && !processing.compress)
+        return decode(encoded, flipUVs);
+
+    const std::uint64_t seed = Hash64(std::format("{}:{}:{}:{}:{}", kEncoderVersion, flipUVs, processing.mipmaps, processing.compress, processing.highQuality));
+    const std::filesystem::path cachePath = KtxCache::CachePath(Hash64(encoded, seed), processing.cacheDirectory);
+
+    if (std::optional<Image> cached = KtxCache::Read(cachePath))
+        return cached;
+
+    std::optional<Image> image = decode(encoded, flipUVs);
+    if (!image)
+        return std::nullopt;
+
+    Image processed = process(std::move(*image), processing, pool);
+    KtxCache::Write(cachePath, processed);
+
+    return processed;
+}
+
+Image TextureLoader::process(Image&& image, const Processing& processing, ThreadPool& pool) {
+
+    if (image.empty() || Texture::IsCompressed(image.channels()))
+        return std::move(image);
+
+    if (processing.mipmaps) {
+        if (std::optional<Image> chain = MipChain::Generate(image, pool))
+            image = std::move(*chain);
+    }
+
+    if (processing.compress) {
+        if (std::optional<Image> compressed = BlockCompression::Encode(image, BlockCompression::ChooseFormat(image.channels(), processing.highQuality), pool))
+            image = std::move(*compressed);
     }
 
+    return std::move(image);
+}
+
+Texture TextureLoader::create(const Image& image, Texture::Target target) {
+
+    // Swizzled pixel layouts still get a regular internal format.
+    const Texture::Channels textureFormat = image.channels() == Texture::Channels::BGRA ? Texture::Channels::RGBA : image.channels();
+
+    Texture texture{ image.width(), image.height(), textureFormat, image.channels(), target };
+    texture.initialize();
+
+    if (image.levelCount() > 1) {
+        texture.mipmap(true);
+        texture.levelCount(image.levelCount());
+        texture.minFilter(Texture::Filter::LinearMipmapLinear);
+    }
+
+    Renderer::Configure(texture);
+    return texture;
+}
+
+Texture TextureLoader::upload(const Image& image, Texture::Target target) {
+
+    if (image.empty())
+        return Texture{};
+
+    if (Texture::IsCompressed(image.channels()) && !Renderer::SupportsCompressedFormat(static_cast<GLenum>(image.channels()))) {
+
+        ThreadPool pool{ 1 };
+        const std::optional<Image> expanded = BlockCompression::Decode(image, pool);
+        return expanded ? upload(*expanded, target) : Texture{};
+    }
+
+    Texture texture = create(image, target);
+
+    // Rows are tightly packed, which breaks the default 4 byte alignment for RGB and narrower images.
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    Renderer::Allocate(texture, image.pixels().data());
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
     return texture;
 }
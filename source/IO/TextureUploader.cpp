@@ -0,0 +1,420 @@
+#include "IO/TextureUploader.hpp"
+#include "IO/TextureLoader.hpp"
+
+#include "Common/ThreadPool.hpp"
+
+#include "Renderer/Renderer.hpp"
+
+#include "Texture/BlockCompression.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <list>
+#include <optional>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace {
+enum class Stage : std::uint8_t {
+    Decoding, // Waiting on the worker that decodes the image.
+    Copying, // A worker copies the pixels into the mapped pixel buffer.
+    Streaming, // Levels are handed to the driver a few at a time, smallest first.
+    Transferring // The driver copies the pixel buffer into the texture.
+};
+
+struct Upload {
+    TextureHandle handle;
+    Texture::Target target = Texture::Target::Texture2D;
+    Stage stage = Stage::Decoding;
+    bool reload = false; // Refills the evicted levels of the texture below instead of creating one.
+
+    std::future<std::optional<Image>> decoded;
+    std::optional<Image> image;
+
+    GLuint pixelBufferId = 0;
+    std::future<void> copied;
+
+    unsigned int residentLevel = 0; // Streaming: levels from here down to the smallest have been handed over.
+
+    Texture texture;
+    GLsync fence = nullptr;
+};
+
+bool Matches(const Image& image, const Texture& texture) {
+    return image.width() == texture.width() && image.height() == texture.height() && image.levelCount() == texture.levelCount() && image.channels() == texture.pixelFormat();
+}
+
+template<typename T>
+bool IsReady(const std::future<T>& future) {
+    return future.wait_for(std::chrono::seconds::zero()) == std::future_status::ready;
+}
+} // end unnamed namespace
+
+struct TextureUploader::Private {
+    explicit Private(std::size_t workerCount);
+    ~Private();
+
+    COPY_MOVE_DISABLED(Private)
+
+    // Returns false when the upload is finished, successfully or not.
+    bool advance(Upload& upload, std::size_t& budget);
+
+    bool beginCopy(Upload& upload);
+    void beginTransfer(Upload& upload);
+    void beginStream(Upload& upload);
+
+    // Returns false once every level has been handed over.
+    bool stream(Upload& upload, std::size_t& budget);
+
+    GLuint acquirePixelBuffer();
+
+    ThreadPool m_pool;
+
+    std::list<Upload> m_uploads; // Stable addresses, workers write into the images they own.
+    std::vector<GLuint> m_freePixelBuffers;
+
+    std::size_t m_bytesPerPump = 64 << 20;
+    bool m_streaming = true;
+
+    TextureLoader::Processing m_processing;
+};
+
+TextureUploader::Private::Private(std::size_t workerCount)
+    : m_pool(workerCount) {}
+
+TextureUploader::Private::~Private() {
+
+    // Workers may still be writing into mapped buffers or reading images, let them finish first.
+    for (Upload& upload : m_uploads) {
+
+        if (upload.copied.valid())
+            upload.copied.wait();
+
+        if (upload.decoded.valid())
+            upload.decoded.wait();
+
+        if (upload.fence)
+            glDeleteSync(upload.fence);
+
+        if (upload.pixelBufferId)
+            glDeleteBuffers(1, &upload.pixelBufferId);
+
+        // Reloaded textures belong to their materials, and streamed ones may already have been handed out.
+        if (!upload.reload && !upload.handle.ready())
+            upload.texture.destroy();
+    }
+
+    if (!m_freePixelBuffers.empty())
+        glDeleteBuffers(static_cast<GLsizei>(m_freePixelBuffers.size()), m_freePixelBuffers.data());
+}
+
+bool TextureUploader::Private::advance(Upload& upload, std::size_t& budget) {
+
+    switch (upload.stage) {
+    case Stage::Decoding: {
+
+        if (!upload.image) {
+
+            if (!IsReady(upload.decoded))
+                return true;
+
+            upload.image = upload.decoded.get();
+            if (!upload.image || upload.image->empty()) {
+                upload.handle.fail();
+                return false;
+            }
+        }
+
+        // The driver can't sample this block format, expand it on a worker and come back.
+        if (Texture::IsCompressed(upload.image->channels()) && !Renderer::SupportsCompressedFormat(static_cast<GLenum>(upload.image->channels()))) {
+            upload.decoded = m_pool.submit([this, image = std::move(*upload.image)] { return BlockCompression::Decode(image, m_pool); });
+            upload.image.reset();
+            return true;
+        }
+
+        // The file may have changed since the texture was created from it.
+        if (upload.reload && !Matches(*upload.image, upload.texture)) {
+            std::cerr << "Warning: Texture " << upload.texture.id() << " no longer matches its source, its evicted levels stay missing.\n";
+            upload.handle.fail();
+            return false;
+        }
+
+        // Budget the streaming so a burst of large images doesn't stall a single frame.
+        const std::size_t size = upload.image->pixels().size();
+        if (size > budget && budget < m_bytesPerPump)
+            return true;
+
+        budget -= std::min(size, budget);
+
+        if (!beginCopy(upload)) {
+
+            // No pixel buffer to stream through, upload straight from system memory.
+            if (upload.reload) {
+                beginStream(upload);
+                return true;
+            }
+
+            upload.handle.fulfill(TextureLoader::upload(*upload.image, upload.target));
+            return false;
+        }
+
+        return true;
+    }
+    case Stage::Copying:
+
+        if (!IsReady(upload.copied))
+            return true;
+
+        if (!upload.reload && (!m_streaming || upload.image->levelCount() <= 1)) {
+            beginTransfer(upload);
+            return true;
+        }
+
+        beginStream(upload);
+        [[fallthrough]];
+
+    case Stage::Streaming:
+
+        if (stream(upload, budget))
+            return true;
+
+        // Streamed straight from system memory, there is no transfer left to wait on.
+        if (!upload.pixelBufferId)
+            return false;
+
+        upload.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        upload.stage = Stage::Transferring;
+        return true;
+
+    case Stage::Transferring: {
+
+        const GLenum result = glClientWaitSync(upload.fence, 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED)
+            return true;
+
+        glDeleteSync(upload.fence);
+        upload.fence = nullptr;
+
+        m_freePixelBuffers.push_back(std::exchange(upload.pixelBufferId, 0));
+
+        // Streamed textures were handed out as soon as their smallest levels arrived.
+        if (!upload.handle.ready())
+            upload.handle.fulfill(upload.texture);
+
+        return false;
+    }
+    default:
+        return false;
+    }
+}
+
+bool TextureUploader::Private::beginCopy(Upload& upload) {
+
+    const std::vector<std::uint8_t>& pixels = upload.image->pixels();
+
+    upload.pixelBufferId = acquirePixelBuffer();
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload.pixelBufferId);
+
+    // Orphan the previous storage, the driver may still be reading it for an earlier texture.
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(pixels.size()), nullptr, GL_STREAM_DRAW);
+    void* pMapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(pixels.size()), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (!pMapped) {
+        m_freePixelBuffers.push_back(std::exchange(upload.pixelBufferId, 0));
+        return false;
+    }
+
+    upload.copied = m_pool.submit([pMapped, &pixels] { std::memcpy(pMapped, pixels.data(), pixels.size()); });
+    upload.stage = Stage::Copying;
+
+    return true;
+}
+
+void TextureUploader::Private::beginTransfer(Upload& upload) {
+
+    upload.texture = TextureLoader::create(*upload.image, upload.target);
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload.pixelBufferId);
+
+    // The mapping can be lost, e.g. on a mode switch. The pixels are still around to upload directly.
+    const bool unmapped = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+    if (!unmapped)
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    // Rows are tightly packed, which breaks the default 4 byte alignment for RGB and narrower images.
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // With a pixel buffer bound the data pointer is an offset into it, and the call returns without waiting on the copy.
+    Renderer::Allocate(upload.texture, unmapped ? nullptr : upload.image->pixels().data());
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    upload.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    upload.image.reset();
+    upload.stage = Stage::Transferring;
+}
+
+void TextureUploader::Private::beginStream(Upload& upload) {
+
+    // Allocate every missing level up front, they are filled in as they stream in.
+    if (upload.reload) {
+        upload.residentLevel = upload.texture.baseLevel();
+        Renderer::Reserve(upload.texture);
+    }
+    else {
+        upload.texture = TextureLoader::create(*upload.image, upload.target);
+        upload.residentLevel = upload.image->levelCount();
+        Renderer::Allocate(upload.texture, nullptr);
+    }
+
+    if (upload.pixelBufferId) {
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload.pixelBufferId);
+
+        // Without the mapping the levels stream from the pixels that are still around instead.
+        if (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) != GL_TRUE)
+            m_freePixelBuffers.push_back(std::exchange(upload.pixelBufferId, 0));
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    upload.stage = Stage::Streaming;
+}
+
+bool TextureUploader::Private::stream(Upload& upload, std::size_t& budget) {
+
+    const Image& image = *upload.image;
+
+    // Offsets into the pixel buffer when one is bound, addresses into the image otherwise.
+    const std::uintptr_t base = upload.pixelBufferId ? 0 : reinterpret_cast<std::uintptr_t>(image.pixels().data());
+    const unsigned int residentLevel = upload.residentLevel;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload.pixelBufferId);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    while (upload.residentLevel > 0) {
+
+        const unsigned int level = upload.residentLevel - 1;
+        const std::size_t size = image.levelSize(level);
+
+        // Same budget as whole images, one level always gets through on an otherwise idle pump.
+        if (size > budget && budget < m_bytesPerPump)
+            break;
+
+        budget -= std::min(size, budget);
+
+        Renderer::Allocate(upload.texture, level, reinterpret_cast<const std::uint8_t*>(base + image.levelOffset(level)));
+        --upload.residentLevel;
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (upload.residentLevel == residentLevel && residentLevel > 0)
+        return true;
+
+    // Commands execute in order, sampling can start at the new level before the transfer has finished.
+    upload.texture.baseLevel(upload.residentLevel);
+    Renderer::Configure(upload.texture);
+
+    if (!upload.handle.ready())
+        upload.handle.fulfill(upload.texture);
+
+    if (upload.residentLevel > 0)
+        return true;
+
+    upload.image.reset();
+    return false;
+}
+
+GLuint TextureUploader::Private::acquirePixelBuffer() {
+
+    if (!m_freePixelBuffers.empty()) {
+        const GLuint pixelBufferId = m_freePixelBuffers.back();
+        m_freePixelBuffers.pop_back();
+        return pixelBufferId;
+    }
+
+    GLuint pixelBufferId = 0;
+    glGenBuffers(1, &pixelBufferId);
+    return pixelBufferId;
+}
+
+
+TextureUploader::TextureUploader(std::size_t workerCount)
+    : m_pPrivate(std::make_unique<Private>(workerCount)) {}
+
+TextureUploader::~TextureUploader() noexcept {}
+
+TextureHandle TextureUploader::load(const std::filesystem::path& path, Texture::Target target, bool flipUVs) {
+
+    Upload& upload = m_pPrivate->m_uploads.emplace_back();
+    upload.target = target;
+    upload.decoded = m_pPrivate->m_pool.submit([pPrivate = m_pPrivate.get(), path, flipUVs, processing = m_pPrivate->m_processing] {
+        return TextureLoader::decode(path, flipUVs, processing, pPrivate->m_pool);
+    });
+
+    return upload.handle;
+}
+
+TextureHandle TextureUploader::reload(const Texture& texture, const std::filesystem::path& path, bool flipUVs) {
+
+    Upload& upload = m_pPrivate->m_uploads.emplace_back();
+    upload.target = texture.target();
+    upload.reload = true;
+    upload.texture = texture;
+    upload.decoded = m_pPrivate->m_pool.submit([pPrivate = m_pPrivate.get(), path, flipUVs, processing = m_pPrivate->m_processing] {
+        return TextureLoader::decode(path, flipUVs, processing, pPrivate->m_pool);
+    });
+
+    return upload.handle;
+}
+
+TextureHandle TextureUploader::upload(Image&& image, Texture::Target target) {
+
+    Upload& upload = m_pPrivate->m_uploads.emplace_back();
+    upload.target = target;
+    upload.image.emplace(std::move(image));
+
+    if (upload.image->empty()) {
+        TextureHandle handle = upload.handle;
+        handle.fail();
+
+        m_pPrivate->m_uploads.pop_back();
+        return handle;
+    }
+
+    return upload.handle;
+}
+
+void TextureUploader::pump() {
+
+    std::size_t budget = m_pPrivate->m_bytesPerPump;
+
+    for (auto iter = m_pPrivate->m_uploads.begin(); iter != m_pPrivate->m_uploads.end();) {
+
+        if (m_pPrivate->advance(*iter, budget))
+            ++iter;
+        else
+            iter = m_pPrivate->m_uploads.erase(iter);
+    }
+}
+
+DEFINE_GETTER_IMMUTABLE_COPY(TextureUploader, bytesPerPump, std::size_t, m_pPrivate->m_bytesPerPump)
+DEFINE_SETTER_COPY(TextureUploader, bytesPerPump, m_pPrivate->m_bytesPerPump)
+
+DEFINE_GETTER_IMMUTABLE(TextureUploader, processing, TextureLoader::Processing, m_pPrivate->m_processing)
+DEFINE_SETTER_CONSTREF(TextureUploader, processing, m_pPrivate->m_processing)
+
+DEFINE_GETTER_IMMUTABLE_COPY(TextureUploader, streaming, bool, m_pPrivate->m_streaming)
+DEFINE_SETTER_COPY(TextureUploader, streaming, m_pPrivate->m_streaming)
+
+DEFINE_GETTER_IMMUTABLE_COPY(TextureUploader, pendingCount, std::size_t, m_pPrivate->m_uploads.size())
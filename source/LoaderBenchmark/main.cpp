@@ -0,0 +1,500 @@
+#include "Common/ThreadPool.hpp"
+
+#include "Geometry/VertexBuffered.hpp"
+#include "Geometry/VertexFormat.hpp"
+#include "IO/ModelLoader.hpp"
+#include "Object/Mesh.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#include <Psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <sys/resource.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr std::string_view kUsage =
+    "Usage: LoaderBenchmark [options] <model>... | @<list file>\n"
+    "\n"
+    "Loads each model without a window or OpenGL context and prints the results as JSON.\n"
+    "Memory per result is the growth of the current resident set across the load. Memory freed by earlier runs may be\n"
+    "reused and hide part of it, run one model per process for isolated numbers.\n"
+    "With several worker counts, each model is loaded with every count in turn and the speed-up of each count over the\n"
+    "lowest one is reported, from the fastest run of each. Repeat at least twice so cold caches don't skew the first run.\n"
+    "\n"
+    "Options:\n"
+    "  --profile <fast|balanced|full>  Import profile, defaults to full.\n"
+    "  --repeat <count>                Loads of each model, defaults to 1.\n"
+    "  --workers <count>[,<count>...]  Loader threads, zero or the default is one per hardware thread.\n"
+    "  --no-cache                      Bypass the binary mesh cache.\n"
+    "  --no-textures                   Skip decoding the textures a model references.\n"
+    "  --no-compression                Keep decoded textures uncompressed instead of block compressing them.\n"
+    "  --no-mipmaps                    Skip building mip chains for decoded textures.\n"
+    "  --no-optimize                   Keep the triangle and vertex order of the source.\n"
+    "  --no-lods                       Skip building simplified levels of detail.\n"
+    "  --geometry-pool                 Allocate the vertex arrays from one pool per model instead of the heap.\n"
+    "  --layout <interleaved|planar>   Vertex layout the upload data is prepared in, defaults to interleaved.\n"
+    "  --encoding <float|compact>      Vertex encoding of interleaved upload data, defaults to float.\n";
+
+struct Options {
+    std::vector<std::filesystem::path> models;
+    ModelLoader::Profile profile = ModelLoader::Profile::FullQuality;
+    std::size_t repeat = 1;
+    std::vector<std::size_t> workerCounts{ 0 };
+    bool cacheEnabled = true;
+    bool decodeTextures = true;
+    bool compressTextures = true;
+    bool generateMipmaps = true;
+    bool optimizeGeometry = true;
+    bool generateLods = true;
+    bool pooledGeometry = false;
+    VertexBuffered::Layout layout = VertexBuffered::Layout::Interleaved;
+    VertexEncoding encoding = VertexEncoding::Float;
+};
+
+// Resident set of the process right now.
+std::uint64_t CurrentResidentBytes() {
+
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.WorkingSetSize;
+
+    return 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info info{};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS)
+        return 0;
+
+    return info.resident_size;
+#else
+    // The second field of statm is the resident set, in pages.
+    std::ifstream statm{ "/proc/self/statm" };
+    std::uint64_t totalPages = 0;
+    std::uint64_t residentPages = 0;
+    if (!(statm >> totalPages >> residentPages))
+        return 0;
+
+    return residentPages * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+// High-water mark of the resident set over the whole process, not of a single load.
+std::uint64_t PeakResidentBytes() {
+
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+
+    return 0;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+#ifdef __APPLE__
+    return static_cast<std::uint64_t>(usage.ru_maxrss);
+#else
+    return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024; // Reported in kilobytes.
+#endif
+#endif
+}
+
+float MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Every non empty line of the file is a model path, relative paths are relative to the list.
+bool ReadModelList(const std::filesystem::path& listPath, std::vector<std::filesystem::path>& models) {
+
+    std::ifstream stream{ listPath };
+    if (!stream) {
+        std::cerr << "Error: Unable to open model list " << listPath << ".\n";
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(stream, line)) {
+
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        if (line.empty() || line.front() == '#')
+            continue;
+
+        const std::filesystem::path model{ line };
+        models.push_back(model.is_relative() ? listPath.parent_path() / model : model);
+    }
+
+    return true;
+}
+
+std::optional<std::size_t> ParseCount(std::string_view text) {
+
+    try {
+        return static_cast<std::size_t>(std::stoull(std::string{ text }));
+    }
+    catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+std::optional<Options> ParseOptions(int argc, char* argv[]) {
+
+    Options options;
+
+    for (int index = 1; index < argc; ++index) {
+
+        const std::string_view argument = argv[index];
+        const bool hasValue = index + 1 < argc;
+
+        if (argument == "--profile" && hasValue) {
+
+            const std::string_view profile = argv[++index];
+            if (profile == "fast")
+                options.profile = ModelLoader::Profile::FastPreview;
+            else if (profile == "balanced")
+                options.profile = ModelLoader::Profile::Balanced;
+            else if (profile == "full")
+                options.profile = ModelLoader::Profile::FullQuality;
+            else
+                return std::nullopt;
+        }
+        else if (argument == "--repeat" && hasValue) {
+
+            const std::optional<std::size_t> repeat = ParseCount(argv[++index]);
+            if (!repeat || *repeat == 0)
+                return std::nullopt;
+
+            options.repeat = *repeat;
+        }
+        else if (argument == "--workers" && hasValue) {
+
+            options.workerCounts.clear();
+
+            std::string_view counts = argv[++index];
+            while (!counts.empty()) {
+
+                const std::size_t comma = counts.find(',');
+                const std::optional<std::size_t> workerCount = ParseCount(counts.substr(0, comma));
+                if (!workerCount)
+                    return std::nullopt;
+
+                options.workerCounts.push_back(*workerCount);
+                counts = comma == std::string_view::npos ? std::string_view{} : counts.substr(comma + 1);
+            }
+
+            if (options.workerCounts.empty())
+                return std::nullopt;
+        }
+        else if (argument == "--layout" && hasValue) {
+
+            const std::string_view layout = argv[++index];
+            if (layout == "interleaved")
+                options.layout = VertexBuffered::Layout::Interleaved;
+            else if (layout == "planar")
+                options.layout = VertexBuffered::Layout::Planar;
+            else
+                return std::nullopt;
+        }
+        else if (argument == "--encoding" && hasValue) {
+
+            const std::string_view encoding = argv[++index];
+            if (encoding == "float")
+                options.encoding = VertexEncoding::Float;
+            else if (encoding == "compact")
+                options.encoding = VertexEncoding::Compact;
+            else
+                return std::nullopt;
+        }
+        else if (argument == "--no-cache") {
+            options.cacheEnabled = false;
+        }
+        else if (argument == "--no-textures") {
+            options.decodeTextures = false;
+        }
+        else if (argument == "--no-compression") {
+            options.compressTextures = false;
+        }
+        else if (argument == "--no-mipmaps") {
+            options.generateMipmaps = false;
+        }
+        else if (argument == "--no-optimize") {
+            options.optimizeGeometry = false;
+        }
+        else if (argument == "--no-lods") {
+            options.generateLods = false;
+        }
+        else if (argument == "--geometry-pool") {
+            options.pooledGeometry = true;
+        }
+        else if (argument.starts_with("@")) {
+
+            if (!ReadModelList(argument.substr(1), options.models))
+                return std::nullopt;
+        }
+        else if (argument.starts_with("--")) {
+            return std::nullopt;
+        }
+        else {
+            options.models.emplace_back(argument);
+        }
+    }
+
+    if (options.models.empty())
+        return std::nullopt;
+
+    return options;
+}
+
+std::string_view ProfileName(ModelLoader::Profile profile) {
+
+    switch (profile) {
+    case ModelLoader::Profile::FastPreview: return "fast";
+    case ModelLoader::Profile::Balanced: return "balanced";
+    case ModelLoader::Profile::FullQuality: return "full";
+    default: return "unknown";
+    }
+}
+
+// Prepares the vertex data the renderer hands the driver, without a context to hand it to. Interleaved vertices are
+// written the way they are into a mapped buffer, planar attributes are copied the way glBufferData copies them.
+nlohmann::json MeasureUpload(std::vector<VertexBuffered>& meshes, VertexBuffered::Layout layout) {
+
+    std::vector<std::byte> staging;
+    std::uint64_t vertexBytes = 0;
+    std::uint64_t indexBytes = 0;
+
+    const auto Stage = [&staging](const auto& values) {
+
+        const std::size_t size = values.size() * sizeof(values[0]);
+        staging.resize(size);
+        std::memcpy(staging.data(), values.data(), size);
+
+        return size;
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (VertexBuffered& geometry : meshes) {
+
+        geometry.layout(layout);
+        const VertexBuffer& buffer = geometry.buffer();
+
+        if (layout == VertexBuffered::Layout::Interleaved) {
+
+            const VertexLayout vertexLayout = VertexLayout::Select(buffer, geometry.encoding());
+            staging.resize(buffer.vertices().size() * vertexLayout.stride);
+            vertexLayout.interleave(buffer, VertexBounds::Of(buffer), staging);
+
+            vertexBytes += staging.size();
+        }
+        else {
+            vertexBytes += Stage(buffer.vertices()) + Stage(buffer.normals()) + Stage(buffer.texels()) + Stage(buffer.colors());
+        }
+
+        if (geometry.indexType() == GL_UNSIGNED_SHORT) {
+            const std::vector<std::uint16_t> shortIndices{ buffer.indices().cbegin(), buffer.indices().cend() };
+            indexBytes += Stage(shortIndices);
+        }
+        else {
+            indexBytes += Stage(buffer.indices());
+        }
+    }
+
+    return {
+        { "layout", layout == VertexBuffered::Layout::Interleaved ? "interleaved" : "planar" },
+        { "encoding", meshes.empty() || meshes.front().encoding() == VertexEncoding::Float ? "float" : "compact" },
+        { "vertexBytes", vertexBytes },
+        { "indexBytes", indexBytes },
+        { "milliseconds", MillisecondsSince(start) }
+    };
+}
+
+nlohmann::json Measure(const ModelLoader& loader, const std::filesystem::path& modelPath, VertexBuffered::Layout layout) {
+
+    nlohmann::json result;
+    result["path"] = modelPath.generic_string();
+
+    const std::uint64_t residentBefore = CurrentResidentBytes();
+
+    const auto start = std::chrono::steady_clock::now();
+    ModelLoader::ModelProperties properties = loader.load(modelPath);
+    const float loadMilliseconds = MillisecondsSince(start);
+
+    nlohmann::json stages = nlohmann::json::array();
+    for (const ModelLoader::StageTiming& timing : properties.stageTimings)
+        stages.push_back({ { "name", timing.name }, { "milliseconds", timing.milliseconds } });
+
+    std::uint64_t indexCount = 0;
+    std::uint64_t meshletCount = 0;
+    std::uint64_t lodIndexCount = 0;
+    for (const VertexBuffered& geometry : properties.meshes) {
+        indexCount += geometry.indexCount();
+        meshletCount += geometry.meshlets().size();
+
+        for (const VertexBuffered::Lod& lod : geometry.lods())
+            lodIndexCount += lod.indices.size();
+    }
+
+    std::uint64_t textureBytes = 0;
+    for (const auto& [type, image] : properties.textures)
+        textureBytes += image.pixels().size();
+
+    result["succeeded"] = !properties.meshes.empty();
+    result["wallMilliseconds"] = loadMilliseconds;
+    result["stages"] = std::move(stages);
+    result["textures"] = { { "count", properties.texturePaths.size() }, { "decoded", properties.textures.size() }, { "bytes", textureBytes } };
+    result["upload"] = MeasureUpload(properties.meshes, layout);
+
+    if (properties.vertexCache) {
+
+        const auto Statistics = [](const MeshOptimizer::Statistics& statistics) {
+            return nlohmann::json{ { "acmr", statistics.acmr() }, { "atvr", statistics.atvr() } };
+        };
+
+        result["vertexCache"] = { { "before", Statistics(properties.vertexCache->before) }, { "after", Statistics(properties.vertexCache->after) } };
+    }
+
+    const std::size_t meshCount = properties.meshes.size();
+    const std::size_t instanceCount = properties.instances.size();
+
+    // Assemble the model the same way the viewer does, so its bookkeeping is part of the numbers.
+    Mesh mesh;
+    mesh.model(std::move(properties.meshes));
+    mesh.instances(properties.instances);
+
+    result["meshCount"] = meshCount;
+    result["instanceCount"] = instanceCount;
+    result["vertexCount"] = mesh.vertexCount();
+    result["indexCount"] = indexCount;
+    result["meshletCount"] = meshletCount;
+    result["lodIndexCount"] = lodIndexCount;
+    result["faceCount"] = mesh.faceCount();
+
+    // Taken while the model is still held, the way the viewer would hold it.
+    const std::uint64_t residentAfter = CurrentResidentBytes();
+    result["residentBytes"] = { { "before", residentBefore }, { "after", residentAfter }, { "growth", static_cast<std::int64_t>(residentAfter) - static_cast<std::int64_t>(residentBefore) } };
+
+    // Pooled geometry goes back in one step, heap geometry one array at a time.
+    const auto releaseStart = std::chrono::steady_clock::now();
+    mesh.model(std::vector<VertexBuffered>{});
+    result["releaseMilliseconds"] = MillisecondsSince(releaseStart);
+
+    return result;
+}
+} // end unnamed namespace
+
+int main(int argc, char* argv[]) {
+
+    const std::optional<Options> options = ParseOptions(argc, argv);
+    if (!options) {
+        std::cerr << kUsage;
+        return EXIT_FAILURE;
+    }
+
+    ModelLoader loader;
+    loader.profile(options->profile);
+    loader.cacheEnabled(options->cacheEnabled);
+    loader.decodeTextures(options->decodeTextures);
+    loader.vertexEncoding(options->encoding);
+    loader.optimizeGeometry(options->optimizeGeometry);
+    loader.generateLods(options->generateLods);
+    loader.pooledGeometry(options->pooledGeometry);
+
+    TextureLoader::Processing processing;
+    processing.compress = options->compressTextures;
+    processing.mipmaps = options->generateMipmaps;
+    loader.textureProcessing(processing);
+
+    // One loader, and with it one pool, per worker count.
+    std::vector<std::size_t> workerCounts;
+    std::vector<ModelLoader> loaders;
+
+    for (const std::size_t workerCount : options->workerCounts) {
+
+        workerCounts.push_back(workerCount == 0 ? ThreadPool::DefaultWorkerCount() : workerCount);
+
+        loaders.push_back(loader);
+        loaders.back().workerCount(workerCounts.back());
+    }
+
+    nlohmann::json results = nlohmann::json::array();
+    bool succeeded = true;
+
+    // Fastest successful load of each model with each worker count.
+    std::map<std::filesystem::path, std::map<std::size_t, float>> fastest;
+
+    for (const std::filesystem::path& modelPath : options->models) {
+        for (std::size_t run = 0; run < options->repeat; ++run) {
+            for (std::size_t index = 0; index < loaders.size(); ++index) {
+
+                nlohmann::json result = Measure(loaders[index], modelPath, options->layout);
+                result["run"] = run;
+                result["workerCount"] = workerCounts[index];
+
+                if (result["succeeded"].get<bool>()) {
+                    const float milliseconds = result["wallMilliseconds"].get<float>();
+                    auto [iter, inserted] = fastest[modelPath].try_emplace(workerCounts[index], milliseconds);
+                    iter->second = std::min(iter->second, milliseconds);
+                }
+
+                succeeded &= result["succeeded"].get<bool>();
+                results.push_back(std::move(result));
+            }
+        }
+    }
+
+    nlohmann::json report;
+    report["profile"] = ProfileName(options->profile);
+    report["cacheEnabled"] = options->cacheEnabled;
+    report["workerCounts"] = workerCounts;
+    report["pooledGeometry"] = options->pooledGeometry;
+    report["peakResidentBytes"] = PeakResidentBytes();
+    report["results"] = std::move(results);
+
+    if (loaders.size() > 1) {
+
+        nlohmann::json scaling = nlohmann::json::array();
+
+        for (const auto& [modelPath, times] : fastest) {
+
+            // The map is ordered by worker count, so the baseline is its first entry.
+            const auto& [baselineCount, baselineMilliseconds] = *times.cbegin();
+
+            nlohmann::json speedups = nlohmann::json::array();
+            for (const auto& [workerCount, milliseconds] : times)
+                speedups.push_back({ { "workerCount", workerCount }, { "wallMilliseconds", milliseconds }, { "speedup", milliseconds > 0.f ? baselineMilliseconds / milliseconds : 0.f } });
+
+            scaling.push_back({ { "path", modelPath.generic_string() }, { "baselineWorkerCount", baselineCount }, { "speedups", std::move(speedups) } });
+        }
+
+        report["scaling"] = std::move(scaling);
+    }
+
+    std::cout << report.dump(2) << "\n";
+
+    return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -2,6 +2,7 @@
 
 #include "Shader/ShaderProgram.hpp"
 #include "Texture/Texture.hpp"
+#include "Texture/TextureHandle.hpp"
 
 #include <optional>
 
@@ -12,6 +13,11 @@ struct PhongTexturedMaterial::Private {
     std::optional<Texture> emissiveMap;
     std::optional<Texture> specularMap;
 
+    // Maps still on their way to the GPU, they replace the ones above once ready.
+    std::optional<TextureHandle> pendingDiffuseMap;
+    std::optional<TextureHandle> pendingEmissiveMap;
+    std::optional<TextureHandle> pendingSpecularMap;
+
     float shininess = 28.f;
 
     float diffuseIntensity = 1.f;
@@ -65,6 +71,7 @@ void PhongTexturedMaterial::apply(ShaderProgram* pShader) const {
     if (m_pPrivate->diffuseMap.has_value() && m_pPrivate->diffuseMap->initialized()) {
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(static_cast<GLenum>(m_pPrivate->diffuseMap->target()), m_pPrivate->diffuseMap->id());
+        m_pPrivate->diffuseMap->markUsed();
 
         pShader->set("phongMaterial.hasDiffuse", true);
         pShader->set("phongMaterial.diffuseMap", 0);
@@ -76,6 +83,7 @@ void PhongTexturedMaterial::apply(ShaderProgram* pShader) const {
     if (m_pPrivate->emissiveMap.has_value() && m_pPrivate->emissiveMap->initialized()) {
         glActiveTexture(GL_TEXTURE1);
         glBindTexture(static_cast<GLenum>(m_pPrivate->emissiveMap->target()), m_pPrivate->emissiveMap->id());
+        m_pPrivate->emissiveMap->markUsed();
         
         pShader->set("phongMaterial.hasEmissive", true);
         pShader->set("phongMaterial.emissiveMap", 1);
@@ -87,6 +95,7 @@ void PhongTexturedMaterial::apply(ShaderProgram* pShader) const {
     if (m_pPrivate->specularMap.has_value() && m_pPrivate->specularMap->initialized()) {
         glActiveTexture(GL_TEXTURE2);
         glBindTexture(static_cast<GLenum>(m_pPrivate->specularMap->target()), m_pPrivate->specularMap->id());
+        m_pPrivate->specularMap->markUsed();
         
         pShader->set("phongMaterial.hasSpecular", true);
         pShader->set("phongMaterial.specularMap", 2);
@@ -130,16 +139,46 @@ void PhongTexturedMaterial::destroy() {
     DestroyMap(m_pPrivate->diffuseMap);
     DestroyMap(m_pPrivate->emissiveMap);
     DestroyMap(m_pPrivate->specularMap);
+
+    m_pPrivate->pendingDiffuseMap.reset();
+    m_pPrivate->pendingEmissiveMap.reset();
+    m_pPrivate->pendingSpecularMap.reset();
+}
+
+bool PhongTexturedMaterial::update() {
+
+    const auto AdoptMap = [](std::optional<TextureHandle>& pending, std::optional<Texture>& map) {
+
+        if (!pending || pending->status() == TextureHandle::Status::Pending)
+            return false;
+
+        // Assigning over an existing map releases it.
+        const bool ready = pending->ready();
+        if (ready)
+            map = pending->texture();
+
+        pending.reset();
+        return ready;
+    };
+
+    bool changed = AdoptMap(m_pPrivate->pendingDiffuseMap, m_pPrivate->diffuseMap);
+    changed |= AdoptMap(m_pPrivate->pendingEmissiveMap, m_pPrivate->emissiveMap);
+    changed |= AdoptMap(m_pPrivate->pendingSpecularMap, m_pPrivate->specularMap);
+
+    return changed;
 }
 
 DEFINE_GETTER_CONST_CORRECT(PhongTexturedMaterial, diffuseMap, std::optional<Texture>, m_pPrivate->diffuseMap)
 DEFINE_SETTER_CONSTREF_EXPLICIT(PhongTexturedMaterial, diffuseMap, Texture, m_pPrivate->diffuseMap)
+DEFINE_SETTER_CONSTREF_EXPLICIT(PhongTexturedMaterial, diffuseMap, TextureHandle, m_pPrivate->pendingDiffuseMap)
 
 DEFINE_GETTER_CONST_CORRECT(PhongTexturedMaterial, emissiveMap, std::optional<Texture>, m_pPrivate->emissiveMap)
 DEFINE_SETTER_CONSTREF_EXPLICIT(PhongTexturedMaterial, emissiveMap, Texture, m_pPrivate->emissiveMap)
+DEFINE_SETTER_CONSTREF_EXPLICIT(PhongTexturedMaterial, emissiveMap, TextureHandle, m_pPrivate->pendingEmissiveMap)
 
 DEFINE_GETTER_CONST_CORRECT(PhongTexturedMaterial, specularMap, std::optional<Texture>, m_pPrivate->specularMap)
 DEFINE_SETTER_CONSTREF_EXPLICIT(PhongTexturedMaterial, specularMap, Texture, m_pPrivate->specularMap)
+DEFINE_SETTER_CONSTREF_EXPLICIT(PhongTexturedMaterial, specularMap, TextureHandle, m_pPrivate->pendingSpecularMap)
 
 DEFINE_GETTER_IMMUTABLE_COPY(PhongTexturedMaterial, shininess, float, m_pPrivate->shininess)
 DEFINE_SETTER_COPY(PhongTexturedMaterial, shininess, m_pPrivate->shininess)
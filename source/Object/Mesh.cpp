@@ -1,9 +1,12 @@
 #include "Object/Mesh.hpp"
 
 #include "Common/Math.hpp"
+#include "Geometry/MeshInstance.hpp"
 #include "Geometry/VertexBuffered.hpp"
 #include "Material/IMaterial.hpp"
 
+#include <algorithm>
+
 namespace {
 struct Metadata {
     std::uint32_t vertexCount = 0;
@@ -22,7 +25,7 @@ bool Metadata::hasAttribute(VertexBuffered::NamedAttribute attribute) const {
     return attributes.test(static_cast<std::size_t>(attribute));
 }
 
-Metadata readMetadata(const std::forward_list<VertexBuffered>& model) {
+Metadata readMetadata(const std::vector<VertexBuffered>& model) {
 
     using enum VertexBuffered::NamedAttribute;
 
@@ -33,15 +36,12 @@ Metadata readMetadata(const std::forward_list<VertexBuffered>& model) {
     std::size_t indexCount = 0;
     for (const VertexBuffered& buffer : model) {
 
-        const auto vertices = buffer.vertices();
-        const auto indices = buffer.indices();
-
-        metadata.vertexCount += vertices->size();
-        indexCount += indices->size();
+        metadata.vertexCount += static_cast<std::uint32_t>(buffer.vertexCount());
+        indexCount += buffer.indexCount();
 
-        metadata.setAttribute(Color, buffer.colors().has_value());
-        metadata.setAttribute(Normal, buffer.normals().has_value());
-        metadata.setAttribute(Texel, buffer.texels().has_value());
+        metadata.setAttribute(Color, buffer.hasColors());
+        metadata.setAttribute(Normal, buffer.hasNormals());
+        metadata.setAttribute(Texel, buffer.hasTexels());
     }
 
     metadata.setAttribute(Position, metadata.vertexCount > 0);
@@ -53,7 +53,8 @@ Metadata readMetadata(const std::forward_list<VertexBuffered>& model) {
 } // end unnamed namespace
 
 struct Mesh::Private {
-    std::forward_list<VertexBuffered> m_model;
+    std::vector<VertexBuffered> m_model;
+    std::vector<MeshInstance> m_instances;
     IMaterial* m_pMaterial = nullptr;
     glm::vec3 m_position{ 0.f };
 
@@ -66,6 +67,8 @@ struct Mesh::Private {
     Metadata m_metadata;
 
     bool m_initialized = false;
+    bool m_gpuResident = false;
+    bool m_geometryRequested = false;
 };
 
 
@@ -142,6 +145,8 @@ void Mesh::restore(const nlohmann::json& settings) {
 void Mesh::destroy() const {
 
     m_pPrivate->m_model.clear();
+    m_pPrivate->m_instances.clear();
+    m_pPrivate->m_geometryRequested = false;
     m_pPrivate->m_pMaterial->destroy();
 }
 
@@ -152,14 +157,57 @@ void Mesh::material(IMaterial* pMaterial) {
     m_pPrivate->m_initialized = false;
 }
 
-DEFINE_GETTER_IMMUTABLE_COPY(Mesh, model, std::forward_list<VertexBuffered>*, &m_pPrivate->m_model)
+DEFINE_GETTER_IMMUTABLE_COPY(Mesh, model, std::vector<VertexBuffered>*, &m_pPrivate->m_model)
 
-void Mesh::model(const std::forward_list<VertexBuffered>& model) {
+void Mesh::model(const std::vector<VertexBuffered>& model) {
     m_pPrivate->m_model = model;
     m_pPrivate->m_metadata = readMetadata(m_pPrivate->m_model);
     m_pPrivate->m_initialized = false;
 }
 
+void Mesh::model(std::vector<VertexBuffered>&& model) {
+    m_pPrivate->m_model = std::move(model);
+    m_pPrivate->m_metadata = readMetadata(m_pPrivate->m_model);
+    m_pPrivate->m_initialized = false;
+}
+
+DEFINE_GETTER_IMMUTABLE_COPY(Mesh, gpuResident, bool, m_pPrivate->m_gpuResident)
+DEFINE_SETTER_COPY(Mesh, gpuResident, m_pPrivate->m_gpuResident)
+
+DEFINE_GETTER_IMMUTABLE_COPY(Mesh, geometryRequested, bool, m_pPrivate->m_geometryRequested)
+DEFINE_SETTER_COPY(Mesh, geometryRequested, m_pPrivate->m_geometryRequested)
+
+bool Mesh::restoreGeometry(std::vector<VertexBuffered>&& model) {
+
+    // Instances and uploaded ranges refer to meshes by index and size, a file that changed on disk can't stand in.
+    const auto matches = [](const VertexBuffered& current, const VertexBuffered& reloaded) {
+
+        if (current.vertexCount() != reloaded.vertexCount() || current.indexCount() != reloaded.indexCount() || current.lods().size() != reloaded.lods().size())
+            return false;
+
+        for (std::size_t lod = 0; lod < current.lods().size(); ++lod) {
+            if (current.lodIndexCount(lod) != reloaded.lodIndexCount(lod))
+                return false;
+        }
+
+        return true;
+    };
+
+    if (model.size() != m_pPrivate->m_model.size() || !std::ranges::equal(m_pPrivate->m_model, model, matches))
+        return false;
+
+    // The layout is a viewer setting, the loader always hands out interleaved geometry.
+    for (std::size_t index = 0; index < model.size(); ++index)
+        model[index].layout(m_pPrivate->m_model[index].layout());
+
+    this->model(std::move(model));
+    m_pPrivate->m_geometryRequested = false;
+    return true;
+}
+
+DEFINE_GETTER_IMMUTABLE(Mesh, instances, std::vector<MeshInstance>, m_pPrivate->m_instances)
+DEFINE_SETTER_CONSTREF(Mesh, instances, m_pPrivate->m_instances)
+
 glm::mat4 Mesh::transform() const {
 
     // Create a transformation matrix composed of matrices in the order of scale, rotate, then translate.
@@ -4,10 +4,16 @@
 #include "ShaderCache.hpp"
 
 #include "Camera/Camera.hpp"
+#include "Camera/OrthographicCamera.hpp"
 
 #include "Common/Constants.hpp"
 
+#include "Geometry/Frustum.hpp"
+#include "Geometry/GeometryArena.hpp"
+#include "Geometry/MeshInstance.hpp"
+#include "Geometry/Meshlet.hpp"
 #include "Geometry/VertexBuffered.hpp"
+#include "Geometry/VertexFormat.hpp"
 
 #include "Light/DirectionalLight.hpp"
 
@@ -24,13 +30,29 @@
 
 #include "Texture/Texture.hpp"
 
+#include <algorithm>
 #include <array>
-#include <forward_list>
+#include <cstdint>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
 #include <set>
+#include <string>
 #include <queue>
+#include <utility>
+#include <vector>
+
+#include <glm/matrix.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
 
 namespace {
+// Largest screen space error a level of detail may show, in pixels.
+constexpr float kLodPixelError = 1.f;
+
+// A coarser level is only picked once its error is this far inside the limit, so levels don't flicker at the edge.
+constexpr float kLodHysteresis = .75f;
+
 #ifdef GLAD_DEBUG
 void DebugFramebufferAttachmentStatus(GLenum status) {
 
@@ -85,6 +107,108 @@ std::vector<VertexAttribute> DefineAttributes(const VertexBuffered& geometry) {
     return attributes;
 }
 
+std::size_t IndexSize(GLenum indexType) {
+    return indexType == GL_UNSIGNED_SHORT ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+}
+
+// Position plus the optional attributes the geometry has data for and the program reads. Attribute presence outlasts a
+// released buffer, so released geometry still knows its layout.
+VertexLayout InterleavedLayout(const VertexBuffered& geometry, const ShaderProgram* pProgram) {
+
+    const auto Include = [&geometry, pProgram](std::string_view name) {
+
+        const bool present = name == "normal" ? geometry.hasNormals() : name == "texel" ? geometry.hasTexels() : name == "color" ? geometry.hasColors() : true;
+        return present && pProgram->hasAttribute(std::string{ name });
+    };
+
+    return VertexLayout::Select(geometry.encoding(), Include);
+}
+
+// Index count of the full mesh and every level of detail after it.
+std::size_t TotalIndexCount(const VertexBuffered& geometry) {
+
+    std::size_t indexCount = geometry.indexCount();
+    for (std::size_t lod = 0; lod < geometry.lods().size(); ++lod)
+        indexCount += geometry.lodIndexCount(lod);
+
+    return indexCount;
+}
+
+// Vertex arenas keyed by the layout of the vertices they hold.
+using ArenaMap = std::map<std::string, std::unique_ptr<GeometryArena>>;
+
+std::string ArenaKey(const VertexLayout& layout) {
+
+    std::string key = std::to_string(layout.stride);
+    for (const VertexLayout::Attribute& attribute : layout.attributes)
+        key += std::format(";{}:{}:{}:{}:{}", attribute.name, attribute.size, attribute.dataType, attribute.normalized, attribute.offset);
+
+    return key;
+}
+
+// Interleaved geometry with the same layout shares an arena, and with it one vertex array. Attribute locations are
+// looked up once, every program reads the vertices through the same shader inputs.
+GeometryArena& InterleavedArena(ArenaMap& arenas, const VertexLayout& layout, const ShaderProgram* pProgram) {
+
+    std::unique_ptr<GeometryArena>& pArena = arenas[ArenaKey(layout)];
+    if (pArena)
+        return *pArena;
+
+    std::vector<std::pair<GLuint, VertexLayout::Attribute>> attributes;
+    for (const VertexLayout::Attribute& attribute : layout.attributes) {
+        if (const std::optional<GLuint> location = pProgram->attributeLocation(std::string{ attribute.name }))
+            attributes.emplace_back(*location, attribute);
+    }
+
+    // Runs with the arena's vertex array and vertex buffer bound.
+    const auto PointAttributes = [attributes, stride = static_cast<GLsizei>(layout.stride)]() {
+        for (const auto& [location, attribute] : attributes) {
+            glVertexAttribPointer(
+                location,
+                attribute.size,
+                attribute.dataType,
+                attribute.normalized,
+                stride,
+                reinterpret_cast<void*>(attribute.offset)
+            );
+            glEnableVertexAttribArray(location);
+        }
+    };
+
+    pArena = std::make_unique<GeometryArena>(layout.stride, PointAttributes);
+    return *pArena;
+}
+
+bool AllocateInterleaved(ArenaMap& arenas, VertexBuffered& geometry, const ShaderProgram* pProgram) {
+
+    if (!pProgram) {
+        std::cerr << "Error: Unable to configure attributes. The shader program is invalid.\n";
+        return false;
+    }
+
+    if (!geometry.vertices()) {
+        std::cerr << "Error: Unable to define vertex positions for the given geometry.\n";
+        return false;
+    }
+
+    const VertexLayout layout = InterleavedLayout(geometry, pProgram);
+    GeometryArena& arena = InterleavedArena(arenas, layout, pProgram);
+
+    geometry.initialize(arena.allocate(geometry.vertexCount(), TotalIndexCount(geometry) * IndexSize(geometry.indexType())));
+    return true;
+}
+
+// Whether the geometry's arena range is already laid out the way the program reads it.
+bool InMatchingArena(const ArenaMap& arenas, const VertexBuffered& geometry, const ShaderProgram* pProgram) {
+
+    const GeometryArena::Allocation* pAllocation = geometry.allocation().get();
+    if (!pAllocation || geometry.layout() != VertexBuffered::Layout::Interleaved)
+        return false;
+
+    const auto iter = arenas.find(ArenaKey(InterleavedLayout(geometry, pProgram)));
+    return iter != arenas.cend() && iter->second->vertexArrayId() == pAllocation->vertexArrayId();
+}
+
 bool ConfigureAttributes(const VertexBuffered& geometry, const ShaderProgram* pProgram) {
 
     if (!geometry.initialized()) {
@@ -136,6 +260,58 @@ bool ConfigureAttributes(const VertexBuffered& geometry, const ShaderProgram* pP
     return true;
 }
 
+// Writes the vertices into the geometry's range of its arena. Uploads go through the copy target, leaving the vertex
+// array and its bindings alone.
+void LoadInterleavedBuffer(const GeometryArena::Allocation& allocation, const VertexBuffered& geometry, const VertexLayout& layout) {
+
+    const std::size_t size = geometry.vertexCount() * layout.stride;
+    const std::size_t offset = allocation.baseVertex() * layout.stride;
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, allocation.vertexBufferId());
+
+    // Interleave straight into the buffer, without building the vertices in system memory first.
+    bool written = false;
+    if (void* pMapped = glMapBufferRange(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT)) {
+        layout.interleave(geometry.buffer(), geometry.bounds(), { static_cast<std::byte*>(pMapped), size });
+        written = glUnmapBuffer(GL_COPY_WRITE_BUFFER) == GL_TRUE;
+    }
+
+    // The mapping failed or its contents were lost.
+    if (!written) {
+        std::vector<std::byte> vertices(size);
+        layout.interleave(geometry.buffer(), geometry.bounds(), vertices);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), vertices.data());
+    }
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+// Writes the full index list followed by every level of detail, starting at the byte offset of the bound buffer.
+void LoadIndices(const VertexBuffered& geometry, GLenum target, std::size_t offset) {
+
+    const std::size_t indexSize = IndexSize(geometry.indexType());
+
+    const auto Load = [&geometry, target, indexSize, offset](std::span<const std::uint32_t> source, std::size_t first) {
+
+        const auto destination = static_cast<GLintptr>(offset + first * indexSize);
+        if (geometry.indexType() == GL_UNSIGNED_SHORT) {
+            const std::vector<std::uint16_t> shortIndices{ source.begin(), source.end() };
+            glBufferSubData(target, destination, static_cast<GLsizeiptr>(shortIndices.size() * indexSize), shortIndices.data());
+        }
+        else {
+            glBufferSubData(target, destination, static_cast<GLsizeiptr>(source.size_bytes()), source.data());
+        }
+    };
+
+    Load(*geometry.indices(), 0);
+
+    std::size_t first = geometry.indexCount();
+    for (const VertexBuffered::Lod& lod : geometry.lods()) {
+        Load(lod.indices, first);
+        first += lod.indices.size();
+    }
+}
+
 bool LoadBufferData(const VertexBuffered& geometry, const ShaderProgram* pProgram) {
 
     if (!geometry.initialized()) {
@@ -154,25 +330,40 @@ bool LoadBufferData(const VertexBuffered& geometry, const ShaderProgram* pProgra
         glBufferData(GL_ARRAY_BUFFER, bufferSize, pBufferData, GL_STATIC_DRAW);
     };
 
+    // Arena geometry writes into its ranges, everything else fills buffers of its own.
+    if (const GeometryArena::Allocation* pAllocation = geometry.allocation().get()) {
+
+        if (vertices && pProgram->hasAttribute("position"))
+            LoadInterleavedBuffer(*pAllocation, geometry, InterleavedLayout(geometry, pProgram));
+
+        if (indices && pProgram->hasAttribute("position")) {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, pAllocation->indexBufferId());
+            LoadIndices(geometry, GL_COPY_WRITE_BUFFER, pAllocation->indexOffset());
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        }
+
+        return true;
+    }
+
     glBindVertexArray(geometry.id());
 
     if (colors && pProgram->hasAttribute("color"))
-        LoadBuffer(geometry.colorBufferId(), sizeof(glm::vec4) * colors->size(), colors->data());
+        LoadBuffer(geometry.colorBufferId(), colors->size_bytes(), colors->data());
 
     if (normals && pProgram->hasAttribute("normal"))
-        LoadBuffer(geometry.normalBufferId(), sizeof(glm::vec3) * normals->size(), normals->data());
+        LoadBuffer(geometry.normalBufferId(), normals->size_bytes(), normals->data());
 
     if (texels && pProgram->hasAttribute("texel"))
-        LoadBuffer(geometry.texelBufferId(), sizeof(glm::uvec2) * texels->size(), texels->data());
+        LoadBuffer(geometry.texelBufferId(), texels->size_bytes(), texels->data());
 
     if (vertices && pProgram->hasAttribute("position"))
-        LoadBuffer(geometry.vertexBufferId(), sizeof(glm::vec3) * vertices->size(), vertices->data());
+        LoadBuffer(geometry.vertexBufferId(), vertices->size_bytes(), vertices->data());
 
-    // Don't push up any index data if we have no vertex positions.
+    // Don't push up any index data if we have no vertex positions. Levels of detail follow the full index list.
     if (indices && pProgram->hasAttribute("position")) {
-        const GLsizeiptr bufferSize = sizeof(uint32_t) * indices->size();
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geometry.indexBufferId());
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, bufferSize, geometry.indices()->data(), GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(TotalIndexCount(geometry) * IndexSize(geometry.indexType())), nullptr, GL_STATIC_DRAW);
+        LoadIndices(geometry, GL_ELEMENT_ARRAY_BUFFER, 0);
     }
 
     glBindVertexArray(0);
@@ -181,20 +372,73 @@ bool LoadBufferData(const VertexBuffered& geometry, const ShaderProgram* pProgra
 
     return true;
 }
+
+// Specifies one level of the bound texture. With a pixel buffer bound the data pointer is an offset into it.
+void SpecifyLevel(const Texture& texture, unsigned int level, GLsizei width, GLsizei height, const void* pData) {
+
+    const auto target = static_cast<GLenum>(texture.target());
+
+    if (Texture::IsCompressed(texture.pixelFormat())) {
+        const std::size_t size = Texture::ImageSize(width, height, texture.pixelFormat());
+        glCompressedTexImage2D(target, static_cast<GLint>(level), static_cast<GLenum>(texture.pixelFormat()), width, height, 0, static_cast<GLsizei>(size), pData);
+    }
+    else {
+        glTexImage2D(
+            target,                                         // Target
+            static_cast<GLint>(level),                      // Level
+            static_cast<GLint>(texture.textureFormat()),    // internal format
+            width,                                          // width
+            height,                                         // height
+            0,                                              // border
+            static_cast<GLint>(texture.pixelFormat()),      // format
+            GL_UNSIGNED_BYTE,                               // type
+            pData                                           // data
+        );
+    }
+}
 } // end unnamed namespace
 
 struct Renderer::Private {
     std::unique_ptr<ShaderProgram> loadShaders(const std::filesystem::path& vertexShader, const std::filesystem::path& fragmentShader);
-    void draw(const VertexBuffered& geometry, const IMaterial& material, const glm::mat4& transform) const;
+    // Binds the material's program and sets everything shared by the draws that use it.
+    ShaderProgram* prepare(const IMaterial& material) const;
+    // Instances tell apart the draws of shared geometry, each keeps its own level of detail.
+    void draw(const VertexBuffered& geometry, ShaderProgram* pShader, const glm::mat4& transform, std::size_t instance) const;
+
+    // Level of detail to draw, 0 being the full mesh. Picks the coarsest level whose error stays within a pixel on
+    // screen, unless a level is locked.
+    unsigned int selectLod(const VertexBuffered& geometry, const glm::mat4& transform, std::size_t instance) const;
+
+    // Draws the meshlets that may be visible from the camera. Returns false when the geometry isn't split into any.
+    bool drawMeshlets(const VertexBuffered& geometry, const glm::mat4& transform, std::size_t indexBase, GLint baseVertex) const;
 
     std::array<DirectionalLight*, 3> m_lights;
 
     glm::vec3* m_pAmbientColor = nullptr;
     float* m_pAmbientIntensity = nullptr;
 
+    int* m_pLodLock = nullptr;
+
     Camera* m_pCamera = nullptr;
 
     std::queue<Framebuffer> m_framebuffers;
+    unsigned int m_viewportHeight = 0;
+
+    // Levels of detail picked last frame, per geometry and instance. Forgotten when a different model is drawn.
+    mutable const std::vector<VertexBuffered>* m_pLodModel = nullptr;
+    mutable std::map<std::pair<const VertexBuffered*, std::size_t>, unsigned int> m_lodLevels;
+
+    // Scratch space for the meshlet draws, kept between frames.
+    mutable std::vector<Meshlet::IndexRange> m_visibleRanges;
+    mutable std::vector<GLsizei> m_drawCounts;
+    mutable std::vector<const void*> m_drawOffsets;
+    mutable std::vector<GLint> m_drawBaseVertices;
+
+    // Geometry in the same arena shares a vertex array, it's only bound again when the next draw needs another.
+    mutable GLuint m_boundVertexArrayId = 0;
+
+    // Owned by the renderer so the buffers are deleted while the context is still current.
+    ArenaMap m_arenas;
 };
 
 std::unique_ptr<ShaderProgram> Renderer::Private::loadShaders(const std::filesystem::path& vertexPath, const std::filesystem::path& fragmentPath) {
@@ -232,21 +476,15 @@ std::unique_ptr<ShaderProgram> Renderer::Private::loadShaders(const std::filesys
     return std::make_unique<ShaderProgram>(std::move(shader));
 }
 
-void Renderer::Private::draw(const VertexBuffered& geometry, const IMaterial& material, const glm::mat4& transform) const {
+ShaderProgram* Renderer::Private::prepare(const IMaterial& material) const {
 
     ShaderProgram* pShader = shaderCache()->get(material);
     if (!pShader) {
         assert(false);
-        return;
-    }
-
-    if (!geometry.initialized()) {
-        assert(false);
-        return;
+        return nullptr;
     }
 
     pShader->use();
-    pShader->set("matrices.model", transform);
     pShader->set("matrices.viewProjection", m_pCamera->viewProjection());
     pShader->set("eyePoint", m_pCamera->position());
 
@@ -267,26 +505,148 @@ void Renderer::Private::draw(const VertexBuffered& geometry, const IMaterial& ma
             pLight->apply(pShader, lightIndex);
     }
 
-    const auto indices = geometry.indices();
-    const auto vertices = geometry.vertices();
+    return pShader;
+}
+
+void Renderer::Private::draw(const VertexBuffered& geometry, ShaderProgram* pShader, const glm::mat4& transform, std::size_t instance) const {
+
+    if (!geometry.initialized()) {
+        assert(false);
+        return;
+    }
+
+    // Compact positions are dequantized by the model matrix. Normals only see the object's transform.
+    pShader->set("matrices.model", transform * geometry.positionTransform());
+    pShader->set("matrices.normal", glm::inverseTranspose(transform));
+    pShader->set("octahedralNormals", geometry.encoding() == VertexEncoding::Compact);
+
+    const std::size_t indexCount = geometry.indexCount();
+    const std::size_t vertexCount = geometry.vertexCount();
     const VertexBuffered::PrimativeType primitive = geometry.primativeType();
 
-    if (geometry.colors().has_value())
-        pShader->set("hasVertexColor", true);
-    else
-        pShader->set("hasVertexColor", false);
+    pShader->set("hasVertexColor", geometry.hasColors());
 
-    glBindVertexArray(geometry.id());
+    // Arena geometry draws from its ranges of the shared buffers.
+    const GeometryArena::Allocation* pAllocation = geometry.allocation().get();
+    const GLuint vertexArrayId = pAllocation ? pAllocation->vertexArrayId() : geometry.id();
+    const std::size_t indexBase = pAllocation ? pAllocation->indexOffset() : 0;
+    const auto baseVertex = static_cast<GLint>(pAllocation ? pAllocation->baseVertex() : 0);
 
-    if (indices)
-        glDrawElements(static_cast<GLenum>(primitive), indices->size(), GL_UNSIGNED_INT, reinterpret_cast<void*>(0));
-    else if (vertices)
-        glDrawArrays(static_cast<GLenum>(primitive), 0, vertices->size());
+    if (vertexArrayId != m_boundVertexArrayId) {
+        glBindVertexArray(vertexArrayId);
+        m_boundVertexArrayId = vertexArrayId;
+    }
 
-    glBindVertexArray(0);
+    const unsigned int level = indexCount > 0 ? selectLod(geometry, transform, instance) : 0;
+
+    if (level > 0) {
+
+        // Meshlets belong to the full mesh, coarser levels are drawn whole.
+        std::size_t first = indexCount;
+        for (unsigned int index = 0; index + 1 < level; ++index)
+            first += geometry.lodIndexCount(index);
+
+        const std::size_t offset = indexBase + first * IndexSize(geometry.indexType());
+        glDrawElementsBaseVertex(static_cast<GLenum>(primitive), static_cast<GLsizei>(geometry.lodIndexCount(level - 1)), geometry.indexType(), reinterpret_cast<void*>(offset), baseVertex);
+    }
+    else if (indexCount > 0) {
+        if (!drawMeshlets(geometry, transform, indexBase, baseVertex))
+            glDrawElementsBaseVertex(static_cast<GLenum>(primitive), static_cast<GLsizei>(indexCount), geometry.indexType(), reinterpret_cast<void*>(indexBase), baseVertex);
+    }
+    else if (vertexCount > 0) {
+        glDrawArrays(static_cast<GLenum>(primitive), baseVertex, static_cast<GLsizei>(vertexCount));
+    }
+}
+
+bool Renderer::Private::drawMeshlets(const VertexBuffered& geometry, const glm::mat4& transform, std::size_t indexBase, GLint baseVertex) const {
+
+    const std::vector<Meshlet>& meshlets = geometry.meshlets();
+    if (meshlets.size() < 2 || !m_pCamera)
+        return false;
+
+    // Cull in model space, the meshlet bounds stay as they were built.
+    const Frustum frustum{ m_pCamera->viewProjection() * transform };
+
+    // Cones only hold for a viewer at a point, and mirrored transforms flip which side the driver culls.
+    std::optional<glm::vec3> viewer;
+    if (!dynamic_cast<const OrthographicCamera*>(m_pCamera) && glm::determinant(glm::mat3{ transform }) > 0.f)
+        viewer = glm::vec3{ glm::inverse(transform) * glm::vec4{ m_pCamera->position(), 1.f } };
+
+    Meshlet::Cull(meshlets, frustum, viewer, m_visibleRanges);
+
+    const GLenum indexType = geometry.indexType();
+    const std::size_t indexSize = IndexSize(indexType);
+
+    m_drawCounts.clear();
+    m_drawOffsets.clear();
+
+    for (const Meshlet::IndexRange& range : m_visibleRanges) {
+        m_drawCounts.push_back(static_cast<GLsizei>(range.count));
+        m_drawOffsets.push_back(reinterpret_cast<const void*>(indexBase + range.first * indexSize));
+    }
+
+    m_drawBaseVertices.assign(m_drawCounts.size(), baseVertex);
+
+    if (!m_drawCounts.empty())
+        glMultiDrawElementsBaseVertex(static_cast<GLenum>(geometry.primativeType()), m_drawCounts.data(), indexType, m_drawOffsets.data(), static_cast<GLsizei>(m_drawCounts.size()), m_drawBaseVertices.data());
+
+    return true;
 }
 
-void Renderer::Allocate(Mesh& mesh) {
+unsigned int Renderer::Private::selectLod(const VertexBuffered& geometry, const glm::mat4& transform, std::size_t instance) const {
+
+    const std::vector<VertexBuffered::Lod>& lods = geometry.lods();
+    if (lods.empty())
+        return 0;
+
+    const auto levelCount = static_cast<unsigned int>(lods.size());
+    if (m_pLodLock && *m_pLodLock >= 0)
+        return std::min(static_cast<unsigned int>(*m_pLodLock), levelCount);
+
+    if (!m_pCamera || m_viewportHeight == 0)
+        return 0;
+
+    const glm::mat4 viewProjection = m_pCamera->viewProjection();
+
+    const VertexBounds& bounds = geometry.bounds();
+    const glm::vec3 center = bounds.min + bounds.extent * .5f;
+    const float scale = std::max({ glm::length(glm::vec3{ transform[0] }), glm::length(glm::vec3{ transform[1] }), glm::length(glm::vec3{ transform[2] }) });
+
+    // Errors are measured at the nearest point of the bounds, a camera inside them always sees the full mesh.
+    float depth = (viewProjection * transform * glm::vec4{ center, 1.f }).w;
+    if (!dynamic_cast<const OrthographicCamera*>(m_pCamera)) {
+
+        depth -= glm::length(bounds.extent) * .5f * scale;
+        if (depth <= 0.f)
+            return 0;
+    }
+
+    // Clip space height per model unit, from the projection's vertical row.
+    const glm::vec3 vertical{ viewProjection[0][1], viewProjection[1][1], viewProjection[2][1] };
+    const float pixelsPerUnit = glm::length(vertical) * scale / depth * static_cast<float>(m_viewportHeight) * .5f;
+
+    // The coarsest level within the error, and the coarsest one comfortably within it.
+    unsigned int allowed = 0;
+    unsigned int comfortable = 0;
+
+    for (unsigned int index = 1; index <= levelCount; ++index) {
+
+        const float pixels = lods[index - 1].error * pixelsPerUnit;
+        if (pixels <= kLodPixelError)
+            allowed = index;
+
+        if (pixels <= kLodPixelError * kLodHysteresis)
+            comfortable = index;
+    }
+
+    // Refine as soon as the current level shows too much error, coarsen only once past the hysteresis band.
+    unsigned int& level = m_lodLevels[{ &geometry, instance }];
+    level = level > allowed ? allowed : std::max(level, comfortable);
+
+    return level;
+}
+
+void Renderer::allocate(Mesh& mesh) {
 
     if (!mesh.model() || !mesh.material())
         return;
@@ -297,34 +657,129 @@ void Renderer::Allocate(Mesh& mesh) {
 
     for (VertexBuffered& geometry : *mesh.model()) {
 
-        if (!geometry.initialized())
+        if (!geometry.initialized() || geometry.released())
             continue;
 
         if (!LoadBufferData(geometry, pProgram))
             return;
+
+        // GPU resident meshes keep only what drawing needs.
+        if (mesh.gpuResident())
+            geometry.releaseBuffer();
     }
 }
 
-void Renderer::Allocate(const Texture& texture, std::uint8_t* pData) {
+void Renderer::Allocate(const Texture& texture, const std::uint8_t* pData) {
 
-    glBindTexture(static_cast<GLenum>(texture.target()), texture.id());
+    const auto target = static_cast<GLenum>(texture.target());
+    const bool compressed = Texture::IsCompressed(texture.pixelFormat());
 
-    glTexImage2D(
-        static_cast<GLenum>(texture.target()),          // Target
-        0,                                              // Level
-        static_cast<GLint>(texture.textureFormat()),    // internal format
-        texture.width(),                                // width
-        texture.height(),                               // height
-        0,                                              // border
-        static_cast<GLint>(texture.pixelFormat()),      // format
-        GL_UNSIGNED_BYTE,                               // type
-        pData                                           // data
-    );
+    glBindTexture(target, texture.id());
 
-    glBindTexture(static_cast<GLenum>(texture.target()), 0);
+    // Without data the levels are only allocated, unless a pixel buffer is bound and the data pointer is an offset into it.
+    GLint pixelBufferId = 0;
+    if (!pData)
+        glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &pixelBufferId);
+
+    const bool hasData = pData || pixelBufferId != 0;
+
+    // Levels follow each other in the data, largest first. Step through it as an address since it may be an offset.
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(pData);
+
+    for (unsigned int level = 0; level < std::max(texture.levelCount(), 1u); ++level) {
+
+        const auto width = static_cast<GLsizei>(std::max(texture.width() >> level, 1u));
+        const auto height = static_cast<GLsizei>(std::max(texture.height() >> level, 1u));
+        const std::size_t size = Texture::ImageSize(width, height, texture.pixelFormat());
+        SpecifyLevel(texture, level, width, height, hasData ? reinterpret_cast<const void*>(address) : nullptr);
+        address += size;
+    }
+
+    // Textures without a prebuilt chain get theirs from the driver, which can only filter uncompressed formats.
+    if (texture.mipmap() && texture.levelCount() <= 1 && !compressed && hasData)
+        glGenerateMipmap(target);
+
+    glBindTexture(target, 0);
+}
+
+void Renderer::Evict(Texture& texture, unsigned int baseLevel) {
+
+    baseLevel = std::min(baseLevel, std::max(texture.levelCount(), 1u) - 1);
+
+    const unsigned int firstLevel = texture.baseLevel();
+    if (baseLevel <= firstLevel)
+        return;
+
+    // Move sampling off the levels first, so the texture stays complete without them.
+    texture.baseLevel(baseLevel);
+    Configure(texture);
+
+    const auto target = static_cast<GLenum>(texture.target());
+    glBindTexture(target, texture.id());
+
+    // Respecifying a level as empty hands its storage back to the driver.
+    for (unsigned int level = firstLevel; level < baseLevel; ++level)
+        SpecifyLevel(texture, level, 0, 0, nullptr);
+
+    glBindTexture(target, 0);
+}
+
+void Renderer::Reserve(const Texture& texture) {
+
+    const auto target = static_cast<GLenum>(texture.target());
+    glBindTexture(target, texture.id());
+
+    for (unsigned int level = 0; level < texture.baseLevel(); ++level) {
+
+        const auto width = static_cast<GLsizei>(std::max(texture.width() >> level, 1u));
+        const auto height = static_cast<GLsizei>(std::max(texture.height() >> level, 1u));
+        SpecifyLevel(texture, level, width, height, nullptr);
+    }
+
+    glBindTexture(target, 0);
+}
+
+void Renderer::Allocate(const Texture& texture, unsigned int level, const std::uint8_t* pData) {
+
+    const auto target = static_cast<GLenum>(texture.target());
+
+    const auto width = static_cast<GLsizei>(std::max(texture.width() >> level, 1u));
+    const auto height = static_cast<GLsizei>(std::max(texture.height() >> level, 1u));
+
+    glBindTexture(target, texture.id());
+
+    if (Texture::IsCompressed(texture.pixelFormat())) {
+        const std::size_t size = Texture::ImageSize(width, height, texture.pixelFormat());
+        glCompressedTexSubImage2D(target, static_cast<GLint>(level), 0, 0, width, height, static_cast<GLenum>(texture.pixelFormat()), static_cast<GLsizei>(size), pData);
+    }
+    else {
+        glTexSubImage2D(target, static_cast<GLint>(level), 0, 0, width, height, static_cast<GLenum>(texture.pixelFormat()), GL_UNSIGNED_BYTE, pData);
+    }
+
+    glBindTexture(target, 0);
+}
+
+bool Renderer::SupportsCompressedFormat(GLenum format) {
+
+    static const std::set<GLenum> formats = []() {
+
+        GLint formatCount = 0;
+        glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &formatCount);
+
+        std::vector<GLint> supported(static_cast<std::size_t>(std::max(formatCount, 0)));
+        if (!supported.empty())
+            glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, supported.data());
+
+        // RGTC is core since 3.0 but drivers aren't required to list it.
+        std::set<GLenum> formats{ GL_COMPRESSED_RED_RGTC1, GL_COMPRESSED_RG_RGTC2 };
+        formats.insert(supported.cbegin(), supported.cend());
+        return formats;
+    }();
+
+    return formats.contains(format);
 }
 
-void Renderer::Configure(Mesh& mesh) {
+void Renderer::configure(Mesh& mesh) {
 
     if (!mesh.model() || !mesh.material())
         return;
@@ -333,9 +788,31 @@ void Renderer::Configure(Mesh& mesh) {
     if (!pProgram)
         return;
 
+    // Released geometry has nothing left to upload. Arena ranges the program reads as they are keep drawing, anything
+    // else waits for the owner to reload the model in the background, which configures the mesh again once it arrives.
+    const auto Reloads = [this, pProgram](const VertexBuffered& geometry) {
+        return geometry.released() && !InMatchingArena(m_pPrivate->m_arenas, geometry, pProgram);
+    };
+
+    if (std::ranges::any_of(*mesh.model(), Reloads)) {
+        mesh.geometryRequested(true);
+        mesh.initialized(true);
+        return;
+    }
+
     for (VertexBuffered& geometry : *mesh.model()) {
 
-        // Create any buffers that need to be created.
+        if (geometry.released())
+            continue;
+
+        // Interleaved geometry takes ranges of a shared arena, planar geometry creates buffers of its own.
+        if (geometry.layout() == VertexBuffered::Layout::Interleaved) {
+            if (!AllocateInterleaved(m_pPrivate->m_arenas, geometry, pProgram))
+                return;
+
+            continue;
+        }
+
         geometry.initialize();
         if (!ConfigureAttributes(geometry, pProgram))
             return;
@@ -351,8 +828,10 @@ void Renderer::Configure(Texture& texture) {
 
     glBindTexture(static_cast<GLenum>(texture.target()), texture.id());
 
-    if (texture.mipmap())
-        glGenerateMipmap(static_cast<GLenum>(texture.target()));
+    // Mipmaps are built once the pixels are allocated. Until then, limit sampling to the levels that will exist.
+    const GLint maxLevel = std::max(texture.mipmap() && texture.levelCount() <= 1 ? 1000 : static_cast<GLint>(texture.levelCount()) - 1, 0);
+    glTexParameteri(static_cast<GLenum>(texture.target()), GL_TEXTURE_BASE_LEVEL, std::min(static_cast<GLint>(texture.baseLevel()), maxLevel));
+    glTexParameteri(static_cast<GLenum>(texture.target()), GL_TEXTURE_MAX_LEVEL, maxLevel);
 
     glTexParameteri(static_cast<GLenum>(texture.target()), GL_TEXTURE_MIN_FILTER, static_cast<GLint>(texture.minFilter()));
     glTexParameteri(static_cast<GLenum>(texture.target()), GL_TEXTURE_MAG_FILTER, static_cast<GLint>(texture.magFilter()));
@@ -397,6 +876,8 @@ void Renderer::createFramebuffer(const glm::uvec2& dimensions) {
         renderbufferAttachment
     );
 
+    m_pPrivate->m_viewportHeight = dimensions.y;
+
     if (!newFramebuffer.createAttachments()) {
 #ifdef GLAD_DEBUG
         DebugFramebufferAttachmentStatus(newFramebuffer.status());
@@ -445,6 +926,8 @@ DEFINE_SETTER_CONSTREF(Renderer, directionalLights, m_pPrivate->m_lights)
 DEFINE_SETTER_COPY(Renderer, ambientColor, m_pPrivate->m_pAmbientColor)
 DEFINE_SETTER_COPY(Renderer, ambientIntensity, m_pPrivate->m_pAmbientIntensity)
 
+DEFINE_SETTER_COPY(Renderer, lodLock, m_pPrivate->m_pLodLock)
+
 void Renderer::setup() {
 
     shaderCache()->registerProgram<PhongTexturedMaterial>(m_pPrivate->loadShaders("glsl/phong.vert", "glsl/phong.frag"));
@@ -465,13 +948,44 @@ void Renderer::camera(Camera* pCamera) {
     m_pPrivate->m_pCamera = pCamera;
 }
 
+void Renderer::releaseGeometry() {
+    m_pPrivate->m_arenas.clear();
+}
+
 void Renderer::draw(const Mesh& mesh) const {
 
     if (!mesh.model() || !mesh.material())
         return;
 
-    for (const VertexBuffered& geometry : *mesh.model())
-        m_pPrivate->draw(geometry, *mesh.material(), mesh.transform());
+    ShaderProgram* pShader = m_pPrivate->prepare(*mesh.material());
+    if (!pShader)
+        return;
+
+    const std::vector<VertexBuffered>& model = *mesh.model();
+    const glm::mat4 transform = mesh.transform();
+
+    if (m_pPrivate->m_pLodModel != &model) {
+        m_pPrivate->m_pLodModel = &model;
+        m_pPrivate->m_lodLevels.clear();
+    }
+
+    m_pPrivate->m_boundVertexArrayId = 0;
+
+    if (mesh.instances().empty()) {
+        for (const VertexBuffered& geometry : model)
+            m_pPrivate->draw(geometry, pShader, transform, 0);
+    }
+    else {
+        // Shared geometry is drawn once per node that references it.
+        for (std::size_t instanceIndex = 0; instanceIndex < mesh.instances().size(); ++instanceIndex) {
+
+            const MeshInstance& instance = mesh.instances()[instanceIndex];
+            if (instance.meshIndex < model.size())
+                m_pPrivate->draw(model[instance.meshIndex], pShader, transform * instance.transform, instanceIndex);
+        }
+    }
+
+    glBindVertexArray(0);
 }
 
 ShaderCache* Renderer::shaderCache() {
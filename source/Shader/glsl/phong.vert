@@ -14,16 +14,30 @@ out FragmentData {
 
 struct Matrices {
     mat4 model;
+    mat4 normal;
     mat4 viewProjection;
 };
 
 uniform Matrices matrices;
+uniform bool octahedralNormals;
+
+// Unfolds a normal stored as two components on an octahedron.
+vec3 OctahedralDecode(vec2 encoded) {
+
+    vec3 normal = vec3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float fold = clamp(-normal.z, 0.0f, 1.0f);
+    normal.xy += vec2(normal.x >= 0.0f ? -fold : fold, normal.y >= 0.0f ? -fold : fold);
+
+    return normalize(normal);
+}
 
 void main() {
 
     gl_Position = matrices.viewProjection * matrices.model * vec4(position, 1.0f);
     
-    vertOut.normal = mat3(transpose(inverse(matrices.model))) * normalize(normal);
+    vec3 modelNormal = octahedralNormals ? OctahedralDecode(normal.xy) : normalize(normal);
+
+    vertOut.normal = mat3(matrices.normal) * modelNormal;
     vertOut.position = vec3(matrices.model * vec4(position, 1.0f));
     vertOut.color = color;
     vertOut.texel = texel;
@@ -0,0 +1,632 @@
+#include "Texture/BlockCompression.hpp"
+
+#include "Common/ThreadPool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace {
+using Texel = std::array<std::uint8_t, 4>;
+using Block = std::array<Texel, 16>;
+
+constexpr unsigned int kBlockSize = 4;
+
+std::size_t BlockBytes(Texture::Channels format) {
+    return format == Texture::Channels::BC1 || format == Texture::Channels::BC4 ? 8 : 16;
+}
+
+// Reads a 4x4 block as RGBA, repeating the last row and column past the edges of the level.
+Block LoadBlock(const std::uint8_t* pPixels, unsigned int width, unsigned int height, Texture::Channels channels, unsigned int blockX, unsigned int blockY) {
+
+    const unsigned int channelCount = Texture::ChannelCount(channels);
+    const bool swizzled = channels == Texture::Channels::BGRA;
+
+    Block block;
+    for (unsigned int y = 0; y < kBlockSize; ++y) {
+        for (unsigned int x = 0; x < kBlockSize; ++x) {
+
+            const std::size_t pixelX = std::min(blockX * kBlockSize + x, width - 1);
+            const std::size_t pixelY = std::min(blockY * kBlockSize + y, height - 1);
+            const std::uint8_t* pPixel = pPixels + (pixelY * width + pixelX) * channelCount;
+
+            Texel& texel = block[y * kBlockSize + x];
+            texel = { 0, 0, 0, 255 };
+
+            for (unsigned int channel = 0; channel < channelCount; ++channel)
+                texel[channel] = pPixel[channel];
+
+            if (swizzled)
+                std::swap(texel[0], texel[2]);
+        }
+    }
+
+    return block;
+}
+
+void StoreBlock(const Block& block, unsigned int channelCount, unsigned int blockX, unsigned int blockY, unsigned int width, unsigned int height, std::uint8_t* pPixels) {
+
+    for (unsigned int y = 0; y < kBlockSize; ++y) {
+        for (unsigned int x = 0; x < kBlockSize; ++x) {
+
+            const std::size_t pixelX = blockX * kBlockSize + x;
+            const std::size_t pixelY = blockY * kBlockSize + y;
+            if (pixelX >= width || pixelY >= height)
+                continue;
+
+            std::memcpy(pPixels + (pixelY * width + pixelX) * channelCount, block[y * kBlockSize + x].data(), channelCount);
+        }
+    }
+}
+
+// A row of blocks in one mip level, the unit of work handed to the pool.
+struct BlockRow {
+    unsigned int level = 0;
+    unsigned int blockY = 0;
+};
+
+std::vector<BlockRow> BlockRows(const Image& image) {
+
+    std::vector<BlockRow> rows;
+    for (unsigned int level = 0; level < image.levelCount(); ++level) {
+        for (unsigned int blockY = 0; blockY < (image.levelHeight(level) + kBlockSize - 1) / kBlockSize; ++blockY)
+            rows.push_back({ level, blockY });
+    }
+
+    return rows;
+}
+
+template<std::size_t Channels>
+int Distance(const Texel& a, const Texel& b) {
+
+    int distance = 0;
+    for (std::size_t channel = 0; channel < Channels; ++channel) {
+        const int delta = static_cast<int>(a[channel]) - static_cast<int>(b[channel]);
+        distance += delta * delta;
+    }
+
+    return distance;
+}
+
+template<std::size_t Channels>
+std::size_t Nearest(const Texel& texel, const Texel* pPalette, std::size_t paletteSize, int& error) {
+
+    std::size_t best = 0;
+    error = std::numeric_limits<int>::max();
+
+    for (std::size_t index = 0; index < paletteSize; ++index) {
+
+        const int distance = Distance<Channels>(texel, pPalette[index]);
+        if (distance < error) {
+            error = distance;
+            best = index;
+        }
+    }
+
+    return best;
+}
+
+// Extremes of the block along its principal axis, found with a few rounds of power iteration.
+template<std::size_t Channels>
+std::pair<std::array<float, Channels>, std::array<float, Channels>> PrincipalEndpoints(const Block& block) {
+
+    std::array<float, Channels> mean{};
+    for (const Texel& texel : block) {
+        for (std::size_t channel = 0; channel < Channels; ++channel)
+            mean[channel] += texel[channel] / 16.f;
+    }
+
+    std::array<std::array<float, Channels>, Channels> covariance{};
+    for (const Texel& texel : block) {
+        for (std::size_t row = 0; row < Channels; ++row) {
+            for (std::size_t column = 0; column < Channels; ++column)
+                covariance[row][column] += (texel[row] - mean[row]) * (texel[column] - mean[column]);
+        }
+    }
+
+    std::array<float, Channels> axis;
+    axis.fill(1.f);
+
+    for (int iteration = 0; iteration < 8; ++iteration) {
+
+        std::array<float, Channels> next{};
+        for (std::size_t row = 0; row < Channels; ++row) {
+            for (std::size_t column = 0; column < Channels; ++column)
+                next[row] += covariance[row][column] * axis[column];
+        }
+
+        float length = 0.f;
+        for (const float value : next)
+            length = std::max(length, std::abs(value));
+
+        if (length < 1e-6f)
+            break;
+
+        for (std::size_t channel = 0; channel < Channels; ++channel)
+            axis[channel] = next[channel] / length;
+    }
+
+    float minimum = std::numeric_limits<float>::max();
+    float maximum = std::numeric_limits<float>::lowest();
+
+    for (const Texel& texel : block) {
+
+        float projection = 0.f;
+        for (std::size_t channel = 0; channel < Channels; ++channel)
+            projection += (texel[channel] - mean[channel]) * axis[channel];
+
+        minimum = std::min(minimum, projection);
+        maximum = std::max(maximum, projection);
+    }
+
+    float lengthSquared = 0.f;
+    for (const float value : axis)
+        lengthSquared += value * value;
+
+    std::pair<std::array<float, Channels>, std::array<float, Channels>> endpoints;
+    for (std::size_t channel = 0; channel < Channels; ++channel) {
+        endpoints.first[channel] = std::clamp(mean[channel] + axis[channel] * minimum / lengthSquared, 0.f, 255.f);
+        endpoints.second[channel] = std::clamp(mean[channel] + axis[channel] * maximum / lengthSquared, 0.f, 255.f);
+    }
+
+    return endpoints;
+}
+
+void Write16(std::uint8_t* pOut, std::uint16_t value) {
+    pOut[0] = static_cast<std::uint8_t>(value);
+    pOut[1] = static_cast<std::uint8_t>(value >> 8);
+}
+
+std::uint16_t Read16(const std::uint8_t* pIn) {
+    return static_cast<std::uint16_t>(pIn[0] | (pIn[1] << 8));
+}
+
+std::uint16_t To565(const std::array<float, 3>& color) {
+
+    const auto r = static_cast<std::uint16_t>(std::lround(color[0] * 31.f / 255.f));
+    const auto g = static_cast<std::uint16_t>(std::lround(color[1] * 63.f / 255.f));
+    const auto b = static_cast<std::uint16_t>(std::lround(color[2] * 31.f / 255.f));
+
+    return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+}
+
+Texel From565(std::uint16_t color) {
+
+    const unsigned int r = (color >> 11) & 31;
+    const unsigned int g = (color >> 5) & 63;
+    const unsigned int b = color & 31;
+
+    return {
+        static_cast<std::uint8_t>((r << 3) | (r >> 2)),
+        static_cast<std::uint8_t>((g << 2) | (g >> 4)),
+        static_cast<std::uint8_t>((b << 3) | (b >> 2)),
+        255
+    };
+}
+
+Texel Mix(const Texel& a, const Texel& b, int weightA, int weightB, int divisor) {
+
+    Texel mixed;
+    for (std::size_t channel = 0; channel < 4; ++channel)
+        mixed[channel] = static_cast<std::uint8_t>((a[channel] * weightA + b[channel] * weightB + divisor / 2) / divisor);
+
+    return mixed;
+}
+
+// BC1 color, always in four color mode. Used on its own and as the color half of BC3.
+void EncodeColor(const Block& block, std::uint8_t* pOut) {
+
+    const auto [low, high] = PrincipalEndpoints<3>(block);
+
+    std::uint16_t color0 = To565(high);
+    std::uint16_t color1 = To565(low);
+    if (color0 < color1)
+        std::swap(color0, color1);
+
+    Write16(pOut, color0);
+    Write16(pOut + 2, color1);
+
+    std::uint32_t indices = 0;
+
+    if (color0 != color1) {
+
+        const Texel endpoint0 = From565(color0);
+        const Texel endpoint1 = From565(color1);
+        const std::array<Texel, 4> palette{ endpoint0, endpoint1, Mix(endpoint0, endpoint1, 2, 1, 3), Mix(endpoint0, endpoint1, 1, 2, 3) };
+
+        for (std::size_t texel = 0; texel < block.size(); ++texel) {
+            int error = 0;
+            indices |= static_cast<std::uint32_t>(Nearest<3>(block[texel], palette.data(), palette.size(), error)) << (texel * 2);
+        }
+    }
+
+    std::memcpy(pOut + 4, &indices, sizeof(indices));
+}
+
+// BC4 for one channel of the block. Used for BC4, BC5 and the alpha half of BC3.
+void EncodeChannel(const Block& block, std::size_t channel, std::uint8_t* pOut) {
+
+    std::uint8_t minimum = 255;
+    std::uint8_t maximum = 0;
+
+    for (const Texel& texel : block) {
+        minimum = std::min(minimum, texel[channel]);
+        maximum = std::max(maximum, texel[channel]);
+    }
+
+    pOut[0] = maximum;
+    pOut[1] = minimum;
+
+    std::uint64_t indices = 0;
+
+    if (maximum != minimum) {
+
+        std::array<int, 8> palette{ maximum, minimum };
+        for (int step = 1; step < 7; ++step)
+            palette[step + 1] = ((7 - step) * maximum + step * minimum + 3) / 7;
+
+        for (std::size_t texel = 0; texel < block.size(); ++texel) {
+
+            std::uint64_t best = 0;
+            int bestError = std::numeric_limits<int>::max();
+
+            for (std::size_t index = 0; index < palette.size(); ++index) {
+                const int error = std::abs(palette[index] - block[texel][channel]);
+                if (error < bestError) {
+                    bestError = error;
+                    best = index;
+                }
+            }
+
+            indices |= best << (texel * 3);
+        }
+    }
+
+    for (std::size_t byte = 0; byte < 6; ++byte)
+        pOut[2 + byte] = static_cast<std::uint8_t>(indices >> (byte * 8));
+}
+
+constexpr std::array<int, 16> kBC7Weights{ 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+class BitWriter {
+public:
+    explicit BitWriter(std::uint8_t* pOut)
+        : m_pOut(pOut) {
+        std::memset(m_pOut, 0, 16);
+    }
+
+    void write(std::uint32_t value, unsigned int bitCount) {
+
+        for (unsigned int bit = 0; bit < bitCount; ++bit, ++m_position) {
+            if (value & (1u << bit))
+                m_pOut[m_position / 8] |= static_cast<std::uint8_t>(1u << (m_position % 8));
+        }
+    }
+
+private:
+    std::uint8_t* m_pOut = nullptr;
+    unsigned int m_position = 0;
+};
+
+class BitReader {
+public:
+    explicit BitReader(const std::uint8_t* pIn)
+        : m_pIn(pIn) {}
+
+    std::uint32_t read(unsigned int bitCount) {
+
+        std::uint32_t value = 0;
+        for (unsigned int bit = 0; bit < bitCount; ++bit, ++m_position) {
+            if (m_pIn[m_position / 8] & (1u << (m_position % 8)))
+                value |= 1u << bit;
+        }
+
+        return value;
+    }
+
+private:
+    const std::uint8_t* m_pIn = nullptr;
+    unsigned int m_position = 0;
+};
+
+// BC7 mode 6: one subset, 7 bit RGBA endpoints with a shared bit each and 4 bit indices.
+void EncodeBC7(const Block& block, std::uint8_t* pOut) {
+
+    const auto [low, high] = PrincipalEndpoints<4>(block);
+
+    std::array<std::uint32_t, 2> bestShared{};
+    std::array<std::array<std::uint32_t, 4>, 2> bestEndpoints{};
+    std::array<std::uint32_t, 16> bestIndices{};
+    long long bestError = std::numeric_limits<long long>::max();
+
+    // Try every combination of the two shared bits.
+    for (std::uint32_t shared = 0; shared < 4; ++shared) {
+
+        const std::array<std::uint32_t, 2> sharedBits{ shared & 1, shared >> 1 };
+        std::array<std::array<std::uint32_t, 4>, 2> endpoints;
+        std::array<Texel, 2> expanded;
+
+        for (std::size_t channel = 0; channel < 4; ++channel) {
+            for (std::size_t endpoint = 0; endpoint < 2; ++endpoint) {
+
+                const float value = endpoint == 0 ? low[channel] : high[channel];
+                const auto quantized = static_cast<std::uint32_t>(std::clamp(std::lround((value - sharedBits[endpoint]) / 2.f), 0l, 127l));
+
+                endpoints[endpoint][channel] = quantized;
+                expanded[endpoint][channel] = static_cast<std::uint8_t>((quantized << 1) | sharedBits[endpoint]);
+            }
+        }
+
+        std::array<Texel, 16> palette;
+        for (std::size_t index = 0; index < palette.size(); ++index)
+            palette[index] = Mix(expanded[0], expanded[1], 64 - kBC7Weights[index], kBC7Weights[index], 64);
+
+        std::array<std::uint32_t, 16> indices;
+        long long error = 0;
+
+        for (std::size_t texel = 0; texel < block.size(); ++texel) {
+            int texelError = 0;
+            indices[texel] = static_cast<std::uint32_t>(Nearest<4>(block[texel], palette.data(), palette.size(), texelError));
+            error += texelError;
+        }
+
+        if (error < bestError) {
+            bestError = error;
+            bestShared = sharedBits;
+            bestEndpoints = endpoints;
+            bestIndices = indices;
+        }
+    }
+
+    // The first index is stored without its top bit, so it has to be in the lower half of the palette.
+    if (bestIndices[0] & 8) {
+        std::swap(bestEndpoints[0], bestEndpoints[1]);
+        std::swap(bestShared[0], bestShared[1]);
+
+        for (std::uint32_t& index : bestIndices)
+            index = 15 - index;
+    }
+
+    BitWriter writer{ pOut };
+    writer.write(1u << 6, 7);
+
+    for (std::size_t channel = 0; channel < 4; ++channel) {
+        writer.write(bestEndpoints[0][channel], 7);
+        writer.write(bestEndpoints[1][channel], 7);
+    }
+
+    writer.write(bestShared[0], 1);
+    writer.write(bestShared[1], 1);
+
+    writer.write(bestIndices[0], 3);
+    for (std::size_t texel = 1; texel < bestIndices.size(); ++texel)
+        writer.write(bestIndices[texel], 4);
+}
+
+void DecodeColor(const std::uint8_t* pIn, bool fourColorOnly, Block& block) {
+
+    const std::uint16_t color0 = Read16(pIn);
+    const std::uint16_t color1 = Read16(pIn + 2);
+
+    const Texel endpoint0 = From565(color0);
+    const Texel endpoint1 = From565(color1);
+
+    std::array<Texel, 4> palette{ endpoint0, endpoint1 };
+    if (color0 > color1 || fourColorOnly) {
+        palette[2] = Mix(endpoint0, endpoint1, 2, 1, 3);
+        palette[3] = Mix(endpoint0, endpoint1, 1, 2, 3);
+    }
+    else {
+        palette[2] = Mix(endpoint0, endpoint1, 1, 1, 2);
+        palette[3] = { 0, 0, 0, 0 };
+    }
+
+    std::uint32_t indices = 0;
+    std::memcpy(&indices, pIn + 4, sizeof(indices));
+
+    for (std::size_t texel = 0; texel < block.size(); ++texel) {
+        const Texel& color = palette[(indices >> (texel * 2)) & 3];
+        std::copy_n(color.cbegin(), 3, block[texel].begin());
+        block[texel][3] = color[3];
+    }
+}
+
+void DecodeChannel(const std::uint8_t* pIn, std::size_t channel, Block& block) {
+
+    const int value0 = pIn[0];
+    const int value1 = pIn[1];
+
+    std::array<int, 8> palette{ value0, value1 };
+    if (value0 > value1) {
+        for (int step = 1; step < 7; ++step)
+            palette[step + 1] = ((7 - step) * value0 + step * value1 + 3) / 7;
+    }
+    else {
+        for (int step = 1; step < 5; ++step)
+            palette[step + 1] = ((5 - step) * value0 + step * value1 + 2) / 5;
+
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    std::uint64_t indices = 0;
+    for (std::size_t byte = 0; byte < 6; ++byte)
+        indices |= static_cast<std::uint64_t>(pIn[2 + byte]) << (byte * 8);
+
+    for (std::size_t texel = 0; texel < block.size(); ++texel)
+        block[texel][channel] = static_cast<std::uint8_t>(palette[(indices >> (texel * 3)) & 7]);
+}
+
+bool DecodeBC7(const std::uint8_t* pIn, Block& block) {
+
+    // Mode 6 is marked by six zero bits followed by a one.
+    if ((pIn[0] & 0x7f) != 0x40)
+        return false;
+
+    BitReader reader{ pIn };
+    reader.read(7);
+
+    std::array<std::array<std::uint32_t, 4>, 2> endpoints;
+    for (std::size_t channel = 0; channel < 4; ++channel) {
+        endpoints[0][channel] = reader.read(7);
+        endpoints[1][channel] = reader.read(7);
+    }
+
+    const std::array<std::uint32_t, 2> sharedBits{ reader.read(1), reader.read(1) };
+
+    std::array<Texel, 2> expanded;
+    for (std::size_t endpoint = 0; endpoint < 2; ++endpoint) {
+        for (std::size_t channel = 0; channel < 4; ++channel)
+            expanded[endpoint][channel] = static_cast<std::uint8_t>((endpoints[endpoint][channel] << 1) | sharedBits[endpoint]);
+    }
+
+    for (std::size_t texel = 0; texel < block.size(); ++texel) {
+        const std::uint32_t index = reader.read(texel == 0 ? 3 : 4);
+        block[texel] = Mix(expanded[0], expanded[1], 64 - kBC7Weights[index], kBC7Weights[index], 64);
+    }
+
+    return true;
+}
+} // end unnamed namespace
+
+Texture::Channels BlockCompression::ChooseFormat(Texture::Channels channels, bool highQuality) {
+
+    switch (channels) {
+    case Texture::Channels::R: return Texture::Channels::BC4;
+    case Texture::Channels::RG: return Texture::Channels::BC5;
+    case Texture::Channels::RGB: return highQuality ? Texture::Channels::BC7 : Texture::Channels::BC1;
+    case Texture::Channels::RGBA:
+    case Texture::Channels::BGRA: return highQuality ? Texture::Channels::BC7 : Texture::Channels::BC3;
+    default: return channels;
+    }
+}
+
+std::optional<Image> BlockCompression::Encode(const Image& image, Texture::Channels format, ThreadPool& pool) {
+
+    if (image.empty() || Texture::IsCompressed(image.channels()) || !Texture::IsCompressed(format))
+        return std::nullopt;
+
+    if (image.pixels().size() < image.levelOffset(image.levelCount()))
+        return std::nullopt;
+
+    // Only used for its offsets, the compressed chain has the same levels as the source.
+    const Image layout{ image.width(), image.height(), format, {}, image.levelCount() };
+    const std::size_t blockBytes = BlockBytes(format);
+    const std::vector<BlockRow> rows = BlockRows(image);
+
+    std::vector<std::uint8_t> blocks(layout.levelOffset(layout.levelCount()));
+
+    pool.parallelFor(rows.size(), [&](std::size_t row) {
+
+        const auto [level, blockY] = rows[row];
+        const unsigned int width = image.levelWidth(level);
+        const unsigned int height = image.levelHeight(level);
+        const unsigned int blocksX = (width + kBlockSize - 1) / kBlockSize;
+
+        const std::uint8_t* pPixels = image.pixels().data() + image.levelOffset(level);
+        std::uint8_t* pOut = blocks.data() + layout.levelOffset(level) + blockY * blocksX * blockBytes;
+
+        for (unsigned int blockX = 0; blockX < blocksX; ++blockX, pOut += blockBytes) {
+
+            const Block block = LoadBlock(pPixels, width, height, image.channels(), blockX, blockY);
+
+            switch (format) {
+            case Texture::Channels::BC1:
+                EncodeColor(block, pOut);
+                break;
+            case Texture::Channels::BC3:
+                EncodeChannel(block, 3, pOut);
+                EncodeColor(block, pOut + 8);
+                break;
+            case Texture::Channels::BC4:
+                EncodeChannel(block, 0, pOut);
+                break;
+            case Texture::Channels::BC5:
+                EncodeChannel(block, 0, pOut);
+                EncodeChannel(block, 1, pOut + 8);
+                break;
+            case Texture::Channels::BC7:
+                EncodeBC7(block, pOut);
+                break;
+            default: break;
+            }
+        }
+    });
+
+    return Image{ image.width(), image.height(), format, std::move(blocks), image.levelCount() };
+}
+
+std::optional<Image> BlockCompression::Decode(const Image& image, ThreadPool& pool) {
+
+    const Texture::Channels format = image.channels();
+    if (!Texture::IsCompressed(format) || image.pixels().size() < image.levelOffset(image.levelCount()))
+        return std::nullopt;
+
+    const Texture::Channels channels = [format] {
+        switch (format) {
+        case Texture::Channels::BC4: return Texture::Channels::R;
+        case Texture::Channels::BC5: return Texture::Channels::RG;
+        default: return Texture::Channels::RGBA;
+        }
+    }();
+
+    const Image layout{ image.width(), image.height(), channels, {}, image.levelCount() };
+    const unsigned int channelCount = Texture::ChannelCount(channels);
+    const std::size_t blockBytes = BlockBytes(format);
+    const std::vector<BlockRow> rows = BlockRows(image);
+
+    std::vector<std::uint8_t> pixels(layout.levelOffset(layout.levelCount()));
+
+    std::atomic<bool> supported = true;
+
+    pool.parallelFor(rows.size(), [&](std::size_t row) {
+
+        const auto [level, blockY] = rows[row];
+        const unsigned int width = image.levelWidth(level);
+        const unsigned int height = image.levelHeight(level);
+        const unsigned int blocksX = (width + kBlockSize - 1) / kBlockSize;
+
+        const std::uint8_t* pIn = image.pixels().data() + image.levelOffset(level) + blockY * blocksX * blockBytes;
+        std::uint8_t* pPixels = pixels.data() + layout.levelOffset(level);
+
+        for (unsigned int blockX = 0; blockX < blocksX; ++blockX, pIn += blockBytes) {
+
+            Block block{};
+
+            switch (format) {
+            case Texture::Channels::BC1:
+                DecodeColor(pIn, false, block);
+                break;
+            case Texture::Channels::BC3:
+                DecodeColor(pIn + 8, true, block);
+                DecodeChannel(pIn, 3, block);
+                break;
+            case Texture::Channels::BC4:
+                DecodeChannel(pIn, 0, block);
+                break;
+            case Texture::Channels::BC5:
+                DecodeChannel(pIn, 0, block);
+                DecodeChannel(pIn + 8, 1, block);
+                break;
+            case Texture::Channels::BC7:
+                if (!DecodeBC7(pIn, block))
+                    supported = false;
+                break;
+            default: break;
+            }
+
+            StoreBlock(block, channelCount, blockX, blockY, width, height, pPixels);
+        }
+    });
+
+    if (!supported)
+        return std::nullopt;
+
+    return Image{ image.width(), image.height(), channels, std::move(pixels), image.levelCount() };
+}
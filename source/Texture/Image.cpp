@@ -0,0 +1,83 @@
+#include "Texture/Image.hpp"
+
+#include <algorithm>
+#include <bit>
+
+struct Image::Private {
+    unsigned int m_width = 0;
+    unsigned int m_height = 0;
+    Texture::Channels m_channels = Texture::Channels::RGB;
+
+    std::vector<std::uint8_t> m_pixels;
+    unsigned int m_levelCount = 1;
+};
+
+unsigned int Image::MaxLevelCount(unsigned int width, unsigned int height) {
+    return std::bit_width(std::max({ width, height, 1u }));
+}
+
+
+Image::Image()
+    : m_pPrivate(std::make_unique<Private>()) {}
+
+Image::Image(unsigned int width, unsigned int height, Texture::Channels channels, std::vector<std::uint8_t>&& pixels, unsigned int levelCount)
+    : m_pPrivate(std::make_unique<Private>(width, height, channels, std::move(pixels), std::clamp(levelCount, 1u, MaxLevelCount(width, height)))) {}
+
+Image::~Image() noexcept {}
+
+Image::Image(const Image& other) {
+    *this = other;
+}
+
+Image& Image::operator=(const Image& other) {
+
+    if (this != &other)
+        m_pPrivate = std::make_unique<Private>(*other.m_pPrivate);
+
+    return *this;
+}
+
+Image::Image(Image&& other) noexcept {
+    *this = std::move(other);
+}
+
+Image& Image::operator=(Image&& other) noexcept {
+
+    if (this != &other)
+        m_pPrivate = std::exchange(other.m_pPrivate, nullptr);
+
+    return *this;
+}
+
+DEFINE_GETTER_IMMUTABLE_COPY(Image, width, unsigned int, m_pPrivate->m_width)
+DEFINE_GETTER_IMMUTABLE_COPY(Image, height, unsigned int, m_pPrivate->m_height)
+DEFINE_GETTER_IMMUTABLE_COPY(Image, channels, Texture::Channels, m_pPrivate->m_channels)
+DEFINE_GETTER_IMMUTABLE(Image, pixels, std::vector<std::uint8_t>, m_pPrivate->m_pixels)
+DEFINE_GETTER_IMMUTABLE_COPY(Image, levelCount, unsigned int, m_pPrivate->m_levelCount)
+
+unsigned int Image::levelWidth(unsigned int level) const {
+    return std::max(m_pPrivate->m_width >> level, 1u);
+}
+
+unsigned int Image::levelHeight(unsigned int level) const {
+    return std::max(m_pPrivate->m_height >> level, 1u);
+}
+
+std::size_t Image::levelOffset(unsigned int level) const {
+
+    std::size_t offset = 0;
+    for (unsigned int index = 0; index < level; ++index)
+        offset += levelSize(index);
+
+    return offset;
+}
+
+std::size_t Image::levelSize(unsigned int level) const {
+    return Texture::ImageSize(levelWidth(level), levelHeight(level), m_pPrivate->m_channels);
+}
+
+DEFINE_GETTER_IMMUTABLE_COPY(Image, channelCount, unsigned int, Texture::ChannelCount(m_pPrivate->m_channels))
+
+bool Image::empty() const {
+    return m_pPrivate->m_pixels.empty();
+}
@@ -0,0 +1,157 @@
+#include "Texture/MipChain.hpp"
+
+#include "Common/ThreadPool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define MIP_CHAIN_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+// Filtering always works on four floats per pixel, missing channels are zero.
+constexpr unsigned int kLanes = 4;
+
+// sRGB to linear for every 8 bit value, and linear back to sRGB in 4096 steps.
+struct GammaTables {
+    GammaTables() {
+
+        for (std::size_t value = 0; value < toLinear.size(); ++value) {
+            const float encoded = value / 255.f;
+            toLinear[value] = encoded <= 0.04045f ? encoded / 12.92f : std::pow((encoded + 0.055f) / 1.055f, 2.4f);
+        }
+
+        for (std::size_t value = 0; value < toEncoded.size(); ++value) {
+            const float linear = value / static_cast<float>(toEncoded.size() - 1);
+            const float encoded = linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.f / 2.4f) - 0.055f;
+            toEncoded[value] = static_cast<std::uint8_t>(std::lround(std::clamp(encoded, 0.f, 1.f) * 255.f));
+        }
+    }
+
+    std::array<float, 256> toLinear{};
+    std::array<std::uint8_t, 4096> toEncoded{};
+};
+
+const GammaTables& Tables() {
+    static const GammaTables tables;
+    return tables;
+}
+
+void ExpandRow(const std::uint8_t* pRow, unsigned int width, unsigned int channelCount, bool srgb, float* pOut) {
+
+    const GammaTables& tables = Tables();
+
+    for (unsigned int x = 0; x < width; ++x, pRow += channelCount, pOut += kLanes) {
+        for (unsigned int channel = 0; channel < kLanes; ++channel) {
+
+            if (channel >= channelCount)
+                pOut[channel] = 0.f;
+            else if (srgb && channel < 3)
+                pOut[channel] = tables.toLinear[pRow[channel]];
+            else
+                pOut[channel] = pRow[channel] / 255.f;
+        }
+    }
+}
+
+void PackRow(const float* pRow, unsigned int width, unsigned int channelCount, bool srgb, std::uint8_t* pOut) {
+
+    const GammaTables& tables = Tables();
+    constexpr float kEncodedSteps = static_cast<float>(std::tuple_size_v<decltype(GammaTables::toEncoded)> - 1);
+
+    for (unsigned int x = 0; x < width; ++x, pRow += kLanes, pOut += channelCount) {
+        for (unsigned int channel = 0; channel < channelCount; ++channel) {
+
+            const float value = std::clamp(pRow[channel], 0.f, 1.f);
+
+            if (srgb && channel < 3)
+                pOut[channel] = tables.toEncoded[static_cast<std::size_t>(value * kEncodedSteps + 0.5f)];
+            else
+                pOut[channel] = static_cast<std::uint8_t>(value * 255.f + 0.5f);
+        }
+    }
+}
+
+// Averages 2x2 pixels of the two source rows into each destination pixel. Odd sizes repeat the last column.
+void FilterRow(const float* pRow0, const float* pRow1, unsigned int sourceWidth, unsigned int width, float* pOut) {
+
+    for (unsigned int x = 0; x < width; ++x, pOut += kLanes) {
+
+        const unsigned int x0 = std::min(2 * x, sourceWidth - 1) * kLanes;
+        const unsigned int x1 = std::min(2 * x + 1, sourceWidth - 1) * kLanes;
+
+#ifdef MIP_CHAIN_SSE2
+        const __m128 top = _mm_add_ps(_mm_loadu_ps(pRow0 + x0), _mm_loadu_ps(pRow0 + x1));
+        const __m128 bottom = _mm_add_ps(_mm_loadu_ps(pRow1 + x0), _mm_loadu_ps(pRow1 + x1));
+        _mm_storeu_ps(pOut, _mm_mul_ps(_mm_add_ps(top, bottom), _mm_set1_ps(0.25f)));
+#else
+        for (unsigned int lane = 0; lane < kLanes; ++lane)
+            pOut[lane] = (pRow0[x0 + lane] + pRow0[x1 + lane] + pRow1[x0 + lane] + pRow1[x1 + lane]) * 0.25f;
+#endif
+    }
+}
+} // end unnamed namespace
+
+std::optional<Image> MipChain::Generate(const Image& image, ThreadPool& pool) {
+
+    const unsigned int channelCount = image.channelCount();
+    if (image.empty() || channelCount == 0)
+        return std::nullopt;
+
+    if (image.levelCount() > 1)
+        return image;
+
+    const unsigned int levelCount = Image::MaxLevelCount(image.width(), image.height());
+    const bool srgb = channelCount >= 3;
+
+    // Lay out the chain up front, an image with the final level count knows every offset.
+    std::size_t chainSize = 0;
+    for (unsigned int level = 0; level < levelCount; ++level)
+        chainSize += Texture::ImageSize(std::max(image.width() >> level, 1u), std::max(image.height() >> level, 1u), image.channels());
+
+    std::vector<std::uint8_t> pixels(chainSize);
+    std::memcpy(pixels.data(), image.pixels().data(), std::min(image.pixels().size(), pixels.size()));
+
+    const Image layout{ image.width(), image.height(), image.channels(), {}, levelCount };
+
+    for (unsigned int level = 1; level < levelCount; ++level) {
+
+        const unsigned int sourceWidth = layout.levelWidth(level - 1);
+        const unsigned int sourceHeight = layout.levelHeight(level - 1);
+        const unsigned int width = layout.levelWidth(level);
+        const unsigned int height = layout.levelHeight(level);
+
+        const std::uint8_t* pSource = pixels.data() + layout.levelOffset(level - 1);
+        std::uint8_t* pDestination = pixels.data() + layout.levelOffset(level);
+
+        const std::size_t chunkCount = std::clamp<std::size_t>(height / 16, 1, std::max<std::size_t>(pool.workerCount() * 4, 1));
+        const std::size_t chunkSize = height / chunkCount + 1;
+
+        pool.parallelFor(chunkCount, [&](std::size_t chunk) {
+
+            std::vector<float> rows(static_cast<std::size_t>(sourceWidth) * kLanes * 2 + static_cast<std::size_t>(width) * kLanes);
+            float* pRow0 = rows.data();
+            float* pRow1 = pRow0 + static_cast<std::size_t>(sourceWidth) * kLanes;
+            float* pFiltered = pRow1 + static_cast<std::size_t>(sourceWidth) * kLanes;
+
+            const std::size_t end = std::min<std::size_t>(height, (chunk + 1) * chunkSize);
+            for (std::size_t y = chunk * chunkSize; y < end; ++y) {
+
+                const std::size_t y0 = std::min<std::size_t>(2 * y, sourceHeight - 1);
+                const std::size_t y1 = std::min<std::size_t>(2 * y + 1, sourceHeight - 1);
+
+                ExpandRow(pSource + y0 * sourceWidth * channelCount, sourceWidth, channelCount, srgb, pRow0);
+                ExpandRow(pSource + y1 * sourceWidth * channelCount, sourceWidth, channelCount, srgb, pRow1);
+                FilterRow(pRow0, pRow1, sourceWidth, width, pFiltered);
+                PackRow(pFiltered, width, channelCount, srgb, pDestination + y * width * channelCount);
+            }
+        });
+    }
+
+    return Image{ image.width(), image.height(), image.channels(), std::move(pixels), levelCount };
+}
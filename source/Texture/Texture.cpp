@@ -1,8 +1,23 @@
 #include "Texture/Texture.hpp"
 
+#include <algorithm>
+#include <cstdint>
+
 #include <glad/glad.h>
 #include <stb_image.h>
 
+namespace {
+// State of the OpenGL name, which every copy of the texture refers to.
+struct Shared {
+    GLuint id = 0;
+    unsigned int baseLevel = 0;
+    std::uint64_t lastUsed = 0;
+};
+
+// Textures are only drawn on the OpenGL thread.
+std::uint64_t useClock = 0;
+} // end unnamed namespace
+
 struct Texture::Private {
     Private() = default;
     Private(unsigned int width, unsigned int height, Channels textureFormat, Channels pixelFormat, Target target);
@@ -20,19 +35,59 @@ struct Texture::Private {
     Wrap m_wrapT = Wrap::Repeat;
 
     bool m_mipmap = false;
-    bool m_initialized = false;
+    unsigned int m_levelCount = 1;
 
     Target m_target = Target::Texture2D;
 
     std::array<float, 4> m_borderColor{ 0.f, 0.f, 0.f, 0.f };
 
-    GLuint m_id = 0; // Texture buffer id
+    // Shared by every copy of the texture, the name is deleted when the last of them is destroyed.
+    std::shared_ptr<Shared> m_pShared;
 };
 
 Texture::Private::Private(unsigned int width, unsigned int height, Channels textureFormat, Channels pixelFormat, Target target)
     : m_width(width), m_height(height), m_textureFormat(textureFormat), m_pixelFormat(pixelFormat), m_target(target) {}
 
 
+bool Texture::IsCompressed(Channels format) {
+
+    switch (format) {
+    case Channels::BC1:
+    case Channels::BC3:
+    case Channels::BC4:
+    case Channels::BC5:
+    case Channels::BC7: return true;
+    default: return false;
+    }
+}
+
+unsigned int Texture::ChannelCount(Channels format) {
+
+    switch (format) {
+    case Channels::R: return 1;
+    case Channels::RG: return 2;
+    case Channels::RGB: return 3;
+    case Channels::RGBA:
+    case Channels::BGRA: return 4;
+    default: return 0;
+    }
+}
+
+std::size_t Texture::ImageSize(unsigned int width, unsigned int height, Channels format) {
+
+    // Block compressed formats store 4x4 texel blocks of 8 or 16 bytes, partial blocks are padded.
+    const std::size_t blockCount = static_cast<std::size_t>((width + 3) / 4) * ((height + 3) / 4);
+
+    switch (format) {
+    case Channels::BC1:
+    case Channels::BC4: return blockCount * 8;
+    case Channels::BC3:
+    case Channels::BC5:
+    case Channels::BC7: return blockCount * 16;
+    default: return static_cast<std::size_t>(width) * height * ChannelCount(format);
+    }
+}
+
 Texture::Texture()
     : m_pPrivate(std::make_unique<Private>()) {}
 
@@ -74,7 +129,7 @@ DEFINE_GETTER_IMMUTABLE(Texture, height, unsigned int, m_pPrivate->m_height)
 DEFINE_GETTER_IMMUTABLE(Texture, textureFormat, Texture::Channels, m_pPrivate->m_textureFormat)
 DEFINE_GETTER_IMMUTABLE(Texture, pixelFormat, Texture::Channels, m_pPrivate->m_pixelFormat)
 
-DEFINE_GETTER_IMMUTABLE_COPY(Texture, id, GLuint, m_pPrivate->m_id)
+DEFINE_GETTER_IMMUTABLE_COPY(Texture, id, GLuint, m_pPrivate->m_pShared ? m_pPrivate->m_pShared->id : 0)
 DEFINE_GETTER_IMMUTABLE_COPY(Texture, target, Texture::Target, m_pPrivate->m_target)
 
 DEFINE_GETTER_IMMUTABLE_COPY(Texture, minFilter, Texture::Filter, m_pPrivate->m_minFilter)
@@ -95,7 +150,48 @@ DEFINE_GETTER_IMMUTABLE_COPY(Texture, wrapT, Texture::Wrap, m_pPrivate->m_wrapT)
 DEFINE_SETTER_COPY(Texture, wrapT, m_pPrivate->m_wrapT)
 
 DEFINE_GETTER_IMMUTABLE_COPY(Texture, mipmap, bool, m_pPrivate->m_mipmap)
-DEFINE_SETTER_COPY(Texture, wrapT, m_pPrivate->m_mipmap)
+DEFINE_SETTER_COPY(Texture, mipmap, m_pPrivate->m_mipmap)
+
+DEFINE_GETTER_IMMUTABLE_COPY(Texture, levelCount, unsigned int, m_pPrivate->m_levelCount)
+DEFINE_SETTER_COPY(Texture, levelCount, m_pPrivate->m_levelCount)
+
+DEFINE_GETTER_IMMUTABLE_COPY(Texture, baseLevel, unsigned int, m_pPrivate->m_pShared ? m_pPrivate->m_pShared->baseLevel : 0)
+
+void Texture::baseLevel(unsigned int value) {
+
+    if (m_pPrivate->m_pShared)
+        m_pPrivate->m_pShared->baseLevel = value;
+}
+
+std::size_t Texture::residentSize() const {
+
+    if (!initialized())
+        return 0;
+
+    const unsigned int levelCount = std::max(m_pPrivate->m_levelCount, 1u);
+
+    std::size_t size = 0;
+    for (unsigned int level = std::min(baseLevel(), levelCount - 1); level < levelCount; ++level)
+        size += ImageSize(std::max(m_pPrivate->m_width >> level, 1u), std::max(m_pPrivate->m_height >> level, 1u), m_pPrivate->m_textureFormat);
+
+    // A chain built by the driver adds about a third on top of the image.
+    if (m_pPrivate->m_mipmap && levelCount == 1)
+        size += size / 3;
+
+    return size;
+}
+
+std::uint64_t Texture::UseClock() {
+    return useClock;
+}
+
+void Texture::markUsed() const {
+
+    if (m_pPrivate->m_pShared)
+        m_pPrivate->m_pShared->lastUsed = ++useClock;
+}
+
+DEFINE_GETTER_IMMUTABLE_COPY(Texture, lastUsed, std::uint64_t, m_pPrivate->m_pShared ? m_pPrivate->m_pShared->lastUsed : 0)
 
 void Texture::borderColor(const glm::vec4& color) {
     m_pPrivate->m_borderColor = { color.r, color.g, color.b, color.a };
@@ -106,14 +202,23 @@ std::array<float, 4> Texture::borderColor() const {
 }
 
 void Texture::initialize() {
-    glGenTextures(1, &m_pPrivate->m_id);
-    m_pPrivate->m_initialized = true;
+
+    destroy();
+
+    m_pPrivate->m_pShared = std::make_shared<Shared>();
+    glGenTextures(1, &m_pPrivate->m_pShared->id);
 }
 
-DEFINE_GETTER_IMMUTABLE_COPY(Texture, initialized, bool, m_pPrivate->m_initialized)
+DEFINE_GETTER_IMMUTABLE_COPY(Texture, initialized, bool, m_pPrivate->m_pShared != nullptr)
+DEFINE_GETTER_IMMUTABLE_COPY(Texture, useCount, long, m_pPrivate->m_pShared ? m_pPrivate->m_pShared.use_count() : 0)
 
 void Texture::destroy() const {
 
-    if (m_pPrivate && m_pPrivate->m_initialized)
-        glDeleteTextures(1, &m_pPrivate->m_id);
+    if (!m_pPrivate || !m_pPrivate->m_pShared)
+        return;
+
+    if (m_pPrivate->m_pShared.use_count() == 1)
+        glDeleteTextures(1, &m_pPrivate->m_pShared->id);
+
+    m_pPrivate->m_pShared.reset();
 }
@@ -0,0 +1,59 @@
+#include "Texture/TextureHandle.hpp"
+
+#include <atomic>
+
+namespace {
+struct State {
+    std::atomic<TextureHandle::Status> status = TextureHandle::Status::Pending;
+    Texture texture;
+};
+} // end unnamed namespace
+
+struct TextureHandle::Private {
+    std::shared_ptr<State> m_pState = std::make_shared<State>();
+};
+
+
+TextureHandle::TextureHandle()
+    : m_pPrivate(std::make_unique<Private>()) {}
+
+TextureHandle::~TextureHandle() noexcept {}
+
+TextureHandle::TextureHandle(const TextureHandle& other) {
+    *this = other;
+}
+
+TextureHandle& TextureHandle::operator=(const TextureHandle& other) {
+
+    if (this != &other)
+        m_pPrivate = std::make_unique<Private>(*other.m_pPrivate);
+
+    return *this;
+}
+
+TextureHandle::TextureHandle(TextureHandle&& other) noexcept {
+    *this = std::move(other);
+}
+
+TextureHandle& TextureHandle::operator=(TextureHandle&& other) noexcept {
+
+    if (this != &other)
+        m_pPrivate = std::exchange(other.m_pPrivate, nullptr);
+
+    return *this;
+}
+
+DEFINE_GETTER_IMMUTABLE_COPY(TextureHandle, status, TextureHandle::Status, m_pPrivate->m_pState->status.load(std::memory_order_acquire))
+DEFINE_GETTER_IMMUTABLE_COPY(TextureHandle, ready, bool, status() == Status::Ready)
+DEFINE_GETTER_IMMUTABLE(TextureHandle, texture, Texture, m_pPrivate->m_pState->texture)
+DEFINE_GETTER_IMMUTABLE_COPY(TextureHandle, useCount, long, m_pPrivate->m_pState.use_count())
+
+void TextureHandle::fulfill(const Texture& texture) {
+
+    m_pPrivate->m_pState->texture = texture;
+    m_pPrivate->m_pState->status.store(Status::Ready, std::memory_order_release);
+}
+
+void TextureHandle::fail() {
+    m_pPrivate->m_pState->status.store(Status::Failed, std::memory_order_release);
+}